@@ -0,0 +1,52 @@
+/**
+ * @file bench.h
+ * @brief Host micro benchmarks for code on the main loop's hot path.
+ *
+ *        Host timings are scaled by BENCH_M0_SLOWDOWN to estimate the cost on
+ *        the 48 MHz Cortex-M0 (no divide instruction, 32 bit only) and
+ *        checked against a share of TIMING_LOOP_BUDGET_us.
+ */
+
+#ifndef _BENCH_H
+#define _BENCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// conservative host -> LPC11C24 slowdown, a desktop core retires well over
+// 100 instructions in one M0 cycle at 48 MHz
+#define BENCH_M0_SLOWDOWN 200
+
+/**
+ * @return monotonic host time in nanoseconds
+ */
+uint64_t Bench_Now_ns(void);
+
+/**
+ * @details print one result line and check it against its budget
+ *
+ * @param name benchmark name
+ * @param host_ns host time per call
+ * @param budget_us allowed estimated target time per call
+ * @return true if the estimated target time is within budget
+ */
+bool Bench_Report(const char *name, double host_ns, double budget_us);
+
+/**
+ * @details print one result line for a variant that is not gated, no verdict
+ *
+ * @param name benchmark name
+ * @param host_ns host time per call
+ * @param budget_us budget of the gated variant, for comparison
+ */
+void Bench_Info(const char *name, double host_ns, double budget_us);
+
+bool Bench_Soc(void);
+
+bool Bench_Pec15(void);
+
+bool Bench_Thermistor(void);
+
+bool Bench_CellFilter(void);
+
+#endif
@@ -0,0 +1,50 @@
+/**
+ * @file bench_cell_filter.c
+ * @brief Cost of filtering one readback of a full pack, 180 cells, which
+ *        happens on every cell voltage sweep and so every pass at the fast
+ *        sampling rate.
+ */
+
+#include <stdio.h>
+
+#include "bench.h"
+#include "config.h"
+#include "cell_filter.h"
+
+#define BENCH_CELL_FILTER_CELLS (MAX_NUM_MODULES*MAX_CELLS_PER_MODULE)
+#define BENCH_CELL_FILTER_UPDATES 200000UL
+
+// one update may use this share of the loop budget
+#define BENCH_CELL_FILTER_BUDGET_us (TIMING_LOOP_BUDGET_us / 4)
+
+static uint32_t bench_raw_mV[BENCH_CELL_FILTER_CELLS];
+static uint32_t bench_filtered_mV[BENCH_CELL_FILTER_CELLS];
+
+static double _update_ns(CELL_FILTER_MODE_T mode) {
+    uint32_t seed = 1;
+    uint16_t i;
+    CellFilter_Init(mode);
+    uint64_t start_ns = Bench_Now_ns();
+    uint32_t n;
+    for (n = 0; n < BENCH_CELL_FILTER_UPDATES; n++) {
+        // a few mV of noise, with the odd outlier
+        seed = seed * 1103515245 + 12345;
+        i = (seed >> 16) % BENCH_CELL_FILTER_CELLS;
+        bench_raw_mV[i] = 3600 + ((seed >> 8) & 0x7) + (((seed & 0xFF) == 0) ? 500 : 0);
+        CellFilter_Update(bench_raw_mV, bench_filtered_mV, BENCH_CELL_FILTER_CELLS);
+    }
+    return (double)(Bench_Now_ns() - start_ns) / BENCH_CELL_FILTER_UPDATES;
+}
+
+bool Bench_CellFilter(void) {
+    uint16_t i;
+    for (i = 0; i < BENCH_CELL_FILTER_CELLS; i++) {
+        bench_raw_mV[i] = 3600 + (i & 0x7);
+    }
+
+    bool pass = Bench_Report("Cell filter IIR", _update_ns(CELL_FILTER_IIR),
+            BENCH_CELL_FILTER_BUDGET_us);
+    pass &= Bench_Report("Cell filter median", _update_ns(CELL_FILTER_MEDIAN3),
+            BENCH_CELL_FILTER_BUDGET_us);
+    return pass;
+}
@@ -0,0 +1,45 @@
+/**
+ * @file bench_main.c
+ * @brief Runs every host benchmark. Exits non-zero if any estimate is over
+ *        its budget, so `make bench` can gate a build.
+ */
+
+#include <stdio.h>
+#include <time.h>
+
+#include "bench.h"
+
+uint64_t Bench_Now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void _print(const char *tag, const char *name, double host_ns, double budget_us) {
+    double target_us = host_ns * BENCH_M0_SLOWDOWN / 1000.0;
+    printf("  [%s] %-28s host %8.1f ns  est. M0 %8.2f us  budget %8.2f us\n",
+            tag, name, host_ns, target_us, budget_us);
+}
+
+bool Bench_Report(const char *name, double host_ns, double budget_us) {
+    double target_us = host_ns * BENCH_M0_SLOWDOWN / 1000.0;
+    bool pass = target_us <= budget_us;
+    _print(pass ? "PASS" : "FAIL", name, host_ns, budget_us);
+    return pass;
+}
+
+void Bench_Info(const char *name, double host_ns, double budget_us) {
+    _print("info", name, host_ns, budget_us);
+}
+
+int main(void) {
+    bool pass = true;
+
+    printf("Host benchmarks (M0 estimate = host x %d)\n", BENCH_M0_SLOWDOWN);
+    pass &= Bench_Soc();
+    pass &= Bench_Pec15();
+    pass &= Bench_Thermistor();
+    pass &= Bench_CellFilter();
+
+    return pass ? 0 : 1;
+}
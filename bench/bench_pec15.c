@@ -0,0 +1,67 @@
+/**
+ * @file bench_pec15.c
+ * @brief Cost of checking the PECs of one full readback of the chain: cell
+ *        voltage groups A-D and auxiliary groups A-B of every module.
+ */
+
+#include <stdio.h>
+
+#include "bench.h"
+#include "config.h"
+#include "pec15.h"
+
+#define BENCH_PEC15_GROUPS (MAX_NUM_MODULES * 6)
+#define BENCH_PEC15_GROUP_LEN 6
+#define BENCH_PEC15_READBACKS 20000UL
+
+// checking a readback may use this share of the loop budget
+#define BENCH_PEC15_BUDGET_us (TIMING_LOOP_BUDGET_us / 2)
+
+typedef uint16_t (*BENCH_PEC15_UPDATE_T)(uint16_t rem, const uint8_t *data, uint16_t len);
+
+static uint8_t bench_groups[BENCH_PEC15_GROUPS][BENCH_PEC15_GROUP_LEN];
+
+static double _readback_ns(BENCH_PEC15_UPDATE_T update) {
+    volatile uint16_t sink = 0;
+    uint64_t start_ns = Bench_Now_ns();
+    uint32_t n;
+    for (n = 0; n < BENCH_PEC15_READBACKS; n++) {
+        uint16_t g;
+        for (g = 0; g < BENCH_PEC15_GROUPS; g++) {
+            sink ^= update(PEC15_SEED, bench_groups[g], BENCH_PEC15_GROUP_LEN);
+        }
+    }
+    return (double)(Bench_Now_ns() - start_ns) / BENCH_PEC15_READBACKS;
+}
+
+bool Bench_Pec15(void) {
+    uint32_t seed = 1;
+    uint16_t g;
+    uint8_t i;
+    for (g = 0; g < BENCH_PEC15_GROUPS; g++) {
+        for (i = 0; i < BENCH_PEC15_GROUP_LEN; i++) {
+            seed = seed * 1103515245 + 12345;
+            bench_groups[g][i] = seed >> 16;
+        }
+    }
+
+    // every variant is reported, only the one PEC15_TABLE_ENTRIES selects
+    // has to fit the budget, the others are info
+    double bitwise_ns = _readback_ns(Pec15_UpdateBitwise);
+    double table16_ns = _readback_ns(Pec15_UpdateTable16);
+    double table256_ns = _readback_ns(Pec15_UpdateTable256);
+#if PEC15_TABLE_ENTRIES == 256
+    Bench_Info("Pec15 bitwise", bitwise_ns, BENCH_PEC15_BUDGET_us);
+    Bench_Info("Pec15 16 entry table", table16_ns, BENCH_PEC15_BUDGET_us);
+    bool pass = Bench_Report("Pec15 256 entry table", table256_ns, BENCH_PEC15_BUDGET_us);
+#elif PEC15_TABLE_ENTRIES == 16
+    Bench_Info("Pec15 bitwise", bitwise_ns, BENCH_PEC15_BUDGET_us);
+    bool pass = Bench_Report("Pec15 16 entry table", table16_ns, BENCH_PEC15_BUDGET_us);
+    Bench_Info("Pec15 256 entry table", table256_ns, BENCH_PEC15_BUDGET_us);
+#else
+    bool pass = Bench_Report("Pec15 bitwise", bitwise_ns, BENCH_PEC15_BUDGET_us);
+    Bench_Info("Pec15 16 entry table", table16_ns, BENCH_PEC15_BUDGET_us);
+    Bench_Info("Pec15 256 entry table", table256_ns, BENCH_PEC15_BUDGET_us);
+#endif
+    return pass;
+}
@@ -0,0 +1,74 @@
+/**
+ * @file bench_soc.c
+ * @brief Cost of SOC_Step, which runs on every pass of the main loop, and of
+ *        SOC_Estimate_cpct, which divides and only runs on request.
+ */
+
+#include <stdio.h>
+
+#include "bench.h"
+#include "config.h"
+#include "soc.h"
+
+#define BENCH_SOC_STEPS 10000000UL
+#define BENCH_SOC_ESTIMATES 1000000UL
+
+// SOC_Step may use this share of the loop budget
+#define BENCH_SOC_STEP_BUDGET_us (TIMING_LOOP_BUDGET_us / 20)
+// SOC_Estimate_cpct runs at CAN heartbeat rate, not every pass
+#define BENCH_SOC_ESTIMATE_BUDGET_us (TIMING_LOOP_BUDGET_us / 4)
+
+// checkpoints land in RAM, the EEPROM queue is not part of the step cost
+static uint32_t bench_cc_page[SOC_CHECKPOINT_SLOTS];
+
+uint32_t EEPROM_LoadCCPage_Num(uint8_t idx) {
+    return bench_cc_page[idx];
+}
+
+bool EEPROM_WriteCCPage_Num(uint8_t idx, uint32_t val) {
+    bench_cc_page[idx] = val;
+    return true;
+}
+
+bool Bench_Soc(void) {
+    static uint32_t cell_voltages_mV[MAX_NUM_MODULES*MAX_CELLS_PER_MODULE];
+    static uint8_t module_cell_count[MAX_NUM_MODULES];
+    PACK_CONFIG_T pack_config;
+    BMS_PACK_STATUS_T pack_status;
+    uint8_t i;
+
+    for (i = 0; i < SOC_CHECKPOINT_SLOTS; i++) {
+        bench_cc_page[i] = 0xFFFFFFFF;
+    }
+    pack_config.cell_capacity_cAh = 250;
+    pack_config.pack_cells_p = 12;
+    pack_config.module_cell_count = module_cell_count;
+    pack_status.cell_voltages_mV = cell_voltages_mV;
+    pack_status.avg_cell_voltage_mV = 4000;
+    pack_status.pack_current_mA = 80000;
+
+    SOC_Init();
+    SOC_Config(&pack_config, 0);
+
+    // 1 ms ticks alternating between the integrating modes
+    uint64_t start_ns = Bench_Now_ns();
+    uint32_t t;
+    for (t = 1; t <= BENCH_SOC_STEPS; t++) {
+        BMS_SSM_MODE_T mode = (t & 0x4000) ? BMS_SSM_MODE_CHARGE : BMS_SSM_MODE_DISCHARGE;
+        pack_status.pack_current_ms = t;
+        SOC_Step(&pack_status, mode, t);
+    }
+    double step_ns = (double)(Bench_Now_ns() - start_ns) / BENCH_SOC_STEPS;
+
+    volatile uint32_t sink = 0;
+    start_ns = Bench_Now_ns();
+    for (t = 0; t < BENCH_SOC_ESTIMATES; t++) {
+        sink += SOC_Estimate_cpct();
+    }
+    double estimate_ns = (double)(Bench_Now_ns() - start_ns) / BENCH_SOC_ESTIMATES;
+
+    bool pass = true;
+    pass &= Bench_Report("SOC_Step", step_ns, BENCH_SOC_STEP_BUDGET_us);
+    pass &= Bench_Report("SOC_Estimate_cpct", estimate_ns, BENCH_SOC_ESTIMATE_BUDGET_us);
+    return pass;
+}
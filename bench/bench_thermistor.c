@@ -0,0 +1,57 @@
+/**
+ * @file bench_thermistor.c
+ * @brief Cost of converting one thermistor reading per module, as the
+ *        thermistor task does every step, against the linear fit the lookup
+ *        table replaced. The table is not free: on the host it takes about
+ *        three times as long as the fit's shift (~50 ns against ~17 ns a
+ *        step), which is still far inside its budget share.
+ */
+
+#include <stdio.h>
+
+#include "bench.h"
+#include "config.h"
+#include "thermistor.h"
+
+#define BENCH_THERMISTOR_STEPS 1000000UL
+
+// converting one step's readings may use this share of the loop budget, the
+// same as SOC_Step although the thermistor task runs at most every 5 ms
+#define BENCH_THERMISTOR_BUDGET_us (TIMING_LOOP_BUDGET_us / 20)
+
+typedef int16_t (*BENCH_THERMISTOR_CONVERT_T)(uint32_t voltage_mV);
+
+static uint32_t bench_voltages_mV[MAX_NUM_MODULES];
+
+static int16_t _linear_dC(uint32_t voltage_mV) {
+    return (voltage_mV >> 2) - 39;
+}
+
+static double _step_ns(BENCH_THERMISTOR_CONVERT_T convert) {
+    volatile int32_t sink;
+    int32_t sum = 0;
+    uint64_t start_ns = Bench_Now_ns();
+    uint32_t n;
+    for (n = 0; n < BENCH_THERMISTOR_STEPS; n++) {
+        uint8_t i;
+        for (i = 0; i < MAX_NUM_MODULES; i++) {
+            sum += convert(bench_voltages_mV[i] + (n & 0x3FF));
+        }
+    }
+    sink = sum;
+    (void)sink;
+    return (double)(Bench_Now_ns() - start_ns) / BENCH_THERMISTOR_STEPS;
+}
+
+bool Bench_Thermistor(void) {
+    uint8_t i;
+    for (i = 0; i < MAX_NUM_MODULES; i++) {
+        bench_voltages_mV[i] = 800 + 150*i;
+    }
+
+    // the old fit is only reported, for comparison
+    Bench_Info("Thermistor linear fit", _step_ns(_linear_dC),
+            BENCH_THERMISTOR_BUDGET_us);
+    return Bench_Report("Thermistor lookup table", _step_ns(Thermistor_Temperature_dC),
+            BENCH_THERMISTOR_BUDGET_us);
+}
@@ -4,4 +4,18 @@
 
 uint16_t Get_Total_Cell_Count(PACK_CONFIG_T *pack_config);
 
+/**
+ * @details look up one cell in the balance requests, which hold one word per
+ *          module with bit i for the module's cell i
+ *
+ * @param balance_req balance requests, one word per module
+ * @param pack_config pack configuration giving the cells per module
+ * @param cell pack wide cell index
+ * @return true if the cell is to be balanced
+ */
+bool Is_Cell_Balancing(const uint16_t *balance_req, PACK_CONFIG_T *pack_config, uint16_t cell);
+
+// clamp a counter or duration to a 16 bit CAN field
+uint16_t Saturate_u16(uint32_t val);
+
 #endif
@@ -40,8 +40,6 @@
 
 #define Hertz2Ticks(freq) SystemCoreClock / freq
 
-#define TIME_PER_THERMISTOR_MS 40
-
 // ltc6804 constants
 #define LTC6804_SHIFT_REGISTER_DATA_IN 4
 #define LTC6804_SHIFT_REGISTER_CLOCK 3
@@ -78,8 +76,22 @@ void Board_Headroom_Toggle(void);
 
 void Board_BlockingDelay(uint32_t dlyTicks);
 
+/**
+ * @details microsecond timestamp built from msTicks and the SysTick counter.
+ *          Wraps every ~71 minutes, so only use it for differences
+ *
+ * @return time since boot in microseconds
+ */
+uint32_t Board_Micros(void);
+
 bool Board_Switch_Read(uint8_t gpio_port, uint8_t pin);
 
+/**
+ * @details set up the pack current sensor ADC channel and the timer that
+ *          samples it at CURRENT_SENSE_SAMPLE_HZ (see current_sense.h)
+ */
+void Board_CurrentSense_Init(void);
+
 void Board_CAN_Init(uint32_t baudRateHz, volatile uint32_t *msTicksPtr);
 
 /**
@@ -121,28 +133,36 @@ uint32_t Board_Println_BLOCKING(const char *str);
 
 /**
  * @details Initialize board input switch
+ *
+ * @param cell_voltages_raw_mV the readback buffer, pack_status->cell_voltages_raw_mV
  */
-bool Board_LTC6804_Init(PACK_CONFIG_T * pack_config, uint32_t * cell_voltages_mV);
+bool Board_LTC6804_Init(PACK_CONFIG_T * pack_config, uint32_t * cell_voltages_raw_mV);
 
 void Board_LTC6804_DeInit(void);
 
-void Board_LTC6804_ProcessInputs(BMS_PACK_STATUS_T *pack_status, BMS_STATE_T* bms_state);
-
-void Board_LTC6804_ProcessOutput(bool *balance_req);
+void Board_LTC6804_ProcessOutput(uint16_t *balance_req);
 
 /**
- * @details get cell voltages
+ * @details get cell voltages. Call until it returns true to finish a conversion.
+ *          With CELL_VOLTAGES_PIPELINED the next conversion is already
+ *          running when it returns (see gcv_pipeline.h). The chain is read
+ *          into cell_voltages_raw_mV and cell_voltages_mV only changes, all
+ *          at once, when a readback passes and is filtered into it (see
+ *          cell_filter.h)
  *
  * @param mutable array of cell voltages
+ * @return true once the cell voltages (and pack statistics) are updated
  */
-void Board_LTC6804_GetCellVoltages(BMS_PACK_STATUS_T* pack_status);
+bool Board_LTC6804_GetCellVoltages(BMS_PACK_STATUS_T* pack_status);
 
 /**
- * @details iterates through thermistors and saves cell temperatures in pack_status
+ * @details selects the next thermistor and saves its temperatures in pack_status.
+ *          Call until it returns true to finish reading a thermistor
  *
  * @param pack_status mutable datatype containing array of cell temperatures
+ * @return true once the selected thermistor has been read
  */
-void Board_LTC6804_GetCellTemperatures(BMS_PACK_STATUS_T * pack_status, uint8_t num_modules);
+bool Board_LTC6804_GetCellTemperatures(BMS_PACK_STATUS_T * pack_status, uint8_t num_modules);
 
 /**
  * @details prints thermistor temperatures of module module
@@ -162,10 +182,10 @@ bool Board_LTC6804_CVST(void);
 /**
  * @details balance selected cell
  * 
- * @param balance_requests balance_requests[i] is true if ith cell should be 
- *                         balanced, false otherwise
+ * @param balance_req one word per module, bit i set if the module's cell i
+ *                    should be balanced
  */
-void Board_LTC6804_UpdateBalanceStates(bool *balance_req);
+void Board_LTC6804_UpdateBalanceStates(uint16_t *balance_req);
 
 /**
  * @details checks that pack configuration is consistent with number of connected LTC6804 slaves
@@ -175,8 +195,22 @@ void Board_LTC6804_UpdateBalanceStates(bool *balance_req);
  */
 bool Board_LTC6804_ValidateConfiguration(void);
 
+/**
+ * @details runs an open wire test. Call until it returns true to finish a test
+ *
+ * @return true if the open wire test passed
+ */
 bool Board_LTC6804_OpenWireTest(void);
 
+/**
+ * @details runs an open wire test in the next slot between cell voltage
+ *          conversions (see gcv_pipeline.h), so readback keeps going.
+ *          Call until it returns true; a failed test is queued again
+ *
+ * @return true once a test in a slot passed
+ */
+bool Board_LTC6804_OpenWireSlot(void);
+
 /******** Contactor Board Functions ***********/
 
 /**
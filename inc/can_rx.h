@@ -0,0 +1,77 @@
+#ifndef _CAN_RX_H
+#define _CAN_RX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// upper bound on frames handled per main loop pass, so a babbling node
+// cannot starve the rest of the loop. Anything left is handled next pass
+#define CAN_RX_MAX_PER_LOOP 32
+
+typedef void (*CAN_RX_HANDLER_T)(void *msg);
+
+// one dispatch table entry
+typedef struct {
+    uint32_t key;
+    CAN_RX_HANDLER_T handler;
+} CAN_RX_ENTRY_T;
+
+typedef enum {
+    CAN_RX_EMPTY,   // no frame waiting
+    CAN_RX_FRAME,   // msg and key hold the next frame
+    CAN_RX_ERROR    // driver reported a lost or bad frame
+} CAN_RX_POP_STATUS_T;
+
+/**
+ * @details pops the next frame off the driver's interrupt-fed ring buffer
+ *
+ * @param key key to dispatch on (message id or driver message type)
+ * @param msg driver specific message buffer
+ */
+typedef CAN_RX_POP_STATUS_T (*CAN_RX_POP_T)(uint32_t *key, void *msg);
+
+typedef struct {
+    uint32_t frames;            // frames received
+    uint32_t unhandled;         // frames with no table entry
+    uint32_t dropped;           // frames the driver reported lost
+    uint32_t capped;            // passes that stopped at CAN_RX_MAX_PER_LOOP
+    uint16_t max_per_pass;      // most frames handled in one pass, at most CAN_RX_MAX_PER_LOOP
+    uint32_t max_handler_us;    // longest single handler call
+    uint32_t max_drain_us;      // longest pass
+} CAN_RX_STATS_T;
+
+void CanRx_Init(void);
+
+/**
+ * @details handle every waiting frame (up to CAN_RX_MAX_PER_LOOP) through
+ *          the dispatch table
+ *
+ * @param table dispatch table
+ * @param table_len number of entries
+ * @param pop driver pop function
+ * @param msg driver message buffer passed to pop and the handlers
+ * @return number of frames received
+ */
+uint16_t CanRx_Drain(const CAN_RX_ENTRY_T *table, uint8_t table_len,
+        CAN_RX_POP_T pop, void *msg);
+
+/**
+ * @details find the handler for key in a dispatch table
+ *
+ * @return handler for key, NULL if there is none
+ */
+CAN_RX_HANDLER_T CanRx_Lookup(const CAN_RX_ENTRY_T *table, uint8_t table_len, uint32_t key);
+
+const CAN_RX_STATS_T * CanRx_GetStats(void);
+
+/**
+ * @details fill a CAN frame with the receive statistics:
+ *          dropped (u16), unhandled (u16), max per pass (u8), capped (u8, saturating),
+ *          max handler time in us (u16, saturating), little endian
+ *
+ * @param data 8 byte frame payload
+ * @return frame length
+ */
+uint8_t CanRx_PackCanFrame(uint8_t *data);
+
+#endif
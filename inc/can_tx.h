@@ -0,0 +1,106 @@
+#ifndef _CAN_TX_H
+#define _CAN_TX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// fsae_can.c registers 10, evt_can.c 7
+#define CAN_TX_MAX_FRAMES 10
+
+// frames registered back to back start this far apart, so frames sharing
+// a period never come due in the same pass
+#define CAN_TX_STAGGER_ms 7
+
+// the budget may be saved up for at most this long, bounding the burst
+// that goes out after a quiet spell
+#define CAN_TX_BURST_ms 20
+
+// priority 0 frames (heartbeat, errors, charger control) are never held
+// back by the bus-load budget, only ordered before everything else
+#define CAN_TX_PRIORITY_SAFETY 0
+
+typedef enum {
+    CAN_TX_SENT,    // frame accepted by the driver
+    CAN_TX_MORE,    // frame accepted, call again for the next one this period
+    CAN_TX_BUSY,    // mailbox full, try again next pass
+    CAN_TX_NOTHING  // nothing to send this period (e.g. charger off)
+} CAN_TX_STATUS_T;
+
+/**
+ * @details builds the frame from current state and hands it to the driver
+ *
+ * @return whether the driver took the frame
+ */
+typedef CAN_TX_STATUS_T (*CAN_TX_SEND_T)(void);
+
+typedef struct {
+    const char *name;
+    CAN_TX_SEND_T send;
+    uint32_t period_ms;
+    uint16_t bits;              // worst case frame length on the wire
+    uint8_t priority;           // lower goes first
+    bool pending;
+
+    uint32_t next_ms;           // when the frame is next due
+    uint32_t due_ms;            // when the pending frame came due
+
+    // statistics, all but sent saturate at UINT16_MAX
+    uint32_t sent;              // frames, a multi-frame period counts each
+    uint16_t retries;           // mailbox full when the frame was due
+    uint16_t deferred;          // passes held back by the bus-load budget
+    uint16_t missed;            // periods that came due while still pending
+    uint16_t max_latency_ms;    // longest time from due to sent
+} CAN_TX_FRAME_T;
+
+/**
+ * @details clear the frame table and fill the bus-load budget
+ *
+ * @param baud_rate bus bit rate
+ * @param budget_pct share of the bus periodic frames may use
+ * @param msTicks current time
+ */
+void CanTx_Init(uint32_t baud_rate, uint8_t budget_pct, uint32_t msTicks);
+
+/**
+ * @details register a periodic frame. The first transmission is staggered
+ *          by CAN_TX_STAGGER_ms per frame already registered
+ *
+ * @param name name shown by the console
+ * @param send builds and sends the frame
+ * @param period_ms transmit period, not 0
+ * @param dlc payload length, for the bus-load budget
+ * @param priority lower goes first, CAN_TX_PRIORITY_SAFETY ignores the budget
+ * @param msTicks current time
+ * @return frame id, CAN_TX_MAX_FRAMES if the table is full
+ */
+uint8_t CanTx_AddFrame(const char *name, CAN_TX_SEND_T send, uint32_t period_ms,
+        uint8_t dlc, uint8_t priority, uint32_t msTicks);
+
+/**
+ * @details send due frames in priority order within the bus-load budget.
+ *          Stops at the first full mailbox; the frame stays pending and is
+ *          retried next pass instead of being dropped. A frame returning
+ *          CAN_TX_MORE is called again while the budget lasts and stays
+ *          pending until it returns CAN_TX_SENT
+ *
+ * @param msTicks current time
+ * @return number of frames sent
+ */
+uint8_t CanTx_Run(uint32_t msTicks);
+
+/**
+ * @return worst case bits on the wire for a standard frame with dlc bytes,
+ *         including stuff bits
+ */
+uint16_t CanTx_FrameBits(uint8_t dlc);
+
+/**
+ * @return bus load from sent frames over the last full second, in percent
+ */
+uint8_t CanTx_GetLoad_pct(void);
+
+uint8_t CanTx_GetFrameCount(void);
+
+const CAN_TX_FRAME_T * CanTx_GetFrame(uint8_t id);
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef _CELL_FILTER_H
+#define _CELL_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+
+// Per-cell filter between the LTC6804 readback and the cell voltages in
+// BMS_PACK_STATUS_T, so one noisy sample does not toggle a balance FET or
+// start an error timer.
+//
+// The filtered array is updated in place: a sample more than
+// CELL_FILTER_OUTLIER_mV from the cell's last filtered voltage is dropped,
+// unless CELL_FILTER_OUTLIER_MAX samples in a row have been: then the step
+// is real and the filter restarts from it.
+// Accepted samples go through either
+//   IIR:     y += (x - y) / 2^CELL_FILTER_IIR_SHIFT, in 1/256 mV
+//   median:  median of the last three accepted samples
+// The state is one array per field, indexed by cell, so each pass walks
+// contiguous memory. It is kept as 8 bit offsets from the filtered array:
+// the IIR state's fraction of a mV, or the two earlier samples, which are
+// clamped to 127 mV (an accepted sample is at most CELL_FILTER_OUTLIER_mV
+// away). The two modes share it, 2.5 bytes per cell with the reject counts.
+
+typedef enum {
+    CELL_FILTER_NONE,       // pass the readback through
+    CELL_FILTER_IIR,
+    CELL_FILTER_MEDIAN3
+} CELL_FILTER_MODE_T;
+
+/**
+ * @details forget every cell's history, the next update seeds the filter
+ */
+void CellFilter_Init(CELL_FILTER_MODE_T mode);
+
+/**
+ * @details filter one readback of the pack
+ *
+ * @param raw_mV cell voltages as read back
+ * @param filtered_mV last filtered cell voltages, updated in place. Only the
+ *                    filter may write it between updates
+ * @param num_cells cells in the pack, at most MAX_NUM_MODULES*MAX_CELLS_PER_MODULE
+ */
+void CellFilter_Update(const uint32_t *raw_mV, uint32_t *filtered_mV, uint16_t num_cells);
+
+CELL_FILTER_MODE_T CellFilter_GetMode(void);
+
+/**
+ * @return samples dropped as outliers since init
+ */
+uint32_t CellFilter_GetRejected(void);
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef _CELL_HISTORY_H
+#define _CELL_HISTORY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+
+// The last CELL_HISTORY_LEN filtered voltages of the lowest cell and of the
+// pack average, at most one sample per CELL_HISTORY_PERIOD_ms, so the window
+// spans the same time at every sampling rate.
+//
+// Only the lowest cell is kept, a history of every cell does not fit in RAM.
+// A cell that sags under load falls to the bottom of the pack, so the
+// lowest cell is the one to watch. Another cell takes over once it reads
+// CELL_HISTORY_SWITCH_mV below the tracked one, and the window starts over
+// from it, so two cells a mV apart do not keep restarting it.
+//
+// A pack-wide load step moves every cell, so sag is measured against the
+// pack: the tracked cell's slope less the average slope.
+
+void CellHistory_Init(void);
+
+/**
+ * @details record the latest cell voltages, if CELL_HISTORY_PERIOD_ms have
+ *          passed since the last sample
+ *
+ * @param cell_voltages_mV filtered cell voltages
+ * @param min_position lowest cell, pack_status->min_cell_voltage_position
+ * @param average_mV pack_status->avg_cell_voltage_mV
+ * @return true if the sample was recorded
+ */
+bool CellHistory_Append(const uint32_t *cell_voltages_mV, uint16_t min_position,
+        uint32_t average_mV, uint32_t msTicks);
+
+/**
+ * @return samples in the window, up to CELL_HISTORY_LEN
+ */
+uint8_t CellHistory_GetCount(void);
+
+/**
+ * @return time from the oldest to the newest sample
+ */
+uint32_t CellHistory_GetSpan_ms(void);
+
+/**
+ * @return the tracked cell
+ */
+uint16_t CellHistory_GetCell(void);
+
+/**
+ * @param age 0 for the newest sample, up to CellHistory_GetCount() - 1
+ * @return the tracked cell's voltage age samples ago
+ */
+uint16_t CellHistory_GetSample_mV(uint8_t age);
+
+/**
+ * @return the tracked cell's slope over the window, 0 with fewer than two
+ *         samples
+ */
+int32_t CellHistory_GetSlope_mV_s(void);
+
+/**
+ * @return the pack average's slope over the window, 0 with fewer than two
+ *         samples
+ */
+int32_t CellHistory_GetAverageSlope_mV_s(void);
+
+/**
+ * @param position set to the tracked cell, if not NULL
+ * @return how much faster than the average the tracked cell falls, 0 if it
+ *         does not
+ */
+uint32_t CellHistory_GetSag_mV_s(uint16_t *position);
+
+#endif
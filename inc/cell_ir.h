@@ -0,0 +1,66 @@
+#ifndef _CELL_IR_H
+#define _CELL_IR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+
+// Online DC internal resistance of every cell (each parallel group), from
+// the voltage response to steps in pack current:
+//   R = -(V_now - V_prev) / (I_now - I_prev)
+// with the current positive out of the pack. A pair of readbacks counts
+// only when the current moved by at least CELL_IR_MIN_STEP_mA and they are
+// at most CELL_IR_MAX_GAP_ms apart, so the open circuit voltage has not had
+// time to drift. Both samples are raw readbacks, the cell filter would
+// smear the step.
+//
+// Each accepted pair is blended into the cell's estimate,
+//   R += (R_pair - R) / 2^CELL_IR_SHIFT
+// the first one seeds it. A pair that gives a cell a non-positive or out of
+// range resistance leaves that cell alone. 0 uOhm means not yet known.
+//
+// The estimates live in an array owned by the caller, so they can be loaded
+// from and saved to EEPROM. Only a window of CELL_IR_WINDOW cells keeps its
+// previous readback, so each step measures one window and the next step
+// the next one, round the pack.
+
+/**
+ * @details forget the previous readback, the next update only records one
+ */
+void CellIr_Init(void);
+
+/**
+ * @details step the estimates with the latest readback
+ *
+ * @param cell_voltages_mV raw cell voltages
+ * @param num_cells cells in the pack, the same for every call since init
+ * @param discharge_current_mA pack current at msTicks, negative while charging
+ * @param msTicks time the cells were sampled
+ * @param cell_ir_uOhm estimates, updated in place
+ * @return true if any estimate in the window changed
+ */
+bool CellIr_Update(const uint32_t *cell_voltages_mV, uint16_t num_cells,
+        int32_t discharge_current_mA, uint32_t msTicks, uint16_t *cell_ir_uOhm);
+
+/**
+ * @return updates that changed an estimate since boot, to tell when the
+ *         estimates are worth saving
+ */
+uint32_t CellIr_GetUpdates(void);
+
+/**
+ * @details the discharge current that would pull the weakest cell down to
+ *          cell_min_mV: each cell's open circuit voltage is its voltage plus
+ *          I*R at the present current, and it drops R per amp from there
+ *
+ * @param cell_voltages_mV raw cell voltages
+ * @param cell_ir_uOhm estimates, cells at 0 are skipped
+ * @param num_cells cells in the pack
+ * @param discharge_current_mA present discharge current, 0 if not discharging
+ * @param cell_min_mV lowest voltage a cell may reach
+ * @return the limit, to the amp, or UINT32_MAX if no cell has an estimate
+ */
+uint32_t CellIr_MaxCurrent_mA(const uint32_t *cell_voltages_mV, const uint16_t *cell_ir_uOhm,
+        uint16_t num_cells, uint32_t discharge_current_mA, uint32_t cell_min_mV);
+
+#endif
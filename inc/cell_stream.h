@@ -0,0 +1,111 @@
+#ifndef _CELL_STREAM_H
+#define _CELL_STREAM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "can_tx.h"
+
+// Every cell voltage, thermistor temperature and cell resistance is streamed in round-robin
+// pages on one CAN id per quantity:
+//   byte 0     page index
+//   byte 1     pages in a sweep
+//   bytes 2-7  up to three 16 bit values, little endian, in pack order
+// so value n of the sweep is in page n/3, slot n%3. The last page is
+// shortened to the values it holds
+#define CELL_STREAM_VALUES_PER_PAGE 3
+#define CELL_STREAM_PAGE_HEADER 2
+
+typedef struct {
+    uint8_t page;   // next page to send
+} CELL_STREAM_T;
+
+/**
+ * @details fill a frame with the current page of values, one of the
+ *          CellStream_Pack* functions below
+ *
+ * @return frame length, 0 when there is nothing to send
+ */
+typedef uint8_t (*CELL_STREAM_PACK_T)(CELL_STREAM_T *stream, const void *values,
+        uint16_t num_values, uint8_t *data);
+
+/**
+ * @details hand one frame to the CAN driver
+ *
+ * @return CAN_TX_SENT if the driver took the frame, CAN_TX_BUSY otherwise
+ */
+typedef CAN_TX_STATUS_T (*CELL_STREAM_TRANSMIT_T)(uint32_t can_id, const uint8_t *data,
+        uint8_t len);
+
+void CellStream_Init(CELL_STREAM_T *stream);
+
+/**
+ * @return pages needed for num_values values
+ */
+uint8_t CellStream_NumPages(uint16_t num_values);
+
+/**
+ * @details fill a frame with the current page of cell voltages (in mV).
+ *          Does not advance the stream, see CellStream_NextPage
+ *
+ * @param stream stream state
+ * @param cell_voltages_mV pack cell voltages, uint32_t
+ * @param num_cells cells in the pack
+ * @param data 8 byte frame payload
+ * @return frame length
+ */
+uint8_t CellStream_PackVoltages(CELL_STREAM_T *stream, const void *cell_voltages_mV,
+        uint16_t num_cells, uint8_t *data);
+
+/**
+ * @details fill a frame with the current page of thermistor temperatures
+ *          (in dC, signed). Does not advance the stream
+ *
+ * @param stream stream state
+ * @param cell_temperatures_dC pack thermistor temperatures, int16_t
+ * @param num_thermistors thermistors in the pack
+ * @param data 8 byte frame payload
+ * @return frame length
+ */
+uint8_t CellStream_PackTemperatures(CELL_STREAM_T *stream, const void *cell_temperatures_dC,
+        uint16_t num_thermistors, uint8_t *data);
+
+/**
+ * @details fill a frame with the current page of cell resistances (in uOhm,
+ *          see cell_ir.h). Does not advance the stream
+ *
+ * @param stream stream state
+ * @param cell_ir_uOhm pack cell resistances, uint16_t
+ * @param num_cells cells in the pack
+ * @param data 8 byte frame payload
+ * @return frame length
+ */
+uint8_t CellStream_PackResistances(CELL_STREAM_T *stream, const void *cell_ir_uOhm,
+        uint16_t num_cells, uint8_t *data);
+
+/**
+ * @details move on to the next page once the current one has been sent
+ *
+ * @param stream stream state
+ * @param num_values values in the stream
+ * @return true if that was the last page of the sweep
+ */
+bool CellStream_NextPage(CELL_STREAM_T *stream, uint16_t num_values);
+
+/**
+ * @details pack the current page, send it and move on once the driver has
+ *          taken it. This is the CanTx send callback body of every stream
+ *
+ * @param stream stream state
+ * @param can_id id the stream goes out on
+ * @param pack fills the frame from values
+ * @param values pack wide array of the streamed quantity
+ * @param num_values values in the stream
+ * @param transmit hands the frame to the driver
+ * @return CAN_TX_MORE until the last page of the sweep is sent, then
+ *         CAN_TX_SENT. CAN_TX_BUSY leaves the page to be sent again
+ */
+CAN_TX_STATUS_T CellStream_Send(CELL_STREAM_T *stream, uint32_t can_id, CELL_STREAM_PACK_T pack,
+        const void *values, uint16_t num_values, CELL_STREAM_TRANSMIT_T transmit);
+
+#endif
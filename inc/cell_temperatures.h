@@ -17,19 +17,13 @@
 #define THERMISTOR_GROUP_THREE_END    23
 #define THERMISTOR_GROUP_THREE_OFFSET 8
 
-// Contansts for linear curve fit relating thermistor voltages (in mV) to temperatures
-// (in dC)
-// The equation is temp_dC = thermistorVoltage/4 - 39
-#define SHIFT_VOLTAGE 2
-#define A0 -39
-
 /****************************************************************************************
  * Public Functions
  * *************************************************************************************/
 
 /**
  * @details updates array of cell temperatures in pack_status with values stored in 
- *          gpioVoltages
+ *          gpioVoltages, and the maximum, minimum and average cell temperatures
  *
  * @param gpioVoltages array of voltages measured on each GPIO of the LTC6804 chips
  *                     gpioVoltages is structured as follows {GPIO1_module1, ..., 
@@ -41,7 +35,8 @@ void CellTemperatures_UpdateCellTemperaturesArray(uint32_t * gpioVoltages,
         uint8_t currentThermistor, BMS_PACK_STATUS_T * pack_status, uint8_t num_modules);
 
 /**
- * @details updates maximum, minimum, and average cell temperatures in pack_status
+ * @details recomputes maximum, minimum, and average cell temperatures in pack_status
+ *          from the whole array of cell temperatures
  *
  * @param pack_status mutable datatype containing array of cell temperatures, maximum
  *                    cell temperature, minimum cell temperature, and average cell 
@@ -55,7 +50,7 @@ void CellTemperatures_UpdateMaxMinAvgCellTemperatures(BMS_PACK_STATUS_T * pack_s
 
 /**
  * @details creates an array of thermistor temperatures (in dC) from an array of gpio 
- * voltages (in mV)
+ * voltages (in mV), through the thermistor lookup table (see thermistor.h)
  *
  * @param gpioVoltages array of voltages measured on each GPIO of the LTC6804 chips
  *                     gpioVoltages is structured as follows {GPIO1_module1, ..., 
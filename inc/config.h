@@ -10,4 +10,103 @@
 #define CAN_BAUD 500000
 #define EEPROM_BAUD 600000
 
+// LTC6804 PEC15 lookup table (see pec15.h): 256 entries is one lookup per
+// byte for 512 bytes of flash, 16 entries two lookups for 32 bytes, 0 is
+// the bitwise reference with no table
+#define PEC15_TABLE_ENTRIES 256
+
+// share of the bus our periodic frames may use, leaving the rest to the
+// VCU and other nodes
+#define CAN_TX_BUS_LOAD_pct 30
+
+// Scheduler task periods
+#define CELL_VOLTAGES_PERIOD_ms 100
+// start the next conversion as soon as the last one is read back, so at the
+// fast sampling rate the voltages refresh as fast as the chain converts
+#define CELL_VOLTAGES_PIPELINED true
+// Cell voltage filter (see cell_filter.h): CELL_FILTER_MEDIAN3 lags one
+// sample, CELL_FILTER_IIR with shift 2 takes ~8 samples to settle to 90%
+#define CELL_FILTER_MODE CELL_FILTER_MEDIAN3
+#define CELL_FILTER_IIR_SHIFT 2
+#define CELL_FILTER_OUTLIER_mV 150
+#define CELL_FILTER_OUTLIER_MAX 2
+// Lowest cell voltage history (see cell_history.h). Discharge tapers the
+// allowed current once a cell sags faster than the pack by
+// CELL_SAG_TAPER_mV_s, in proportion, down to the floor
+#define CELL_HISTORY_LEN 8
+#define CELL_HISTORY_PERIOD_ms 500
+#define CELL_HISTORY_SWITCH_mV 10
+#define CELL_SAG_TAPER_mV_s 20
+#define CELL_SAG_TAPER_FLOOR_pct 25
+// Cell internal resistance (see cell_ir.h). Discharge also limits the
+// current to what keeps every cell CELL_IR_MARGIN_mV above cell_min_mV.
+// Changed estimates are saved to EEPROM at most once per save period
+#define CELL_IR_MIN_STEP_mA 20000
+#define CELL_IR_MAX_GAP_ms 250
+#define CELL_IR_SHIFT 3
+#define CELL_IR_WINDOW MAX_CELLS_PER_MODULE   // cells measured per step
+#define CELL_IR_MARGIN_mV 50
+#define CELL_IR_SAVE_PERIOD_ms 600000
+// current samples kept to line the current up with the cell voltages (see
+// sample_sync.h), enough to span a cell voltage sweep at the idle rate
+#define SAMPLE_SYNC_CURRENT_LEN 4
+// Pack voltage plausibility (see pack_stats.h): the raw cell sum and the
+// measured pack voltage may differ by an offset plus a share of the pack
+// voltage, and are only compared when measured close together
+#define PACK_VOLTAGE_MISMATCH_mV 3000
+#define PACK_VOLTAGE_MISMATCH_PERMILLE 20
+#define PACK_VOLTAGE_MAX_SKEW_ms 200
+
+// Pack current sensor (see current_sense.h). Once it has calibrated its zero
+// the charger's current report is ignored, until then it stands in. Off
+// until the part is confirmed: the defaults assume a +-500 A hall sensor
+// scaled to the 10 bit ADC with zero at mid scale; a negative scale flips
+// the polarity. 1 kHz oversampled 16 times is a reading every 16 ms
+#define CURRENT_SENSE_ENABLED false
+#define CURRENT_SENSE_SAMPLE_HZ 1000
+#define CURRENT_SENSE_OVERSAMPLE 16
+#define CURRENT_SENSE_ZERO_COUNTS 512
+#define CURRENT_SENSE_uA_PER_COUNT 976563
+#define CURRENT_SENSE_CAL_READINGS 32
+#define CURRENT_SENSE_MAX_OFFSET_COUNTS 40
+// an open wire test stops cell voltage readback for its whole slot, one
+// full daisy chain test (see gcv_pipeline.h), so it stays rare
+#define OPEN_WIRE_TEST_PERIOD_ms 60000
+#define MEASURE_PERIOD_ms 1000
+#define MEASURE_BINARY_PERIOD_ms 200
+#define HEARTBEAT_PERIOD_ms 1000
+
+// Adaptive sampling (see sampling.h). The thresholds for the fast rate are
+// in PACK_CONFIG_T, the periods for each rate here; 0 runs a task every pass
+#define SAMPLING_PERIOD_ms 100
+#define SAMPLING_DVDT_WINDOW_ms 1000
+#define SAMPLING_FAST_HOLD_ms 5000
+#define SAMPLING_IDLE_VOLTAGES_ms 1000
+#define SAMPLING_NORMAL_VOLTAGES_ms CELL_VOLTAGES_PERIOD_ms
+#define SAMPLING_FAST_VOLTAGES_ms 0
+// selecting a thermistor takes ~21 pin writes (see mux_sequence.h). Hot
+// thermistors are read more often (see thermistor_scan.h), the rest at
+// least once every THERMISTOR_SCAN_MAX_AGE periods
+#define SAMPLING_IDLE_THERMISTOR_ms 50
+#define SAMPLING_NORMAL_THERMISTOR_ms 10
+#define SAMPLING_FAST_THERMISTOR_ms 5
+
+// Main loop timing diagnostics
+#define TIMING_LOOP_BUDGET_us 1000
+#define TIMING_CAN_ID 0x7A0
+#define TIMING_CAN_PERIOD_ms 200 // one stage per frame
+#define CAN_RX_STATS_CAN_ID 0x7A1 // sent with every timing frame
+
+// Per-cell streams (see cell_stream.h), one full sweep per period
+#define CELL_STREAM_VOLTAGE_CAN_ID 0x7A2
+#define CELL_STREAM_TEMP_CAN_ID 0x7A3
+#define CELL_STREAM_IR_CAN_ID 0x7A4
+#define CELL_STREAM_VOLTAGE_PERIOD_ms 100
+#define CELL_STREAM_TEMP_PERIOD_ms 1000
+#define CELL_STREAM_IR_PERIOD_ms 10000
+
+// Discharge current limits for the load (see discharge.h)
+#define CURRENT_LIMIT_CAN_ID 0x7A5
+#define CURRENT_LIMIT_PERIOD_ms 100
+
 #endif
@@ -39,7 +39,7 @@ static const char * const helpstring[NUMCOMMANDS] = {"Get a value. Possible opti
                             "go into charge mode: chrg [on|off]",
                             "go into discharge mode: dis [on|off]",
                             "configure pack config defaults",
-                            "start measurement printout mode, four flags (pcurrent/pvoltage/cell temps/voltages): measure [print_flags|temps|voltages|packcurrent|packvoltage|on|off]"};
+                            "start measurement printout mode, four flags (pcurrent/pvoltage/cell temps/voltages): measure [print_flags|temps|voltages|packcurrent|packvoltage|binary|on|off]"};
 
 static const char * const locstring[] =  {
                             "cell_min_mV",
@@ -56,6 +56,9 @@ static const char * const locstring[] =  {
                             "cc_cell_voltage_mV",
                             "cell_discharge_c_rating_cC",
                             "max_cell_temp_param",
+                            "sample_fast_current_mA",
+                            "sample_fast_margin_mV",
+                            "sample_fast_dvdt_mV_s",
                             //can't write to the follwing
                             "state",
                             "cvm",
@@ -65,7 +68,15 @@ static const char * const locstring[] =  {
                             "pack_current_mA",
                             "pack_voltage_mV",
                             "max_temp",
-                            "error"
+                            "error",
+                            "timing",
+                            "tasks",
+                            "soc",
+                            "can_rx",
+                            "can_tx",
+                            "sampling",
+                            "cell_sag",
+                            "cell_ir"
 };
 
 static const uint32_t locparam[ARRAY_SIZE(locstring)][3] = { 
@@ -83,6 +94,9 @@ static const uint32_t locparam[ARRAY_SIZE(locstring)][3] = {
                             {1, 0,UINT32_MAX},//"cc_cell_voltage_mV",
                             {1, 0,UINT32_MAX},//"cell_discharge_c_rating_cC",
                             {1, 0,UINT32_MAX},//"max_cell_temp_dC",
+                            {1, 0,UINT32_MAX},//"sample_fast_current_mA",
+                            {1, 0,UINT32_MAX},//"sample_fast_margin_mV",
+                            {1, 0,UINT32_MAX},//"sample_fast_dvdt_mV_s",
                             //can't write to the follwing
                             {0,0,0},//"state",
                             {0,0,0},//"*cell_voltages_mV",
@@ -92,7 +106,15 @@ static const uint32_t locparam[ARRAY_SIZE(locstring)][3] = {
                             {0,0,0},//"pack_current_mA",
                             {0,0,0},//"pack_voltage_mV",
                             {0,0,0},//"max_temp",
-                            {0,0,0}//"error"
+                            {0,0,0},//"error"
+                            {0,0,0},//"timing"
+                            {0,0,0},//"tasks"
+                            {0,0,0},//"soc"
+                            {0,0,0},//"can_rx"
+                            {0,0,0},//"can_tx"
+                            {0,0,0},//"sampling"
+                            {0,0,0},//"cell_sag"
+                            {0,0,0}//"cell_ir"
 };
 
 typedef void (* const EXECUTE_HANDLER)(const char * const *);
@@ -107,6 +129,7 @@ typedef struct {
     bool measure_voltage;
     bool measure_packcurrent;
     bool measure_packvoltage;
+    bool measure_binary;
 } CONSOLE_OUTPUT_T;
 
 typedef struct console_t {
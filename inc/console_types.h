@@ -29,6 +29,9 @@ typedef enum {
     RWL_cc_cell_voltage_mV,
     RWL_cell_discharge_c_rating_cC,
     RWL_max_cell_temp_dC,
+    RWL_sample_fast_current_mA,
+    RWL_sample_fast_margin_mV,
+    RWL_sample_fast_dvdt_mV_s,
     RWL_LENGTH
 } rw_loc_label_t;
 
@@ -44,6 +47,14 @@ typedef enum {
     ROL_pack_voltage_mV,
     ROL_max_temp_dC,
     ROL_error,
+    ROL_timing,
+    ROL_tasks,
+    ROL_soc,
+    ROL_can_rx,
+    ROL_can_tx,
+    ROL_sampling,
+    ROL_cell_sag,
+    ROL_cell_ir,
     ROL_LENGTH
 } ro_loc_label_t;
 
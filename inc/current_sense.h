@@ -0,0 +1,58 @@
+#ifndef _CURRENT_SENSE_H
+#define _CURRENT_SENSE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+
+// Pack current from a bidirectional hall sensor on an MCU ADC channel.
+//
+// A timer interrupt samples the ADC at CURRENT_SENSE_SAMPLE_HZ and hands
+// each conversion to CurrentSense_AddSample. Every CURRENT_SENSE_OVERSAMPLE
+// samples are summed into one reading, which averages out the ADC noise
+// and, with enough of it, adds resolution below one count. The main loop
+// picks up each reading with CurrentSense_Read, so the interrupt does no
+// division.
+//
+// The sensor's zero drifts with temperature. Whenever the caller says no
+// current can flow (contactors open), CURRENT_SENSE_CAL_READINGS readings
+// in a row are averaged into a new offset. An offset more than
+// CURRENT_SENSE_MAX_OFFSET_COUNTS from the nominal zero means the sensor
+// is not there or broken, and is not taken.
+//
+// Current is positive out of the pack.
+
+/**
+ * @details drop any partial reading and go back to the nominal offset
+ */
+void CurrentSense_Init(void);
+
+/**
+ * @details add one ADC conversion, called from the sampling interrupt
+ *
+ * @param counts ADC result
+ * @param msTicks time of the conversion
+ */
+void CurrentSense_AddSample(uint16_t counts, uint32_t msTicks);
+
+/**
+ * @details convert the latest reading, if there is a new one
+ *
+ * @param at_rest no current can flow, so the reading is the sensor's zero
+ * @param current_mA set to the current
+ * @param sample_ms set to the time of the reading's last sample
+ * @return true if there was a new reading
+ */
+bool CurrentSense_Read(bool at_rest, int32_t *current_mA, uint32_t *sample_ms);
+
+/**
+ * @return true once an offset has been measured
+ */
+bool CurrentSense_IsCalibrated(void);
+
+/**
+ * @return zero current, in ADC counts summed over a reading
+ */
+uint32_t CurrentSense_GetOffset(void);
+
+#endif
@@ -7,9 +7,29 @@
 
 uint32_t Calculate_Max_Current(uint32_t cell_capacity_cAh, uint32_t discharge_rating_cC, uint32_t pack_cells_p, uint16_t cell_temp_dC);
 
+/**
+ * @details taper the current limit while a cell sags faster than the pack by
+ *          more than CELL_SAG_TAPER_mV_s, in proportion to the sag, down to
+ *          CELL_SAG_TAPER_FLOOR_pct
+ *
+ * @param cell_sag_mV_s pack_status->max_cell_sag_mV_s
+ */
+uint32_t Calculate_Allowed_Current(uint32_t max_current_mA, uint32_t cell_sag_mV_s);
+
 void Discharge_Init(BMS_STATE_T *state);
 void Discharge_Config(PACK_CONFIG_T *pack_config);
 void Discharge_Step(BMS_INPUT_T *input, BMS_STATE_T *state, BMS_OUTPUT_T *output);
 uint32_t Read_Max_Current(void);
+// current to ask the load for, at most Read_Max_Current()
+uint32_t Read_Allowed_Current(void);
+
+/**
+ * @details fill a CAN frame with the discharge current limits for the load:
+ *          allowed current in mA (u32), max current in mA (u32), little endian
+ *
+ * @param data 8 byte frame payload
+ * @return frame length
+ */
+uint8_t Discharge_PackCanFrame(uint8_t *data);
 
 #endif
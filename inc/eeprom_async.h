@@ -0,0 +1,82 @@
+#ifndef _EEPROM_ASYNC_H
+#define _EEPROM_ASYNC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Writes are buffered in 64 byte blocks. The LC1024 page is 256 bytes, so a
+// block never wraps around a page boundary
+#define EEPROM_ASYNC_BLOCK_SIZE 64
+#define EEPROM_ASYNC_QUEUE_LEN 3
+#define EEPROM_ASYNC_WRITE_TIMEOUT_ms 20 // LC1024 write cycle is 6ms max
+
+typedef void (*EEPROM_ASYNC_CALLBACK)(bool success);
+
+typedef enum {
+    EEPROM_ASYNC_READ,
+    EEPROM_ASYNC_WRITE
+} EEPROM_ASYNC_OP_T;
+
+typedef struct {
+    EEPROM_ASYNC_OP_T op;
+    uint32_t address;       // write: start of the block, read: first byte
+    uint8_t length;         // read length
+    uint8_t dirty_start;    // write: first dirty byte in the block
+    uint8_t dirty_end;      // write: one past the last dirty byte
+    uint8_t *read_buf;
+    uint8_t block[EEPROM_ASYNC_BLOCK_SIZE];
+    EEPROM_ASYNC_CALLBACK callback;
+} EEPROM_ASYNC_REQ_T;
+
+/**
+ * @details empty the request queue. Does not touch the LC1024
+ */
+void EEPROM_Async_Init(void);
+
+/**
+ * @details queue a write. The data is copied, so the caller may reuse it
+ *          immediately. Writes are split into 64 byte blocks, and bytes that
+ *          overlap or adjoin a block already waiting in the queue are merged
+ *          into it instead of taking another slot
+ *
+ * @param address EEPROM address of the first byte
+ * @param data bytes to write
+ * @param length number of bytes
+ * @param callback called once the last block is written (or failed), may be NULL
+ * @return false if the queue is full, nothing is queued in that case
+ */
+bool EEPROM_Async_Write(uint32_t address, const uint8_t *data, uint16_t length,
+        EEPROM_ASYNC_CALLBACK callback);
+
+/**
+ * @details queue a read. Runs after every write queued before it
+ *
+ * @param address EEPROM address of the first byte
+ * @param buf destination, must stay valid until the callback
+ * @param length number of bytes
+ * @param callback called once buf holds the data, may be NULL
+ * @return false if the queue is full
+ */
+bool EEPROM_Async_Read(uint32_t address, uint8_t *buf, uint8_t length,
+        EEPROM_ASYNC_CALLBACK callback);
+
+/**
+ * @details advance the request state machine. Never waits on the LC1024,
+ *          a write in progress is checked through its status register on
+ *          the next call
+ *
+ * @param msTicks current time
+ */
+void EEPROM_Async_Service(uint32_t msTicks);
+
+/**
+ * @details service the queue until it is empty. Only for startup and the
+ *          forced hang, where blocking is acceptable
+ */
+void EEPROM_Async_Flush(void);
+
+bool EEPROM_Async_Idle(void);
+
+uint8_t EEPROM_Async_QueueLength(void);
+
+#endif
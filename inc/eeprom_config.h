@@ -11,7 +11,9 @@
 
 #define EEPROM_DATA_START_PCKCFG 0x000000
 #define EEPROM_DATA_START_CC 0x000100
-#define STORAGE_VERSION 0x05
+#define EEPROM_DATA_START_CELL_IR 0x000200
+#define STORAGE_VERSION 0x06
+#define CELL_IR_STORAGE_VERSION 0x01
 #define CHECKSUM_BYTESIZE 1
 #define VERSION_BYTESIZE 1
 #define ERROR_BYTESIZE 1
@@ -31,6 +33,9 @@
 #define CELL_DISCHARGE_C_RATING_cC 200 // at 27 degrees C
 #define MAX_CELL_TEMP_dC 600
 #define MODULE_CELL_COUNT 12
+#define SAMPLE_FAST_CURRENT_mA 50000
+#define SAMPLE_FAST_MARGIN_mV 100
+#define SAMPLE_FAST_DVDT_mV_s 20
 
 // FSAE specific macros
 #ifdef FSAE_DRIVERS
@@ -49,7 +54,29 @@ void Set_EEPROM_Error(uint8_t error);
 uint8_t Get_EEPROM_Error(void);
 
 uint32_t EEPROM_LoadCCPage_Num(uint8_t idx);
-void EEPROM_WriteCCPage_Num(uint8_t idx, uint32_t val);
+bool EEPROM_WriteCCPage_Num(uint8_t idx, uint32_t val);
 void EEPROM_LoadCCPage(uint32_t *cc);
-void EEPROM_WriteCCPage(uint32_t *cc);
+bool EEPROM_WriteCCPage(uint32_t *cc);
+
+/**
+ * @details load the cell resistances (see cell_ir.h). Blocking, only for
+ *          startup and a pack config reload
+ *
+ * @param cell_ir_uOhm filled in, all 0 if nothing valid is saved for this pack
+ * @param num_cells cells in the pack
+ * @return true if the saved resistances were used
+ */
+bool EEPROM_LoadCellIR(uint16_t *cell_ir_uOhm, uint16_t num_cells);
+
+/**
+ * @details queue as much of the cell resistances as the write queue takes,
+ *          call again until it returns true. cell_ir_uOhm must not change
+ *          in between
+ *
+ * @param cell_ir_uOhm resistances to save
+ * @param num_cells cells in the pack
+ * @param offset bytes queued so far, 0 to start a save
+ * @return true once everything is queued
+ */
+bool EEPROM_WriteCellIR(const uint16_t *cell_ir_uOhm, uint16_t num_cells, uint16_t *offset);
 #endif
@@ -20,6 +20,7 @@ typedef enum error {
     ERROR_BRUSA,
     ERROR_CAN,
     ERROR_CONFLICTING_MODE_REQUESTS,
+    ERROR_PACK_VOLTAGE_MISMATCH,
 #ifdef FSAE_DRIVERS
     ERROR_VCU_DEAD,
     ERROR_CONTROL_FLOW,
@@ -41,7 +42,8 @@ static const char * const ERROR_NAMES[ERROR_NUM_ERRORS] = {
     "ERROR_OVER_CURRENT",
     "ERROR_BRUSA", // [TODO] Remove for FSAE
     "ERROR_CAN",
-    "ERROR_CONFLICTING_MODE_REQUESTS"
+    "ERROR_CONFLICTING_MODE_REQUESTS",
+    "ERROR_PACK_VOLTAGE_MISMATCH"
 #ifdef FSAE_DRIVERS
     ,"ERROR_VCU_DEAD"
     ,"ERROR_CONTROL_FLOW"
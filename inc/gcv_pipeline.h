@@ -0,0 +1,82 @@
+#ifndef _GCV_PIPELINE_H
+#define _GCV_PIPELINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Sequences cell voltage acquisition on the LTC6804 chain. The driver's
+// get call both starts a conversion (ADCV) and, once it is done, reads it
+// back; clear resets the result registers so a conversion that never
+// happened reads back as invalid.
+//
+// One-shot:   convert ... readback, clear, publish, idle until the next call
+// Pipelined:  convert ... readback, clear, convert, publish, ...
+// In pipelined mode the next conversion is already running on the chips
+// while the last results are processed, so a sweep costs only the
+// conversion and readback time.
+//
+// The cells are sampled when the conversion starts, so that is the time the
+// published voltages carry, not the time they were read back.
+//
+// An open wire test drives the same chain and leaves its own results in the
+// cell voltage registers, so it must not run while a conversion is. A
+// requested test takes the next slot between two conversions: the pipeline
+// publishes, runs the test to completion instead of kicking the next
+// conversion, and starts converting again straight after. Readback pauses
+// for the one slot, which lasts as long as a whole daisy chain test.
+
+typedef enum {
+    GCV_OP_WAITING,     // operation still in progress, call again
+    GCV_OP_PASS,        // done
+    GCV_OP_ERROR        // failed, the driver has raised the error
+} GCV_OP_STATUS_T;
+
+typedef struct {
+    GCV_OP_STATUS_T (*convert)(void);   // start a conversion or read it back
+    GCV_OP_STATUS_T (*clear)(void);     // clear the result registers
+    void (*publish)(void);              // process the results read back
+    GCV_OP_STATUS_T (*open_wire)(void); // step an open wire test
+} GCV_PIPELINE_OPS_T;
+
+typedef enum {
+    GCV_STATE_IDLE,         // no conversion running
+    GCV_STATE_CONVERTING,   // conversion started, waiting for readback
+    GCV_STATE_CLEARING,     // results read back, clearing the registers
+    GCV_STATE_OPEN_WIRE     // open wire test running in a slot
+} GCV_PIPELINE_STATE_T;
+
+/**
+ * @param ops driver operations
+ * @param pipelined start the next conversion right after each readback
+ */
+void GcvPipeline_Init(const GCV_PIPELINE_OPS_T *ops, bool pipelined);
+
+/**
+ * @details advance the sequence by as much as the driver allows without
+ *          waiting. An error restarts the sequence from idle
+ *
+ * @param msTicks current time
+ * @return true if a new set of cell voltages was published
+ */
+bool GcvPipeline_Step(uint32_t msTicks);
+
+/**
+ * @details run an open wire test in the next slot between conversions.
+ *          Dropped by GcvPipeline_Init
+ */
+void GcvPipeline_RequestOpenWire(void);
+
+/**
+ * @return true from the request until the test's slot is over
+ */
+bool GcvPipeline_OpenWirePending(void);
+
+/**
+ * @return start of the conversion whose results were published last, valid
+ *         from inside publish
+ */
+uint32_t GcvPipeline_GetSampleTime(void);
+
+GCV_PIPELINE_STATE_T GcvPipeline_GetState(void);
+
+#endif
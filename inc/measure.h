@@ -5,4 +5,10 @@
 
 void Output_Measurements(CONSOLE_OUTPUT_T *console_output, BMS_INPUT_T* bms_input, BMS_STATE_T* bms_state, uint32_t msTicks);
 
+/**
+ * @details keep a binary measurement sweep going and hand queued telemetry
+ *          to the UART ring as it drains. Never blocks, call every loop
+ */
+void Measure_Service(CONSOLE_OUTPUT_T *console_output, BMS_INPUT_T* bms_input, BMS_STATE_T* bms_state);
+
 #endif
@@ -0,0 +1,70 @@
+#ifndef _MUX_SEQUENCE_H
+#define _MUX_SEQUENCE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Selects a thermistor by bit-banging its address into the shift register
+// in front of the multiplexer, MSB first: data, clock high, clock low for
+// every bit, then a latch pulse. Every pin write is a whole configuration
+// write to the LTC6804 chain, so the sequence for an address is built once
+// up front with the writes that would not change a pin left out, and is
+// resumed where it stopped when the chain is not ready.
+
+#define MUX_SEQUENCE_BITS 8
+// clock and latch init, data and two clock edges per bit, two latch edges
+#define MUX_SEQUENCE_MAX_STEPS (2 + 3*MUX_SEQUENCE_BITS + 2)
+
+typedef enum {
+    MUX_PIN_DATA,
+    MUX_PIN_CLOCK,
+    MUX_PIN_LATCH
+} MUX_PIN_T;
+
+typedef enum {
+    MUX_WRITE_WAITING,  // chain not ready, write again later
+    MUX_WRITE_PASS,
+    MUX_WRITE_ERROR     // failed, the driver has raised the error
+} MUX_WRITE_STATUS_T;
+
+typedef MUX_WRITE_STATUS_T (*MUX_WRITE_T)(MUX_PIN_T pin, bool level);
+
+typedef struct {
+    uint8_t pin;
+    bool level;
+} MUX_STEP_T;
+
+typedef struct {
+    MUX_STEP_T steps[MUX_SEQUENCE_MAX_STEPS];
+    uint8_t len;
+    uint8_t next;           // first step not written yet
+    uint8_t address;
+    uint8_t levels;         // pin levels as last written, one bit per pin
+    bool levels_known;      // false until every pin has been written once
+} MUX_SEQUENCE_T;
+
+/**
+ * @details forget the pin levels, the next sequence writes every step
+ */
+void MuxSequence_Init(MUX_SEQUENCE_T *seq);
+
+/**
+ * @details build the writes that select address, starting from the pin
+ *          levels the previous sequence left behind
+ *
+ * @return number of pin writes in the sequence
+ */
+uint8_t MuxSequence_Select(MUX_SEQUENCE_T *seq, uint8_t address);
+
+/**
+ * @details write steps until the sequence is done or write does not pass.
+ *          A waiting write is retried first on the next call. After an error
+ *          the pin levels are unknown, so the sequence is rebuilt in full and
+ *          starts over on the next call
+ *
+ * @param write writes one pin to the chain
+ * @return MUX_WRITE_PASS once the address is latched
+ */
+MUX_WRITE_STATUS_T MuxSequence_Run(MUX_SEQUENCE_T *seq, MUX_WRITE_T write);
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef _PACK_STATS_H
+#define _PACK_STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "state_types.h"
+#include "config.h"
+
+// min/max/sum of the cell voltages (mV) or of one module's thermistor
+// readings (dC). Positions are indices into the pack wide cell voltage /
+// temperature arrays. Only the temperatures are kept per module, the cell
+// voltages are rescanned as a whole on every readback
+typedef struct {
+    int16_t min;
+    int16_t max;
+    int32_t sum;
+    uint16_t min_position;
+    uint16_t max_position;
+} PACK_STATS_T;
+
+/**
+ * @details rebuild all module statistics from the temperature array in
+ *          pack_status (all MAX_NUM_MODULES modules)
+ *
+ * @param pack_status pack status whose arrays are tracked
+ */
+void PackStats_Init(BMS_PACK_STATUS_T *pack_status);
+
+/**
+ * @details rescan the pack's cell voltages and write the pack minimum,
+ *          maximum, average and min/max positions into pack_status
+ *
+ * @param pack_status mutable pack status holding fresh cell voltages
+ * @param num_modules number of modules in the pack
+ * @param module_cell_count module_cell_count[i] is the cell count of module i
+ */
+void PackStats_UpdateVoltages(BMS_PACK_STATUS_T *pack_status, uint8_t num_modules,
+        const uint8_t *module_cell_count);
+
+/**
+ * @details sum the raw readback of the num_modules configured modules into
+ *          pack_status. Uses the raw readback, not the cell filter's output,
+ *          so it follows the pack voltage sample for sample
+ *
+ * @param pack_status mutable pack status holding a fresh raw readback
+ * @param num_modules number of modules in the pack
+ * @param module_cell_count module_cell_count[i] is the cell count of module i
+ */
+void PackStats_UpdateCellSum(BMS_PACK_STATUS_T *pack_status, uint8_t num_modules,
+        const uint8_t *module_cell_count);
+
+/**
+ * @details cross check the cell sum against an independently measured pack
+ *          voltage. They may differ by PACK_VOLTAGE_MISMATCH_mV plus
+ *          PACK_VOLTAGE_MISMATCH_PERMILLE of the cell sum, to allow for the
+ *          error of either measurement and the drop across the wiring
+ *
+ * @param cell_sum_mV sum of the cell voltages
+ * @param pack_voltage_mV measured pack voltage
+ * @return true if they disagree by more than that
+ */
+bool PackStats_PackVoltageMismatch(uint32_t cell_sum_mV, uint32_t pack_voltage_mV);
+
+/**
+ * @details store one thermistor reading and update its module statistics.
+ *          Only rescans the module if the reading replaced its min or max
+ *
+ * @param cell_temperatures_dC mutable pack wide array of thermistor temperatures
+ * @param module module number
+ * @param thermistor thermistor number within the module
+ * @param temp_dC new reading
+ */
+void PackStats_UpdateTemperature(int16_t *cell_temperatures_dC, uint8_t module,
+        uint8_t thermistor, int16_t temp_dC);
+
+/**
+ * @details write the pack maximum (and on FSAE the minimum, average and
+ *          positions) thermistor temperature into pack_status from the
+ *          module statistics
+ *
+ * @param pack_status mutable pack status
+ * @param num_modules number of modules in the pack
+ */
+void PackStats_WriteTemperatures(BMS_PACK_STATUS_T *pack_status, uint8_t num_modules);
+
+/**
+ * @details rescan the thermistor readings of every module and write the
+ *          pack aggregates into pack_status
+ *
+ * @param pack_status mutable pack status
+ * @param num_modules number of modules in the pack
+ */
+void PackStats_RescanTemperatures(BMS_PACK_STATUS_T *pack_status, uint8_t num_modules);
+
+const PACK_STATS_T * PackStats_GetModuleTemperatures(uint8_t module);
+
+#endif
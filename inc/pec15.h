@@ -0,0 +1,32 @@
+#ifndef _PEC15_H
+#define _PEC15_H
+
+#include <stdint.h>
+
+// LTC6804 packet error code: CRC-15, polynomial 0x4599, seeded with 16,
+// sent as the 15 bit remainder shifted left by one. Every command and
+// register group on the daisy chain carries one. PEC15_TABLE_ENTRIES in
+// config.h picks the variant Pec15_Calc uses; host builds compile all of
+// them so they can be checked against each other and benchmarked.
+
+#define PEC15_SEED 16
+
+/**
+ * @param data bytes covered by the PEC
+ * @param len number of bytes
+ * @return PEC as sent on the wire, most significant byte first
+ */
+uint16_t Pec15_Calc(const uint8_t *data, uint16_t len);
+
+/**
+ * @details feed bytes into a running 15 bit remainder. Every variant
+ *          gives the same remainder for the same input
+ *
+ * @param rem remainder so far, PEC15_SEED to start
+ * @return remainder after data
+ */
+uint16_t Pec15_UpdateBitwise(uint16_t rem, const uint8_t *data, uint16_t len);
+uint16_t Pec15_UpdateTable16(uint16_t rem, const uint8_t *data, uint16_t len);
+uint16_t Pec15_UpdateTable256(uint16_t rem, const uint8_t *data, uint16_t len);
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef _SAMPLE_SYNC_H
+#define _SAMPLE_SYNC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+
+// Pack current arrives on its own schedule (a CAN frame, the current
+// sensor), cell voltages on theirs. To look at both at the same instant,
+// the last SAMPLE_SYNC_CURRENT_LEN current samples are kept with the time
+// they were taken, and the current at a voltage sample's time is
+// interpolated between the two samples either side of it.
+//
+// Before the oldest sample the oldest one holds, after the newest the
+// newest one holds: the current is never extrapolated. Times are msTicks,
+// compared through their difference so they may wrap.
+//
+// Current is signed, positive out of the pack, so regen braking during a
+// discharge reads as charging.
+
+void SampleSync_Init(void);
+
+/**
+ * @details record a current sample
+ *
+ * @param current_mA pack current, positive out of the pack
+ * @param msTicks time the current was measured, not older than the last one
+ */
+void SampleSync_AddCurrent(int32_t current_mA, uint32_t msTicks);
+
+/**
+ * @param msTicks time of interest, usually a voltage sample's
+ * @return the pack current at that time, 0 before the first sample
+ */
+int32_t SampleSync_CurrentAt_mA(uint32_t msTicks);
+
+/**
+ * @param msTicks time of interest
+ * @return time from msTicks to the newest current sample, negative if the
+ *         newest sample is older. 0 before the first sample
+ */
+int32_t SampleSync_CurrentLead_ms(uint32_t msTicks);
+
+#endif
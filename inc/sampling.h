@@ -0,0 +1,56 @@
+#ifndef _SAMPLING_H
+#define _SAMPLING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "state_types.h"
+
+// Picks how often cell voltages and thermistors are sampled. The fast rate
+// is used for SAMPLING_FAST_HOLD_ms after any of:
+//   - pack current at or above sample_fast_current_mA
+//   - a cell within sample_fast_margin_mV of cell_min_mV or cell_max_mV
+//   - min or max cell voltage moving at sample_fast_dvdt_mV_s or more
+// Otherwise standby samples at the idle rate, to save CPU and isoSPI power,
+// and every other mode at the normal rate. A threshold of 0 disables it.
+
+typedef enum {
+    SAMPLING_RATE_IDLE,
+    SAMPLING_RATE_NORMAL,
+    SAMPLING_RATE_FAST
+} SAMPLING_RATE_T;
+
+static const char * const SAMPLING_RATE_NAMES[] = {
+    "idle",
+    "normal",
+    "fast"
+};
+
+typedef struct {
+    uint32_t cell_voltages_ms;  // cell voltage task period
+    uint32_t thermistor_ms;     // time per thermistor, the sweep takes 24 of them
+} SAMPLING_PERIODS_T;
+
+void Sampling_Init(void);
+
+/**
+ * @details pick the sampling rate for the current pack state. Call
+ *          periodically, the dV/dt is taken over SAMPLING_DVDT_WINDOW_ms
+ *
+ * @param config thresholds
+ * @param pack_status current, min and max cell voltages
+ * @param mode SSM mode, nothing but standby and init runs slower than normal
+ * @return the rate to sample at
+ */
+SAMPLING_RATE_T Sampling_Update(const PACK_CONFIG_T *config,
+        const BMS_PACK_STATUS_T *pack_status, BMS_SSM_MODE_T mode, uint32_t msTicks);
+
+const SAMPLING_PERIODS_T * Sampling_GetPeriods(SAMPLING_RATE_T rate);
+
+SAMPLING_RATE_T Sampling_GetRate(void);
+
+/**
+ * @return fastest min or max cell voltage change over the last window
+ */
+uint32_t Sampling_GetDvdt_mV_s(void);
+
+#endif
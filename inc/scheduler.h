@@ -0,0 +1,73 @@
+#ifndef _SCHEDULER_H
+#define _SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// main.c registers 10. No headroom, RAM is short: Add_Task stops at init
+// when a new task does not fit
+#define SCHEDULER_MAX_TASKS 10
+
+typedef enum {
+    SCHEDULER_TASK_DONE, // job finished, wait for the next period
+    SCHEDULER_TASK_BUSY  // job waiting on hardware, poll again next pass
+} SCHEDULER_TASK_STATUS_T;
+
+typedef SCHEDULER_TASK_STATUS_T (*SCHEDULER_TASK_FUNC)(uint32_t msTicks);
+
+typedef struct {
+    const char *name;
+    SCHEDULER_TASK_FUNC func;
+    uint32_t period_ms;
+    uint32_t release_ms;        // release time of the current/next job
+    uint8_t priority;           // 0 is the highest priority
+    bool busy;                  // current job returned SCHEDULER_TASK_BUSY
+
+    // statistics, all but runs saturate at UINT16_MAX
+    uint32_t runs;              // completed jobs
+    uint16_t overruns;          // jobs that finished after their deadline
+    uint16_t max_jitter_ms;     // longest delay from release to first poll
+    uint16_t max_latency_ms;    // longest delay from release to completion
+    uint16_t max_exec_us;       // longest single poll
+} SCHEDULER_TASK_T;
+
+/**
+ * @details remove all tasks
+ */
+void Scheduler_Init(void);
+
+/**
+ * @details register a periodic task. Its first job is released immediately.
+ *          A job's deadline is its release time plus period_ms
+ *
+ * @param name name printed by the console
+ * @param func task function, called until it returns SCHEDULER_TASK_DONE
+ * @param period_ms release period, 0 to run on every pass
+ * @param priority ready tasks run in priority order (0 first), ties broken by
+ *                 earliest deadline
+ * @param msTicks current time
+ * @return task id, or SCHEDULER_MAX_TASKS if the task table is full
+ */
+uint8_t Scheduler_AddTask(const char *name, SCHEDULER_TASK_FUNC func,
+        uint32_t period_ms, uint8_t priority, uint32_t msTicks);
+
+/**
+ * @details change the period of a task. Takes effect from the next release
+ *
+ * @param task_id id returned by Scheduler_AddTask
+ * @param period_ms new period
+ */
+void Scheduler_SetPeriod(uint8_t task_id, uint32_t period_ms);
+
+/**
+ * @details poll every released task once, in priority/deadline order
+ *
+ * @param msTicks current time
+ */
+void Scheduler_Run(uint32_t msTicks);
+
+uint8_t Scheduler_GetTaskCount(void);
+
+const SCHEDULER_TASK_T * Scheduler_GetTask(uint8_t task_id);
+
+#endif
@@ -1,5 +1,73 @@
 #ifndef _SOC_H_
 #define _SOC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "state_types.h"
+
+#define SOC_FULL_cpct 10000 // state of charge is kept in hundredths of a percent
+
+// Coulomb counting
+#define SOC_MAX_STEP_ms 1000 // longer gaps are integrated as this long
+#define SOC_CURRENT_MAX_AGE_ms 500 // an older current reading is unknown
+
+// Open circuit voltage correction
+#define SOC_REST_CURRENT_mA 500
+#define SOC_REST_TIME_ms 600000 // cells need to relax before OCV means anything
+
+// Checkpoints: one 32 bit record per slot of the CC page, seq << 16 | soc_cpct
+#define SOC_CHECKPOINT_SLOTS 16
+#define SOC_CHECKPOINT_PERIOD_ms 60000
+#define SOC_CHECKPOINT_DELTA_cpct 10
+
+/**
+ * @details forget the state of charge and capacity
+ */
 void SOC_Init(void);
+
+/**
+ * @details set the pack capacity and restore the newest checkpoint from the
+ *          EEPROM. Without a valid checkpoint the state of charge is taken
+ *          from the cell voltages on the first SOC_Step
+ *
+ * @param pack_config pack configuration
+ * @param msTicks current time
+ */
+void SOC_Config(PACK_CONFIG_T *pack_config, uint32_t msTicks);
+
+/**
+ * @details integrate pack current since the last call. Charge mode counts
+ *          current into the pack, discharge mode out of it. After
+ *          SOC_REST_TIME_ms without current the estimate is reset from the
+ *          average cell voltage. A current measured more than
+ *          SOC_CURRENT_MAX_AGE_ms ago is neither integrated nor counted as
+ *          rest. Queues a checkpoint every
+ *          SOC_CHECKPOINT_PERIOD_ms if the estimate moved
+ *
+ * @param pack_status pack current and cell voltages
+ * @param mode current BMS mode
+ * @param msTicks current time
+ */
+void SOC_Step(const BMS_PACK_STATUS_T *pack_status, BMS_SSM_MODE_T mode, uint32_t msTicks);
+
+/**
+ * @details state of charge of a cell at rest
+ *
+ * @param cell_mV open circuit cell voltage
+ * @return state of charge in hundredths of a percent
+ */
+uint16_t SOC_FromOcv_cpct(uint32_t cell_mV);
+
+/**
+ * @return state of charge in hundredths of a percent, 0 if unknown
+ */
+uint16_t SOC_Estimate_cpct(void);
+
+/**
+ * @return state of charge in percent, 0 if unknown
+ */
 uint32_t SOC_Estimate(void);
+
+bool SOC_Valid(void);
+
 #endif
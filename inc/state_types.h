@@ -20,6 +20,10 @@ typedef struct {
     
     uint32_t cell_discharge_c_rating_cC; // at 27 degrees C
     uint32_t max_cell_temp_dC;
+    // adaptive sampling thresholds (see sampling.h), 0 disables
+    uint32_t sample_fast_current_mA;
+    uint32_t sample_fast_margin_mV;
+    uint32_t sample_fast_dvdt_mV_s;
     // FSAE specific configurations
 #ifdef FSAE_DRIVERS
     int16_t min_cell_temp_dC;
@@ -27,17 +31,31 @@ typedef struct {
 #endif //FSAE_DRIVERS
 
     uint8_t *module_cell_count;
-    // Total Size = 44 + 4 + 4 + 1= 53 bytes (not including fan_on_threshold)
+    // Total Size = 44 + 4 + 4 + 12 + 1 = 65 bytes (not including fan_on_threshold)
     
 } PACK_CONFIG_T;
 
 typedef struct BMS_PACK_STATUS {
     uint32_t *cell_voltages_mV; // array size = #modules * cells/module
+    uint32_t *cell_voltages_raw_mV; // latest readback, before the cell filter
+    uint32_t cell_voltages_ms; // when the cells were sampled (see gcv_pipeline.h)
+    int32_t cell_voltages_current_mA; // pack current at cell_voltages_ms, positive out of the pack (see sample_sync.h)
     int16_t *cell_temperatures_dC; // array size = #modules * thermistors/module
+    uint32_t cell_temperatures_ms; // when the last thermistor was read
     uint32_t pack_cell_max_mV;
     uint32_t pack_cell_min_mV;
     uint32_t pack_current_mA;
+    uint32_t pack_current_ms; // when pack_current_mA was measured
     uint32_t pack_voltage_mV;
+    uint32_t pack_voltage_ms; // when pack_voltage_mV was measured
+    uint32_t pack_cell_sum_mV; // sum of the raw readback, what pack_voltage_mV should read
+    uint32_t avg_cell_voltage_mV;
+    uint16_t max_cell_voltage_position; //range: 0-MAX_NUM_MODULES*MAX_CELLS_PER_MODULE
+    uint16_t min_cell_voltage_position; //range: 0-MAX_NUM_MODULES*MAX_CELLS_PER_MODULE
+    uint32_t max_cell_sag_mV_s; // lowest cell's fall less the pack average's (see cell_history.h)
+    uint16_t max_cell_sag_position; //range: 0-MAX_NUM_MODULES*MAX_CELLS_PER_MODULE
+    uint16_t *cell_ir_uOhm; // array size = #modules * cells/module, 0 = unknown (see cell_ir.h)
+    uint32_t cell_ir_limit_mA; // discharge current that keeps every cell above cell_min_mV
     int16_t max_cell_temp_dC;
 
     //FSAE specific pack status variables
@@ -162,7 +180,7 @@ typedef struct BMS_CHARGE_REQ {
 typedef struct BMS_OUTPUT {
     BMS_CHARGE_REQ_T *charge_req;
     bool close_contactors;
-    bool *balance_req;
+    uint16_t *balance_req; // one word per module, bit i bleeds the module's cell i
 
     // for bms initialization
     bool read_eeprom_packconfig;
@@ -0,0 +1,70 @@
+#ifndef _TELEMETRY_H
+#define _TELEMETRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Binary measurement frames for the UART, one module per frame:
+//   type (u8), msTicks (u32), module (u8), count (u8), first value (u16),
+//   then count-1 deltas from the previous value, zigzag varint encoded,
+//   then CRC-16/CCITT (u16) over everything before it.
+// Multi-byte fields are little endian. The frame is COBS encoded and
+// ends in a 0x00, which never appears in console text, so a decoder can
+// resync after text lands in the middle of a frame. scripts/decode_telemetry.py
+// is the host side
+#define TELEMETRY_TYPE_VOLTAGES 0x01        // mV
+#define TELEMETRY_TYPE_TEMPERATURES 0x02    // dC, signed
+
+#define TELEMETRY_MAX_VALUES 24
+// header, first value, worst case 3 byte deltas, CRC
+#define TELEMETRY_MAX_PAYLOAD (9 + 3*(TELEMETRY_MAX_VALUES-1) + 2)
+// COBS adds one byte per 254, plus the delimiter
+#define TELEMETRY_MAX_FRAME (TELEMETRY_MAX_PAYLOAD + 2)
+
+// frames wait here until the UART ring has room
+#define TELEMETRY_BUFFER_SIZE 128
+
+typedef uint32_t (*TELEMETRY_WRITE_T)(const char *data, uint32_t count);
+
+void Telemetry_Init(void);
+
+/**
+ * @details queue one module of cell voltages
+ *
+ * @param msTicks time of the measurement
+ * @param module module index
+ * @param cell_voltages_mV first cell of the module
+ * @param count cells in the module, at most TELEMETRY_MAX_VALUES
+ * @return false if the buffer is too full, nothing is queued then
+ */
+bool Telemetry_QueueVoltages(uint32_t msTicks, uint8_t module,
+        const uint32_t *cell_voltages_mV, uint8_t count);
+
+/**
+ * @details queue one module of thermistor temperatures
+ *
+ * @return false if the buffer is too full, nothing is queued then
+ */
+bool Telemetry_QueueTemperatures(uint32_t msTicks, uint8_t module,
+        const int16_t *cell_temperatures_dC, uint8_t count);
+
+/**
+ * @details hand queued bytes to write until it takes no more
+ *
+ * @param write non-blocking write, returns bytes taken
+ * @return bytes written
+ */
+uint32_t Telemetry_Drain(TELEMETRY_WRITE_T write);
+
+uint16_t Telemetry_Pending(void);
+
+uint16_t Telemetry_Crc16(const uint8_t *data, uint16_t len);
+
+/**
+ * @details COBS encode src, without the 0x00 delimiter
+ *
+ * @return encoded length, at most len + len/254 + 1
+ */
+uint16_t Telemetry_CobsEncode(const uint8_t *src, uint16_t len, uint8_t *dst);
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef _THERMISTOR_H
+#define _THERMISTOR_H
+
+#include <stdint.h>
+
+// Thermistor GPIO voltage to temperature, by linear interpolation in
+// inc/thermistor_table.h. The table is generated from the thermistor and
+// divider parts by scripts/gen_thermistor_table.py (`make thermistor_table`)
+// and its breakpoints are a power of two mV apart, so a conversion is a
+// shift, a mask, one multiply and two table reads, about three times the
+// cost of the old linear fit's single shift. Until the parts are known the
+// table holds that fit, mV/4 - 39.
+
+/**
+ * @param voltage_mV thermistor divider voltage
+ * @return temperature in dC, clamped to the table's range
+ */
+int16_t Thermistor_Temperature_dC(uint32_t voltage_mV);
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef _THERMISTOR_SCAN_H
+#define _THERMISTOR_SCAN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Picks which thermistor to read next. The multiplexer selects the same
+// thermistor on every module, so each thermistor is scored by its hottest
+// reading across the modules.
+//
+// Every thermistor ages by one each time another one is read. The next one
+// read is the one with the highest age * weight, where the weight starts at
+// 1 and grows with temperature above THERMISTOR_SCAN_HOT_dC and with how
+// fast the reading is rising, up to THERMISTOR_SCAN_MAX_WEIGHT. Hot or
+// heating thermistors come round up to MAX_WEIGHT times as often, and none
+// waits more than THERMISTOR_SCAN_MAX_AGE reads.
+
+#define THERMISTOR_SCAN_MAX_AGE 48          // reads, two plain sweeps
+#define THERMISTOR_SCAN_MAX_WEIGHT 8
+#define THERMISTOR_SCAN_HOT_dC 300          // weight +1 per STEP above this
+#define THERMISTOR_SCAN_HOT_STEP_dC 50
+#define THERMISTOR_SCAN_RISE_STEP_dC_s 1    // weight +1 per step of rise
+#define THERMISTOR_SCAN_RISE_WINDOW_ms 1000 // shortest time a rise is measured over
+
+/**
+ * @details forget every reading, the first sweep goes in order
+ *
+ * @param num_thermistors thermistors per module, at most MAX_THERMISTORS_PER_MODULE
+ */
+void ThermistorScan_Init(uint8_t num_thermistors);
+
+/**
+ * @return the thermistor to read next
+ */
+uint8_t ThermistorScan_Next(void);
+
+/**
+ * @details record a reading and age every other thermistor
+ *
+ * @param thermistor thermistor that was read
+ * @param cell_temperatures_dC pack wide array of thermistor temperatures,
+ *                             already holding the new reading
+ * @param num_modules modules in the pack
+ */
+void ThermistorScan_Record(uint8_t thermistor, const int16_t *cell_temperatures_dC,
+        uint8_t num_modules, uint32_t msTicks);
+
+uint8_t ThermistorScan_GetWeight(uint8_t thermistor);
+
+#endif
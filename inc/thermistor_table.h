@@ -0,0 +1,25 @@
+// Generated by scripts/gen_thermistor_table.py, do not edit.
+// Linear fit temp_dC = mV*0.25 - 39, up to 3000 mV.
+// Worst interpolation error from -20 C to 80 C: 0.5 dC
+
+#ifndef _THERMISTOR_TABLE_H
+#define _THERMISTOR_TABLE_H
+
+#include <stdint.h>
+
+#define THERMISTOR_TABLE_SHIFT 6
+#define THERMISTOR_TABLE_LEN 48
+#define THERMISTOR_TABLE_MIN_dC -400
+#define THERMISTOR_TABLE_MAX_dC 1250
+
+// temperature (dC) at every 64 mV, starting at 0 mV
+static const int16_t thermistor_table_dC[THERMISTOR_TABLE_LEN] = {
+      -39,   -23,    -7,     9,    25,    41,    57,    73,
+       89,   105,   121,   137,   153,   169,   185,   201,
+      217,   233,   249,   265,   281,   297,   313,   329,
+      345,   361,   377,   393,   409,   425,   441,   457,
+      473,   489,   505,   521,   537,   553,   569,   585,
+      601,   617,   633,   649,   665,   681,   697,   713,
+};
+
+#endif
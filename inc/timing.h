@@ -0,0 +1,95 @@
+#ifndef _TIMING_H
+#define _TIMING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Histogram bucket b counts durations in [2^(b-1), 2^b - 1] us, bucket 0 counts
+// 0 us and the last bucket counts everything from 2^(TIMING_NUM_BUCKETS-2) us up
+#define TIMING_NUM_BUCKETS 16
+
+// Main loop stages that are timed, in the order they run
+typedef enum {
+    TIMING_STAGE_KEYBOARD,
+    TIMING_STAGE_INPUT,
+    TIMING_STAGE_SCHEDULER,
+    TIMING_STAGE_SSM,
+    TIMING_STAGE_OUTPUT,
+    TIMING_STAGE_ERROR,
+    TIMING_STAGE_LOOP, // whole loop, start to start
+    TIMING_NUM_STAGES
+} TIMING_STAGE_T;
+
+static const char * const TIMING_STAGE_NAMES[TIMING_NUM_STAGES] = {
+    "keyboard",
+    "input",
+    "scheduler",
+    "ssm",
+    "output",
+    "error",
+    "loop"
+};
+
+typedef struct {
+    uint16_t buckets[TIMING_NUM_BUCKETS];
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+} TIMING_STATS_T;
+
+/**
+ * @details clear all stage histograms and the loop budget overrun count
+ */
+void Timing_Init(void);
+
+/**
+ * @details mark the start of a main loop iteration. Records the length of the
+ *          previous iteration under TIMING_STAGE_LOOP
+ */
+void Timing_LoopStart(void);
+
+/**
+ * @details mark the end of a stage. Records the time since the previous mark
+ *          (or loop start) under stage
+ *
+ * @param stage stage that just finished
+ */
+void Timing_Mark(TIMING_STAGE_T stage);
+
+/**
+ * @details add a single duration to a stage histogram
+ *
+ * @param stage stage to record under
+ * @param duration_us duration of the stage in microseconds
+ */
+void Timing_Record(TIMING_STAGE_T stage, uint32_t duration_us);
+
+const TIMING_STATS_T * Timing_GetStats(TIMING_STAGE_T stage);
+
+/**
+ * @details estimate a percentile of a stage from its histogram. Returns the
+ *          upper edge of the bucket holding the percentile, capped at the
+ *          largest duration seen
+ *
+ * @param stage stage to query
+ * @param pct percentile, 1 to 100
+ * @return percentile in microseconds, 0 if nothing has been recorded
+ */
+uint32_t Timing_Percentile_us(TIMING_STAGE_T stage, uint8_t pct);
+
+/**
+ * @details number of main loop iterations longer than TIMING_LOOP_BUDGET_us
+ */
+uint32_t Timing_GetLoopOverruns(void);
+
+/**
+ * @details pack the next stage summary, round robin over all stages, into a
+ *          CAN payload: {stage, min_us, max_us, p99_us, overruns}, with the
+ *          times as saturated little-endian uint16 and overruns saturated to 255
+ *
+ * @param data mutable 8 byte CAN payload
+ * @return payload length in bytes
+ */
+uint8_t Timing_PackCanFrame(uint8_t *data);
+
+#endif
@@ -0,0 +1,108 @@
+import sys
+import struct
+
+# Decodes the binary measurement frames from "measure binary" (see
+# inc/telemetry.h) out of a raw UART log. Console text between frames is
+# skipped, frames that fail the CRC are counted and dropped.
+
+TYPE_VOLTAGES = 0x01
+TYPE_TEMPERATURES = 0x02
+
+if len(sys.argv) != 4:
+    print("Requires three arguments: read-file-log.txt voltages-filename.csv temps-filename.csv")
+    sys.exit(1)
+
+read_file = sys.argv[1]
+voltages_file = sys.argv[2]
+temps_file = sys.argv[3]
+
+def crc16(data):
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            if crc & 0x8000:
+                crc = ((crc << 1) ^ 0x1021) & 0xFFFF
+            else:
+                crc = (crc << 1) & 0xFFFF
+    return crc
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            return None
+        out += data[i+1:i+code]
+        i += code
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+def read_varint(data, pos):
+    val = 0
+    shift = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        val |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            break
+    # zigzag
+    return (val >> 1) ^ -(val & 1), pos
+
+def decode_frame(payload):
+    if len(payload) < 11 or crc16(payload[:-2]) != struct.unpack('<H', payload[-2:])[0]:
+        return None
+    frame_type, ms, module, count, first = struct.unpack('<BIBBH', payload[:9])
+    if frame_type == TYPE_TEMPERATURES and first >= 0x8000:
+        first -= 0x10000
+    values = [first]
+    pos = 9
+    for _ in range(count - 1):
+        delta, pos = read_varint(payload, pos)
+        values.append(values[-1] + delta)
+    if pos != len(payload) - 2:
+        return None
+    return frame_type, ms, module, values
+
+with open(read_file, 'rb') as f:
+    raw = f.read()
+
+voltage_lines = []
+temp_lines = []
+bad_frames = 0
+
+# the chunk before the first delimiter may start mid-frame, and text
+# printed before a frame ends up in front of it
+for chunk in raw.split(b'\x00')[:-1]:
+    frame = None
+    # look for the start of the frame after any console text
+    for start in range(len(chunk)):
+        payload = cobs_decode(chunk[start:])
+        if payload is not None:
+            frame = decode_frame(payload)
+            if frame is not None:
+                break
+    if frame is None:
+        if chunk:
+            bad_frames += 1
+        continue
+    frame_type, ms, module, values = frame
+    if frame_type == TYPE_VOLTAGES:
+        voltage_lines.append(",".join(map(str, [ms, module] + [v/1000.0 for v in values])))
+    elif frame_type == TYPE_TEMPERATURES:
+        temp_lines.append(",".join(map(str, [ms, module] + [v/10.0 for v in values])))
+
+print("Decoded", len(voltage_lines), "voltage and", len(temp_lines), "temperature frames,",
+        bad_frames, "dropped")
+with open(temps_file, 'w') as f:
+    print("Writing temperatures to file",temps_file)
+    for line in temp_lines:
+        f.write(line + "\n")
+with open(voltages_file, 'w') as f:
+    print("Writing voltages to file",voltages_file)
+    for line in voltage_lines:
+        f.write(line + "\n")
@@ -0,0 +1,111 @@
+import argparse
+import math
+
+# Generates inc/thermistor_table.h, the thermistor voltage -> temperature
+# lookup table used by src/thermistor.c. Run `make thermistor_table` after
+# changing the thermistor or divider parts.
+#
+# By default the table reproduces the linear fit the firmware has always
+# used, temp_dC = mV/4 - 39, the only calibration on record. Once the
+# thermistor and divider parts are known, pass --beta or --sh instead.
+#
+# The NTC sits on the high side of a divider from the LTC6804 VREF2, the
+# fixed resistor on the low side, so the GPIO voltage rises with temperature:
+#   V = Vref * R_fixed / (R_fixed + R_ntc)
+# R_ntc follows the Beta model, or Steinhart-Hart if coefficients are given:
+#   1/T = 1/T0 + ln(R/R0)/B
+#   1/T = A + B*ln(R) + C*ln(R)^3
+
+KELVIN = 273.15
+
+parser = argparse.ArgumentParser()
+parser.add_argument("--r0", type=float, default=10000.0, help="NTC resistance at t0 (ohm)")
+parser.add_argument("--t0", type=float, default=25.0, help="NTC reference temperature (C)")
+parser.add_argument("--linear", type=float, nargs=2, metavar=("SCALE", "OFFSET"),
+        default=[0.25, -39.0], help="temp_dC = mV*SCALE + OFFSET, used unless --beta or --sh")
+parser.add_argument("--beta", type=float, help="NTC Beta (K)")
+parser.add_argument("--sh", type=float, nargs=3, metavar=("A", "B", "C"),
+        help="Steinhart-Hart coefficients, overrides --beta")
+parser.add_argument("--r-fixed", type=float, default=10000.0, help="low side resistor (ohm)")
+parser.add_argument("--vref", type=float, default=3000.0, help="divider supply (mV)")
+parser.add_argument("--shift", type=int, default=6, help="log2 of the breakpoint spacing (mV)")
+parser.add_argument("--min-dc", type=int, default=-400, help="clamp below (dC)")
+parser.add_argument("--max-dc", type=int, default=1250, help="clamp above (dC)")
+args = parser.parse_args()
+
+def ntc_dC(resistance):
+    if args.sh:
+        a, b, c = args.sh
+        ln_r = math.log(resistance)
+        inv_t = a + b*ln_r + c*ln_r**3
+    else:
+        inv_t = 1.0/(args.t0 + KELVIN) + math.log(resistance/args.r0)/args.beta
+    return (1.0/inv_t - KELVIN) * 10
+
+ntc = args.sh is not None or args.beta is not None
+
+def temperature_dC(voltage_mV):
+    if not ntc:
+        scale, offset = args.linear
+        return min(max(voltage_mV * scale + offset, args.min_dc), args.max_dc)
+    if voltage_mV <= 0:
+        return float(args.min_dc)
+    if voltage_mV >= args.vref:
+        return float(args.max_dc)
+    r_ntc = args.r_fixed * (args.vref - voltage_mV) / voltage_mV
+    return min(max(ntc_dC(r_ntc), args.min_dc), args.max_dc)
+
+step = 1 << args.shift
+# last breakpoint at or past vref, readings above it clamp to it
+count = int(math.ceil(args.vref / step)) + 1
+table = [int(round(temperature_dC(i * step))) for i in range(count)]
+
+for i in range(1, count):
+    if table[i] < table[i-1]:
+        raise SystemExit("table is not monotonic at %d mV" % (i * step))
+
+def interpolate(voltage_mV):
+    i = voltage_mV >> args.shift
+    if i >= count - 1:
+        return table[-1]
+    frac = voltage_mV & (step - 1)
+    return table[i] + (((table[i+1] - table[i]) * frac + step//2) >> args.shift)
+
+# worst interpolation error where the clamps are out of the way
+worst = 0.0
+for v in range(1, int(args.vref)):
+    exact = temperature_dC(v)
+    if -200 <= exact <= 800:
+        worst = max(worst, abs(interpolate(v) - exact))
+
+print("// Generated by scripts/gen_thermistor_table.py, do not edit.")
+if not ntc:
+    scale, offset = args.linear
+    print("// Linear fit temp_dC = mV*%g %s %g, up to %g mV." %
+            (scale, "-" if offset < 0 else "+", abs(offset), args.vref))
+else:
+    if args.sh:
+        spec = "Steinhart-Hart A=%g B=%g C=%g" % tuple(args.sh)
+    else:
+        spec = "R0=%g ohm at %g C, Beta=%g K" % (args.r0, args.t0, args.beta)
+    print("// NTC %s, high side of a divider with" % spec)
+    print("// %g ohm to ground, supplied from %g mV." % (args.r_fixed, args.vref))
+print("// Worst interpolation error from -20 C to 80 C: %.1f dC" % worst)
+print("")
+print("#ifndef _THERMISTOR_TABLE_H")
+print("#define _THERMISTOR_TABLE_H")
+print("")
+print("#include <stdint.h>")
+print("")
+print("#define THERMISTOR_TABLE_SHIFT %d" % args.shift)
+print("#define THERMISTOR_TABLE_LEN %d" % count)
+print("#define THERMISTOR_TABLE_MIN_dC %d" % args.min_dc)
+print("#define THERMISTOR_TABLE_MAX_dC %d" % args.max_dc)
+print("")
+print("// temperature (dC) at every %d mV, starting at 0 mV" % step)
+print("static const int16_t thermistor_table_dC[THERMISTOR_TABLE_LEN] = {")
+for i in range(0, count, 8):
+    print("    " + " ".join("%5d," % t for t in table[i:i+8]))
+print("};")
+print("")
+print("#endif")
@@ -0,0 +1,162 @@
+#include "pack_model.h"
+#include "bms_utils.h"
+#include "pack_stats.h"
+
+// NMC-like open-circuit voltage curve, 10% state of charge steps
+#define OCV_TABLE_LEN 11
+static const double ocv_table_V[OCV_TABLE_LEN] = {
+    3.000, 3.450, 3.550, 3.620, 3.680, 3.740, 3.810, 3.900, 3.990, 4.090, 4.200
+};
+
+// Per-cell DC resistance and thermal parameters of a single 18650-class cell
+#define CELL_RESISTANCE_OHM         0.030
+#define CELL_SELF_DISCHARGE_A       0.00002
+#define CELL_HEAT_CAPACITY_J_PER_K  45.0
+#define CELL_COOLING_W_PER_K        0.05
+
+// Cells may be driven past 100% state of charge, up to OVERCHARGE_MAX_PCT
+#define OVERCHARGE_V_PER_PCT        0.03
+#define OVERCHARGE_MAX_PCT          105.0
+
+/**
+ * @details cheap deterministic pseudo-random spread in [-0.5, 0.5] so that
+ *          simulator runs are reproducible between builds
+ */
+static double Spread(uint16_t cell, uint16_t salt) {
+    uint32_t x = (cell + 1) * 2654435761u ^ (salt * 40503u);
+    x ^= x >> 13;
+    x *= 0x5bd1e995;
+    x ^= x >> 15;
+    return ((double)(x & 0xFFFF) / 65535.0) - 0.5;
+}
+
+static double Clamp(double val, double min, double max) {
+    if (val < min) return min;
+    if (val > max) return max;
+    return val;
+}
+
+void PackModel_Init(PACK_MODEL_T *model, PACK_CONFIG_T *pack_config,
+        double soc_pct, double soc_spread_pct) {
+    uint16_t i;
+    double p = pack_config->pack_cells_p;
+    double cell_capacity_As = pack_config->cell_capacity_cAh * 36.0; // cAh -> As
+
+    model->num_cells = Get_Total_Cell_Count(pack_config);
+    model->ambient_C = 25.0;
+    model->charge_in_As = 0;
+    model->charge_out_As = 0;
+    model->balance_As = 0;
+    model->last_current_A = 0;
+
+    // Matched cells: +-0.5% capacity, +-2.5% resistance. The charger regulates
+    // pack voltage only, so larger mismatches push the leading cell past
+    // cell_max_mV in CV faster than the balance resistors can bleed it
+    for (i = 0; i < model->num_cells; i++) {
+        PACK_MODEL_CELL_T *cell = &model->cells[i];
+        cell->capacity_As = cell_capacity_As * p * (1.0 + 0.01 * Spread(i, 1));
+        cell->resistance_ohm = CELL_RESISTANCE_OHM / p * (1.0 + 0.05 * Spread(i, 2));
+        cell->self_discharge_A = CELL_SELF_DISCHARGE_A * p * (1.0 + Spread(i, 3));
+        cell->heat_capacity_J_per_K = CELL_HEAT_CAPACITY_J_PER_K * p;
+        cell->cooling_W_per_K = CELL_COOLING_W_PER_K * p;
+        cell->temp_C = model->ambient_C;
+
+        double soc = Clamp(soc_pct + soc_spread_pct * Spread(i, 4), 0, 100);
+        cell->charge_As = cell->capacity_As * soc / 100.0;
+    }
+}
+
+double PackModel_CellSoc_pct(const PACK_MODEL_CELL_T *cell) {
+    return 100.0 * cell->charge_As / cell->capacity_As;
+}
+
+double PackModel_CellOcv_V(const PACK_MODEL_CELL_T *cell) {
+    double soc = PackModel_CellSoc_pct(cell);
+    if (soc >= 100.0) {
+        // overcharge: voltage climbs steeply so a control failure trips OV
+        return ocv_table_V[OCV_TABLE_LEN - 1] + (soc - 100.0) * OVERCHARGE_V_PER_PCT;
+    }
+    double pos = Clamp(soc, 0, 100) / 10.0;
+    int idx = (int)pos;
+    return ocv_table_V[idx] + (ocv_table_V[idx + 1] - ocv_table_V[idx]) * (pos - idx);
+}
+
+double PackModel_CellVoltage_V(const PACK_MODEL_T *model, uint16_t cell) {
+    const PACK_MODEL_CELL_T *c = &model->cells[cell];
+    return PackModel_CellOcv_V(c) + model->last_current_A * c->resistance_ohm;
+}
+
+double PackModel_PackOcv_V(const PACK_MODEL_T *model) {
+    double sum = 0;
+    uint16_t i;
+    for (i = 0; i < model->num_cells; i++) {
+        sum += PackModel_CellOcv_V(&model->cells[i]);
+    }
+    return sum;
+}
+
+double PackModel_PackResistance_ohm(const PACK_MODEL_T *model) {
+    double sum = 0;
+    uint16_t i;
+    for (i = 0; i < model->num_cells; i++) {
+        sum += model->cells[i].resistance_ohm;
+    }
+    return sum;
+}
+
+void PackModel_Step(PACK_MODEL_T *model, double pack_current_A,
+        const uint16_t *balance_req, PACK_CONFIG_T *pack_config, uint32_t dt_ms) {
+    double dt_s = dt_ms / 1000.0;
+    uint16_t i;
+
+    model->last_current_A = pack_current_A;
+    if (pack_current_A > 0) {
+        model->charge_in_As += pack_current_A * dt_s;
+    } else {
+        model->charge_out_As -= pack_current_A * dt_s;
+    }
+
+    for (i = 0; i < model->num_cells; i++) {
+        PACK_MODEL_CELL_T *cell = &model->cells[i];
+        double cell_current_A = pack_current_A - cell->self_discharge_A;
+        double heat_W = pack_current_A * pack_current_A * cell->resistance_ohm;
+
+        if (Is_Cell_Balancing(balance_req, pack_config, i)) {
+            double bleed_A = PackModel_CellOcv_V(cell) / PACK_MODEL_BALANCE_R_OHM;
+            cell_current_A -= bleed_A;
+            model->balance_As += bleed_A * dt_s;
+        }
+
+        cell->charge_As = Clamp(cell->charge_As + cell_current_A * dt_s, 0,
+                cell->capacity_As * OVERCHARGE_MAX_PCT / 100.0);
+
+        heat_W -= (cell->temp_C - model->ambient_C) * cell->cooling_W_per_K;
+        cell->temp_C += heat_W * dt_s / cell->heat_capacity_J_per_K;
+    }
+}
+
+void PackModel_Sample(const PACK_MODEL_T *model, BMS_PACK_STATUS_T *pack_status,
+        PACK_CONFIG_T *pack_config) {
+    uint16_t i;
+    for (i = 0; i < model->num_cells; i++) {
+        pack_status->cell_voltages_mV[i] =
+                (uint32_t)(PackModel_CellVoltage_V(model, i) * 1000.0 + 0.5);
+    }
+    PackStats_UpdateVoltages(pack_status, pack_config->num_modules,
+            pack_config->module_cell_count);
+
+    // one thermistor per cell position, spread over the module's thermistors
+    uint8_t module;
+    uint16_t cell_offset = 0;
+    for (module = 0; module < pack_config->num_modules; module++) {
+        uint8_t cells = pack_config->module_cell_count[module];
+        uint8_t t;
+        for (t = 0; t < MAX_THERMISTORS_PER_MODULE; t++) {
+            uint16_t cell = cell_offset + (t * cells) / MAX_THERMISTORS_PER_MODULE;
+            PackStats_UpdateTemperature(pack_status->cell_temperatures_dC, module, t,
+                    (int16_t)(model->cells[cell].temp_C * 10.0));
+        }
+        cell_offset += cells;
+    }
+    PackStats_WriteTemperatures(pack_status, pack_config->num_modules);
+}
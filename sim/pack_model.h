@@ -0,0 +1,99 @@
+/**
+ * @file pack_model.h
+ * @brief Host-side electrical/thermal model of a battery pack, used by the
+ *        closed-loop pack simulator to drive the real SSM faster than real time
+ */
+
+#ifndef _PACK_MODEL_H
+#define _PACK_MODEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "config.h"
+#include "state_types.h"
+
+#define PACK_MODEL_MAX_CELLS (MAX_NUM_MODULES*MAX_CELLS_PER_MODULE)
+
+// Passive balancing bleed resistor across each cell group (LTC6804 DCC FET + resistor)
+#define PACK_MODEL_BALANCE_R_OHM 33.0
+
+typedef struct {
+    double capacity_As;         // capacity of the parallel cell group
+    double charge_As;           // charge currently stored in the group
+    double resistance_ohm;      // DC internal resistance of the group
+    double self_discharge_A;    // leakage current
+    double temp_C;
+    double heat_capacity_J_per_K;
+    double cooling_W_per_K;     // heat transfer to ambient
+} PACK_MODEL_CELL_T;
+
+typedef struct {
+    PACK_MODEL_CELL_T cells[PACK_MODEL_MAX_CELLS];
+    uint16_t num_cells;
+    double ambient_C;
+
+    // accumulated statistics
+    double charge_in_As;        // charge delivered by the charger
+    double charge_out_As;       // charge delivered to the load
+    double balance_As;          // charge burned in balance resistors
+    double last_current_A;      // positive while charging
+} PACK_MODEL_T;
+
+/**
+ * @details initialize a pack of series cell groups described by pack_config.
+ *          Each group gets a small deterministic spread in capacity,
+ *          resistance, leakage and starting state of charge
+ *
+ * @param model model to initialize
+ * @param pack_config pack configuration (cell count, capacity, parallel count)
+ * @param soc_pct average starting state of charge in percent
+ * @param soc_spread_pct peak-to-peak starting state of charge spread in percent
+ */
+void PackModel_Init(PACK_MODEL_T *model, PACK_CONFIG_T *pack_config,
+        double soc_pct, double soc_spread_pct);
+
+/**
+ * @details advance the model by dt_ms milliseconds
+ *
+ * @param model pack model
+ * @param pack_current_A current into the pack terminals (positive = charging)
+ * @param balance_req one word per module, bit i set if the module's cell
+ *                    group i is being bled
+ * @param pack_config pack configuration (cells per module)
+ * @param dt_ms time step in milliseconds
+ */
+void PackModel_Step(PACK_MODEL_T *model, double pack_current_A,
+        const uint16_t *balance_req, PACK_CONFIG_T *pack_config, uint32_t dt_ms);
+
+/**
+ * @details open-circuit voltage of a cell group
+ */
+double PackModel_CellOcv_V(const PACK_MODEL_CELL_T *cell);
+
+/**
+ * @details terminal voltage of a cell group at the last applied current
+ */
+double PackModel_CellVoltage_V(const PACK_MODEL_T *model, uint16_t cell);
+
+/**
+ * @details sum of cell group open-circuit voltages and resistances, used
+ *          by the charger and load models to solve for the pack current
+ */
+double PackModel_PackOcv_V(const PACK_MODEL_T *model);
+double PackModel_PackResistance_ohm(const PACK_MODEL_T *model);
+
+/**
+ * @details state of charge of a cell group in percent
+ */
+double PackModel_CellSoc_pct(const PACK_MODEL_CELL_T *cell);
+
+/**
+ * @details write the sampled (quantized) cell voltages and temperatures into
+ *          pack_status and update the pack statistics the same way the
+ *          LTC6804 readback does
+ */
+void PackModel_Sample(const PACK_MODEL_T *model, BMS_PACK_STATUS_T *pack_status,
+        PACK_CONFIG_T *pack_config);
+
+#endif
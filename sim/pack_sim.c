@@ -0,0 +1,422 @@
+/**
+ * @file pack_sim.c
+ * @brief Closed-loop pack simulator. Runs the real SSM/charge/discharge/error
+ *        handling code (TEST_HARDWARE build) against PACK_MODEL_T through a full
+ *        charge -> balance -> discharge cycle, faster than real time, then
+ *        a balance-only scenario with an imbalance seeded on purpose.
+ *
+ *        Exits non-zero if the control loop halts or misses the cycle time /
+ *        balancing limits below, so `make sim` can gate every build.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "ssm.h"
+#include "board.h"
+#include "error_handler.h"
+#include "bms_utils.h"
+#include "pack_stats.h"
+#include "pack_model.h"
+
+#define SIM_TICK_MS         10  // main loop period
+#define SIM_LTC_SAMPLE_MS   100 // cell voltage/temperature sample period
+#define SIM_STATUS_PERIOD_MS (10*60*1000)
+
+// Pack under test: 6 modules of 12 cells, 4P of 2.5 Ah cells
+#define SIM_NUM_MODULES         6
+#define SIM_CELLS_PER_MODULE    12
+#define SIM_START_SOC_pct       20.0
+#define SIM_START_SOC_SPREAD_pct 2.0
+#define SIM_DISCHARGE_STOP_MARGIN_mV 150 // VCU stops drawing this far above cell_min
+#define SIM_DISCHARGE_PULSE_PERIOD_ms 60000
+#define SIM_DISCHARGE_PULSE_ms  10000
+// Balance-only scenario: a matched pack low on charge, where the OCV curve
+// is steep, with one cell group per module SEED above the rest (about 11 mV,
+// far more than charge-time balancing leaves)
+#define SIM_BALANCE_SOC_pct     5.0
+#define SIM_BALANCE_SEED_pct    0.25
+
+// Regression limits
+#define SIM_MAX_CHARGE_ms       (3UL*3600*1000)
+#define SIM_MAX_BALANCE_ms      (1UL*3600*1000)
+#define SIM_MAX_DISCHARGE_ms    (2UL*3600*1000)
+#define SIM_MAX_BALANCED_SPREAD_mV 10
+
+extern volatile uint32_t msTicks;
+
+// memory allocation for BMS_OUTPUT_T
+static uint16_t balance_reqs[MAX_NUM_MODULES];
+static BMS_CHARGE_REQ_T charge_req;
+static BMS_OUTPUT_T bms_output;
+
+// memory allocation for BMS_INPUT_T
+static BMS_PACK_STATUS_T pack_status;
+static BMS_INPUT_T bms_input;
+
+// memory allocation for BMS_STATE_T
+static BMS_CHARGER_STATUS_T charger_status;
+static uint32_t cell_voltages[MAX_NUM_MODULES*MAX_CELLS_PER_MODULE];
+static int16_t cell_temperatures[MAX_NUM_MODULES*MAX_THERMISTORS_PER_MODULE];
+static uint8_t module_cell_count[MAX_NUM_MODULES];
+static PACK_CONFIG_T pack_config;
+static BMS_STATE_T bms_state;
+
+static PACK_MODEL_T model;
+static bool verbose;
+static bool halted;
+static double load_current_A;
+static uint32_t last_sample_ms;
+static uint32_t last_status_ms;
+
+/****************************
+ *     INITIALIZERS
+ ****************************/
+
+static void Sim_Load_PackConfig(PACK_CONFIG_T *config) {
+    uint8_t i;
+    config->cell_min_mV = 3000;
+    config->cell_max_mV = 4200;
+    config->cell_capacity_cAh = 250;
+    config->num_modules = SIM_NUM_MODULES;
+    config->cell_charge_c_rating_cC = 50;
+    config->bal_on_thresh_mV = 4;
+    config->bal_off_thresh_mV = 1;
+    config->pack_cells_p = 4;
+    config->cv_min_current_mA = 100;
+    config->cv_min_current_ms = 60000;
+    config->cc_cell_voltage_mV = 4300;
+    config->cell_discharge_c_rating_cC = 200;
+    config->max_cell_temp_dC = 600;
+#ifdef FSAE_DRIVERS
+    config->min_cell_temp_dC = -30;
+    config->fan_on_threshold_dC = 450;
+#endif
+    for (i = 0; i < MAX_NUM_MODULES; i++) {
+        config->module_cell_count[i] = SIM_CELLS_PER_MODULE;
+    }
+}
+
+static void Sim_Init_BMS_Structs(void) {
+    bms_output.charge_req = &charge_req;
+    bms_output.close_contactors = false;
+    bms_output.balance_req = balance_reqs;
+    memset(balance_reqs, 0, sizeof(balance_reqs));
+    bms_output.read_eeprom_packconfig = false;
+    bms_output.check_packconfig_with_ltc = false;
+#ifdef FSAE_DRIVERS
+    bms_output.fans_on = false;
+#endif
+
+    charge_req.charger_on = false;
+    charge_req.charge_current_mA = 0;
+    charge_req.charge_voltage_mV = 0;
+
+    bms_state.charger_status = &charger_status;
+    bms_state.pack_config = &pack_config;
+    charger_status.connected = false;
+    charger_status.error = false;
+
+    pack_config.module_cell_count = module_cell_count;
+
+    bms_input.hard_reset_line = false;
+    bms_input.mode_request = BMS_SSM_MODE_STANDBY;
+    bms_input.balance_mV = 0;
+    bms_input.contactors_closed = false;
+    bms_input.msTicks = msTicks;
+    bms_input.pack_status = &pack_status;
+    bms_input.charger_on = false;
+    bms_input.eeprom_packconfig_read_done = false;
+    bms_input.ltc_packconfig_check_done = false;
+    bms_input.eeprom_read_error = false;
+#ifdef FSAE_DRIVERS
+    bms_input.last_vcu_msg_ms = 0;
+#endif
+
+    pack_status.cell_voltages_mV = cell_voltages;
+    pack_status.cell_temperatures_dC = cell_temperatures;
+    pack_status.pack_cell_max_mV = 0;
+    pack_status.pack_cell_min_mV = 0xFFFFFFFF;
+    pack_status.pack_current_mA = 0;
+    pack_status.pack_voltage_mV = 0;
+    pack_status.pack_cell_sum_mV = 0;
+    pack_status.avg_cell_voltage_mV = 0;
+    pack_status.max_cell_voltage_position = 0;
+    pack_status.min_cell_voltage_position = 0;
+    pack_status.cell_ir_limit_mA = UINT32_MAX;
+    pack_status.max_cell_temp_dC = 0;
+    PackStats_Init(&pack_status);
+}
+
+/****************************
+ *     HARDWARE MODELS
+ ****************************/
+
+/**
+ * @details solve for the pack current given the charger request and the
+ *          discharge load. Charger is a CC/CV supply, the load a current sink.
+ */
+static double Sim_Pack_Current_A(void) {
+    if (!bms_input.contactors_closed) {
+        return 0;
+    }
+
+    if (charge_req.charger_on) {
+        double limit_A = charge_req.charge_current_mA / 1000.0;
+        double headroom_V = charge_req.charge_voltage_mV / 1000.0 - PackModel_PackOcv_V(&model);
+        double cv_A = headroom_V / PackModel_PackResistance_ohm(&model);
+        if (cv_A < 0) cv_A = 0;
+        return (cv_A < limit_A) ? cv_A : limit_A;
+    }
+
+    return -load_current_A;
+}
+
+// Mirrors main.c Process_Input: sample the pack and update inputs
+static void Sim_Process_Input(double current_A) {
+    if (msTicks - last_sample_ms >= SIM_LTC_SAMPLE_MS) {
+        last_sample_ms = msTicks;
+        PackModel_Sample(&model, &pack_status, &pack_config);
+        pack_status.cell_voltages_ms = msTicks;
+    }
+
+    double abs_current_A = (current_A < 0) ? -current_A : current_A;
+    pack_status.pack_current_mA = (uint32_t)(abs_current_A * 1000.0);
+    pack_status.pack_current_ms = msTicks;
+    pack_status.pack_voltage_mV = (uint32_t)(PackModel_PackOcv_V(&model) * 1000.0
+            + current_A * PackModel_PackResistance_ohm(&model) * 1000.0);
+    pack_status.pack_voltage_ms = msTicks;
+
+    bms_input.msTicks = msTicks;
+}
+
+// Mirrors main.c Process_Output: EEPROM/LTC handshakes and actuators
+static void Sim_Process_Output(void) {
+    if (bms_output.read_eeprom_packconfig) {
+        Sim_Load_PackConfig(&pack_config);
+        Charge_Config(&pack_config);
+        Discharge_Config(&pack_config);
+        bms_input.eeprom_packconfig_read_done = true;
+    } else if (bms_output.check_packconfig_with_ltc) {
+        bms_input.ltc_packconfig_check_done = true;
+    }
+
+    // contactors and charger follow their requests within one loop
+    bms_input.contactors_closed = bms_output.close_contactors;
+    bms_input.charger_on = charge_req.charger_on;
+}
+
+static void Sim_Print_Errors(void) {
+    uint32_t i;
+    for (i = 0; i < ERROR_NUM_ERRORS; i++) {
+        const ERROR_STATUS_T *stat = Error_GetStatus(i);
+        if (stat->error || stat->handling) {
+            printf("    %s\r\n", ERROR_NAMES[i]);
+        }
+    }
+}
+
+static uint32_t Sim_Cell_Spread_mV(void) {
+    return pack_status.pack_cell_max_mV - pack_status.pack_cell_min_mV;
+}
+
+static uint32_t Sim_Balancing_Count(void) {
+    uint32_t count = 0;
+    uint16_t i;
+    for (i = 0; i < model.num_cells; i++) {
+        if (Is_Cell_Balancing(balance_reqs, &pack_config, i)) count++;
+    }
+    return count;
+}
+
+static void Sim_Print_Status(const char *phase) {
+    printf("  %s t=%7.3fh mode=%s I=%6.2fA min=%umV max=%umV bal=%u maxT=%d.%ddC\r\n",
+            phase, msTicks / 3600000.0, BMS_SSM_MODE_NAMES[bms_state.curr_mode],
+            model.last_current_A, pack_status.pack_cell_min_mV,
+            pack_status.pack_cell_max_mV, Sim_Balancing_Count(),
+            pack_status.max_cell_temp_dC / 10, pack_status.max_cell_temp_dC % 10);
+}
+
+/**
+ * @details run one main-loop iteration of the BMS against the pack model
+ */
+static void Sim_Step(const char *phase) {
+    double current_A = Sim_Pack_Current_A();
+
+    PackModel_Step(&model, current_A, balance_reqs, &pack_config, SIM_TICK_MS);
+    msTicks += SIM_TICK_MS;
+
+    Sim_Process_Input(current_A);
+    SSM_Step(&bms_input, &bms_state, &bms_output);
+    Sim_Process_Output();
+
+    if (Error_Handle(bms_input.msTicks) == HANDLER_HALT) {
+        halted = true;
+        printf("  HALT during %s at t=%.3fh\r\n", phase, msTicks / 3600000.0);
+        Sim_Print_Errors();
+    }
+
+    if (verbose && msTicks - last_status_ms >= SIM_STATUS_PERIOD_MS) {
+        last_status_ms = msTicks;
+        Sim_Print_Status(phase);
+    }
+}
+
+/****************************
+ *     SCENARIO PHASES
+ ****************************/
+
+static bool Sim_Charge_Done(void) {
+    return bms_state.charge_state == BMS_CHARGE_DONE;
+}
+
+static bool Sim_Discharge_Done(void) {
+    return pack_status.pack_cell_min_mV < pack_config.cell_min_mV + SIM_DISCHARGE_STOP_MARGIN_mV;
+}
+
+static bool Sim_Standby_Done(void) {
+    return bms_state.curr_mode == BMS_SSM_MODE_STANDBY;
+}
+
+/**
+ * @details request mode until done() or timeout_ms elapses, then return the
+ *          elapsed pack time. Returns UINT32_MAX on halt or timeout.
+ */
+static uint32_t Sim_Run_Phase(const char *phase, BMS_SSM_MODE_T mode,
+        bool (*done)(void), uint32_t timeout_ms) {
+    uint32_t start = msTicks;
+    bms_input.mode_request = mode;
+
+    while (!halted && !done()) {
+        if (msTicks - start > timeout_ms) {
+            printf("  TIMEOUT during %s after %.3fh\r\n", phase, timeout_ms / 3600000.0);
+            return UINT32_MAX;
+        }
+
+        if (mode == BMS_SSM_MODE_DISCHARGE) {
+            uint32_t max_current_mA = Read_Max_Current();
+            bool pulse = ((msTicks - start) % SIM_DISCHARGE_PULSE_PERIOD_ms) < SIM_DISCHARGE_PULSE_ms;
+            // 0.5x the rated current with 0.75x pulses
+            load_current_A = max_current_mA / 1000.0 * (pulse ? 0.75 : 0.5);
+        } else {
+            load_current_A = 0;
+        }
+
+        Sim_Step(phase);
+    }
+    load_current_A = 0;
+
+    if (halted) {
+        return UINT32_MAX;
+    }
+    return msTicks - start;
+}
+
+/**
+ * @details return the pack to standby after a phase
+ */
+static bool Sim_To_Standby(const char *phase) {
+    return Sim_Run_Phase(phase, BMS_SSM_MODE_STANDBY, Sim_Standby_Done, 60000) != UINT32_MAX;
+}
+
+/**
+ * @details raise one cell group per module by seed_pct of its capacity
+ *
+ * @return total charge added
+ */
+static double Sim_Seed_Imbalance(double seed_pct) {
+    double seeded_As = 0;
+    uint8_t module;
+    for (module = 0; module < pack_config.num_modules; module++) {
+        PACK_MODEL_CELL_T *cell = &model.cells[module*SIM_CELLS_PER_MODULE
+                + module % SIM_CELLS_PER_MODULE];
+        double add_As = cell->capacity_As * seed_pct / 100.0;
+        cell->charge_As += add_As;
+        seeded_As += add_As;
+    }
+    return seeded_As;
+}
+
+static bool Sim_Check(bool pass, const char *what) {
+    printf("  [%s] %s\r\n", pass ? "PASS" : "FAIL", what);
+    return pass;
+}
+
+int main(int argc, const char *argv[]) {
+    bool pass = true;
+    clock_t wall_start = clock();
+
+    verbose = (argc > 1 && strcmp(argv[1], "-v") == 0);
+
+    Sim_Init_BMS_Structs();
+    Error_Init();
+    SSM_Init(&bms_input, &bms_state, &bms_output);
+
+    // the model needs a pack configuration before SSM init loads it
+    Sim_Load_PackConfig(&pack_config);
+    PackModel_Init(&model, &pack_config, SIM_START_SOC_pct, SIM_START_SOC_SPREAD_pct);
+    PackModel_Sample(&model, &pack_status, &pack_config);
+
+    printf("Pack simulator: %u modules x %u cells, %uP, %u cAh cells\r\n",
+            (unsigned)pack_config.num_modules, SIM_CELLS_PER_MODULE,
+            (unsigned)pack_config.pack_cells_p, (unsigned)pack_config.cell_capacity_cAh);
+
+    // INIT -> STANDBY
+    uint32_t init_ms = Sim_Run_Phase("init", BMS_SSM_MODE_STANDBY, Sim_Standby_Done, 60000);
+    pass &= Sim_Check(init_ms != UINT32_MAX, "init reaches standby");
+
+    // CHARGE (CC/CV with balancing against the minimum cell)
+    uint32_t spread_start_mV = Sim_Cell_Spread_mV();
+    uint32_t charge_ms = Sim_Run_Phase("charge", BMS_SSM_MODE_CHARGE, Sim_Charge_Done, SIM_MAX_CHARGE_ms);
+    pass &= Sim_Check(charge_ms != UINT32_MAX && Sim_To_Standby("charge"), "charge completes");
+    double charged_Ah = model.charge_in_As / 3600.0;
+
+    // BALANCE to the minimum cell
+    double bled_start_As = model.balance_As;
+    uint32_t spread_charged_mV = Sim_Cell_Spread_mV();
+    bms_input.balance_mV = pack_status.pack_cell_min_mV;
+    uint32_t balance_ms = Sim_Run_Phase("balance", BMS_SSM_MODE_BALANCE, Sim_Charge_Done, SIM_MAX_BALANCE_ms);
+    pass &= Sim_Check(balance_ms != UINT32_MAX && Sim_To_Standby("balance"), "balance completes");
+    uint32_t spread_balanced_mV = Sim_Cell_Spread_mV();
+    double bled_Ah = (model.balance_As - bled_start_As) / 3600.0;
+    pass &= Sim_Check(spread_balanced_mV <= SIM_MAX_BALANCED_SPREAD_mV, "balanced cell spread within limit");
+
+    // DISCHARGE until the VCU would stop drawing current
+    uint32_t discharge_ms = Sim_Run_Phase("discharge", BMS_SSM_MODE_DISCHARGE, Sim_Discharge_Done, SIM_MAX_DISCHARGE_ms);
+    pass &= Sim_Check(discharge_ms != UINT32_MAX && Sim_To_Standby("discharge"), "discharge completes");
+    double discharged_Ah = model.charge_out_As / 3600.0;
+
+    // BALANCE ONLY, the charge above leaves nothing worth bleeding
+    PackModel_Init(&model, &pack_config, SIM_BALANCE_SOC_pct, 0);
+    double seeded_Ah = Sim_Seed_Imbalance(SIM_BALANCE_SEED_pct) / 3600.0;
+    PackModel_Sample(&model, &pack_status, &pack_config);
+    uint32_t spread_seeded_mV = Sim_Cell_Spread_mV();
+    bms_input.balance_mV = pack_status.pack_cell_min_mV;
+    uint32_t seed_balance_ms = Sim_Run_Phase("balance only", BMS_SSM_MODE_BALANCE,
+            Sim_Charge_Done, SIM_MAX_BALANCE_ms);
+    pass &= Sim_Check(seed_balance_ms != UINT32_MAX && Sim_To_Standby("balance only"),
+            "balance only completes");
+    uint32_t spread_reseeded_mV = Sim_Cell_Spread_mV();
+    double seed_bled_Ah = model.balance_As / 3600.0;
+    pass &= Sim_Check(seed_bled_Ah > 0 && seed_bled_Ah <= seeded_Ah,
+            "balance only bleeds no more than the seeded charge");
+    pass &= Sim_Check(spread_reseeded_mV <= SIM_MAX_BALANCED_SPREAD_mV,
+            "balance only spread within limit");
+
+    double wall_s = (double)(clock() - wall_start) / CLOCKS_PER_SEC;
+
+    printf("Results:\r\n");
+    printf("  charge:    %8.3f h, %7.3f Ah in\r\n", charge_ms / 3600000.0, charged_Ah);
+    printf("  balance:   %8.3f h, %7.3f Ah bled, spread %u mV -> %u mV -> %u mV\r\n",
+            balance_ms / 3600000.0, bled_Ah, spread_start_mV, spread_charged_mV, spread_balanced_mV);
+    printf("  discharge: %8.3f h, %7.3f Ah out, max cell temp %d dC\r\n",
+            discharge_ms / 3600000.0, discharged_Ah, pack_status.max_cell_temp_dC);
+    printf("  balance only: %5.3f h, %7.3f of %.3f Ah seeded bled, spread %u mV -> %u mV\r\n",
+            seed_balance_ms / 3600000.0, seed_bled_Ah, seeded_Ah, spread_seeded_mV,
+            spread_reseeded_mV);
+    printf("  simulated %.3f h in %.2f s wall clock (%.0fx real time)\r\n",
+            msTicks / 3600000.0, wall_s, (wall_s > 0) ? msTicks / 1000.0 / wall_s : 0);
+
+    return pass ? 0 : 1;
+}
@@ -10,3 +10,15 @@ uint16_t Get_Total_Cell_Count(PACK_CONFIG_T *pack_config) {
     return total_num_cells;
 }
 
+bool Is_Cell_Balancing(const uint16_t *balance_req, PACK_CONFIG_T *pack_config, uint16_t cell) {
+    uint8_t module = 0;
+    while (cell >= pack_config->module_cell_count[module]) {
+        cell -= pack_config->module_cell_count[module];
+        module++;
+    }
+    return (balance_req[module] >> cell) & 1;
+}
+
+uint16_t Saturate_u16(uint32_t val) {
+    return (val > UINT16_MAX) ? UINT16_MAX : val;
+}
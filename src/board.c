@@ -1,6 +1,11 @@
 // ltc-battery-management-system
 #include "board.h"
 #include "error_handler.h"
+#include "pack_stats.h"
+#include "gcv_pipeline.h"
+#include "bms_utils.h"
+#include "cell_filter.h"
+#include "current_sense.h"
 
 // C libraries
 #include <string.h>
@@ -10,6 +15,8 @@
 
     #include "fsae_can.h"
     #include "cell_temperatures.h"
+    #include "mux_sequence.h"
+    #include "thermistor_scan.h"
 
 #else // FSAE_DRIVERS
 
@@ -27,6 +34,11 @@ const uint32_t OscRateIn = 0;
 
 //#define PRINT_MODE_REQUESTS
 
+// pack current sensor on AD7, sampled from the CT32B0 match interrupt
+#define CURRENT_SENSE_IOCON IOCON_PIO1_11
+#define CURRENT_SENSE_ADC_CHANNEL ADC_CH7
+#define CURRENT_SENSE_MATCH 0
+
 #ifndef TEST_HARDWARE
 static RINGBUFF_T uart_rx_ring;
 static uint8_t _uart_rx_ring[UART_BUFFER_SIZE];
@@ -40,30 +52,48 @@ static uint8_t ltc6804_tx_buf[LTC6804_CALC_BUFFER_LEN(MAX_NUM_MODULES)];
 static uint8_t ltc6804_rx_buf[LTC6804_CALC_BUFFER_LEN(MAX_NUM_MODULES)]; 
 static uint8_t ltc6804_cfg[LTC6804_DATA_LEN]; 
 static uint16_t ltc6804_bal_list[MAX_NUM_MODULES]; 
+// reads back into pack_status->cell_voltages_raw_mV. Only cell_voltages_mV
+// is updated solely at publish, by the filter, so a failed or half finished
+// readback never reaches it
 static LTC6804_ADC_RES_T ltc6804_adc_res;
 static LTC6804_OWT_RES_T ltc6804_owt_res; 
-// ltc6804 timing variables
-static bool _ltc6804_gcv;
-static uint32_t _ltc6804_last_gcv;
-static uint32_t _ltc6804_gcv_tick_time;
-static bool _ltc6804_owt;
-static uint32_t _ltc6804_last_owt;
-static uint32_t _ltc6804_owt_tick_time;
 
 static bool _ltc6804_initialized;
 static LTC6804_INIT_STATE_T _ltc6804_init_state;
 
+// cell voltage acquisition, sequenced by gcv_pipeline.c
+static BMS_PACK_STATUS_T *_gcv_pack_status;
+static uint32_t *_gcv_cell_voltages_raw_mV;
+static uint16_t _gcv_num_cells;
+static GCV_OP_STATUS_T Gcv_Convert(void);
+static GCV_OP_STATUS_T Gcv_Clear(void);
+static void Gcv_Publish(void);
+static GCV_OP_STATUS_T Gcv_OpenWire(void);
+static const GCV_PIPELINE_OPS_T gcv_ops = {Gcv_Convert, Gcv_Clear, Gcv_Publish, Gcv_OpenWire};
+// open wire test queued on the pipeline, and how the last one came out
+static bool _owt_requested;
+static bool _owt_passed;
+
 static char str[10];
 
 #ifdef FSAE_DRIVERS
 
 //Cell temperature sensing stuff
-static uint32_t board_lastThermistorShiftTime_ms = 0;
 uint8_t currentThermistor = 0;
 
 //Cell temperature sensing stuff
 static bool ltc6804_setMultiplexerAddressFlag = false;
 static bool ltc6804_getThermistorVoltagesFlag = false;
+static MUX_SEQUENCE_T mux_sequence;
+
+// the chain comes out of init with its GPIOs at their defaults, so
+// drop the current thermistor and every pin level we knew
+static void Board_ThermistorMux_Reset(void) {
+    MuxSequence_Init(&mux_sequence);
+    ThermistorScan_Init(MAX_THERMISTORS_PER_MODULE);
+    ltc6804_setMultiplexerAddressFlag = false;
+    ltc6804_getThermistorVoltagesFlag = false;
+}
 
 #endif // FSAE_DRIVERS
 
@@ -87,6 +117,20 @@ void SysTick_Handler(void) {
     msTicks++;
 }
 
+void TIMER32_0_IRQHandler(void) {
+    if (!Chip_TIMER_MatchPending(LPC_TIMER32_0, CURRENT_SENSE_MATCH)) {
+        return;
+    }
+    Chip_TIMER_ClearMatch(LPC_TIMER32_0, CURRENT_SENSE_MATCH);
+    // the conversion started on the last tick finished long ago, read it
+    // and start the next, so the samples are evenly spaced
+    uint16_t counts;
+    if (Chip_ADC_ReadValue(LPC_ADC, CURRENT_SENSE_ADC_CHANNEL, &counts) == SUCCESS) {
+        CurrentSense_AddSample(counts, msTicks);
+    }
+    Chip_ADC_SetStartMode(LPC_ADC, ADC_START_NOW, ADC_TRIGGERMODE_RISING);
+}
+
 #endif // TEST_HARDWARE
 
 // ------------------------------------------------
@@ -99,6 +143,27 @@ void Board_Chip_Init(void) {
 }
 
 
+void Board_CurrentSense_Init(void) {
+    CurrentSense_Init();
+#ifndef TEST_HARDWARE
+    ADC_CLOCK_SETUP_T adc_setup;
+    Chip_IOCON_PinMuxSet(LPC_IOCON, CURRENT_SENSE_IOCON, (IOCON_FUNC1 | IOCON_ADMODE_EN));
+    Chip_ADC_Init(LPC_ADC, &adc_setup);
+    Chip_ADC_EnableChannel(LPC_ADC, CURRENT_SENSE_ADC_CHANNEL, ENABLE);
+    Chip_ADC_SetStartMode(LPC_ADC, ADC_START_NOW, ADC_TRIGGERMODE_RISING);
+
+    Chip_TIMER_Init(LPC_TIMER32_0);
+    Chip_TIMER_Reset(LPC_TIMER32_0);
+    Chip_TIMER_SetMatch(LPC_TIMER32_0, CURRENT_SENSE_MATCH,
+            SystemCoreClock / CURRENT_SENSE_SAMPLE_HZ);
+    Chip_TIMER_ResetOnMatchEnable(LPC_TIMER32_0, CURRENT_SENSE_MATCH);
+    Chip_TIMER_MatchEnableInt(LPC_TIMER32_0, CURRENT_SENSE_MATCH);
+    Chip_TIMER_Enable(LPC_TIMER32_0);
+    NVIC_ClearPendingIRQ(TIMER_32_0_IRQn);
+    NVIC_EnableIRQ(TIMER_32_0_IRQn);
+#endif
+}
+
 uint32_t Board_Print(const char *str) {
 #ifdef TEST_HARDWARE
     return printf("%s", str);
@@ -112,6 +177,21 @@ void Board_BlockingDelay(uint32_t dlyTicks) {
     while ((msTicks - curTicks) < dlyTicks);
 }
 
+uint32_t Board_Micros(void) {
+#ifdef TEST_HARDWARE
+    return msTicks * 1000;
+#else
+    uint32_t ms;
+    uint32_t elapsed_ticks;
+    // reread if the SysTick interrupt landed between the two reads
+    do {
+        ms = msTicks;
+        elapsed_ticks = SysTick->LOAD - SysTick->VAL;
+    } while (ms != msTicks);
+    return ms * 1000 + elapsed_ticks / (SystemCoreClock / 1000000);
+#endif
+}
+
 uint32_t Board_Println(const char *str) {
 #ifdef TEST_HARDWARE
     return printf("%s\r\n", str);
@@ -303,9 +383,9 @@ void Board_GPIO_Init(void) {
 #endif // TEST_HARDWARE
 }
 
-bool Board_LTC6804_Init(PACK_CONFIG_T *pack_config, uint32_t *cell_voltages_mV) {
+bool Board_LTC6804_Init(PACK_CONFIG_T *pack_config, uint32_t *cell_voltages_raw_mV) {
 #ifdef TEST_HARDWARE
-    UNUSED(pack_config); UNUSED(cell_voltages_mV);
+    UNUSED(pack_config); UNUSED(cell_voltages_raw_mV);
     return true;
 #else
     if (_ltc6804_initialized) return true;
@@ -330,19 +410,19 @@ bool Board_LTC6804_Init(PACK_CONFIG_T *pack_config, uint32_t *cell_voltages_mV)
         ltc6804_state.cfg = ltc6804_cfg;
         ltc6804_state.bal_list = ltc6804_bal_list;
 
-        ltc6804_adc_res.cell_voltages_mV = cell_voltages_mV;
+        ltc6804_adc_res.cell_voltages_mV = cell_voltages_raw_mV;
+        _gcv_cell_voltages_raw_mV = cell_voltages_raw_mV;
+        _gcv_num_cells = Get_Total_Cell_Count(pack_config);
 
         ltc6804_owt_res.failed_wire = 0;
         ltc6804_owt_res.failed_module = 0;
 
-        _ltc6804_gcv = false;
-        _ltc6804_last_gcv = 0;
-        _ltc6804_gcv_tick_time = 100;
-        _ltc6804_owt = true;
-        _ltc6804_last_owt = 0;
-        _ltc6804_owt_tick_time = 60000;
-
         LTC6804_Init(&ltc6804_config, &ltc6804_state, msTicks);
+        GcvPipeline_Init(&gcv_ops, CELL_VOLTAGES_PIPELINED);
+        CellFilter_Init(CELL_FILTER_MODE);
+#ifdef FSAE_DRIVERS
+        Board_ThermistorMux_Reset();
+#endif
 
         _ltc6804_init_state = LTC6804_INIT_CFG;
     } else if (_ltc6804_init_state == LTC6804_INIT_CFG) { 
@@ -369,178 +449,171 @@ void Board_LTC6804_DeInit(void) {
 #ifndef TEST_HARDWARE
     _ltc6804_initialized = false;
     _ltc6804_init_state = LTC6804_INIT_NONE;
+    GcvPipeline_Init(&gcv_ops, CELL_VOLTAGES_PIPELINED);
+    _owt_requested = false;
+#ifdef FSAE_DRIVERS
+    Board_ThermistorMux_Reset();
+#endif
 #endif
 }
 
-void Board_LTC6804_ProcessInputs(BMS_PACK_STATUS_T *pack_status, BMS_STATE_T* bms_state) {
-    Board_LTC6804_GetCellVoltages(pack_status);
-    Board_LTC6804_GetCellTemperatures(pack_status, bms_state->pack_config->num_modules);
-    Board_LTC6804_OpenWireTest();
-}
-
-void Board_LTC6804_ProcessOutput(bool *balance_req) {
+void Board_LTC6804_ProcessOutput(uint16_t *balance_req) {
     Board_LTC6804_UpdateBalanceStates(balance_req);
 }
 
-void Board_LTC6804_GetCellVoltages(BMS_PACK_STATUS_T* pack_status) {
+bool Board_LTC6804_GetCellVoltages(BMS_PACK_STATUS_T* pack_status) {
 #ifdef TEST_HARDWARE
     UNUSED(pack_status);
-    return;
+    return true;
 #else
+    _gcv_pack_status = pack_status;
+    return GcvPipeline_Step(msTicks);
+#endif
+}
 
-    if (msTicks - _ltc6804_last_gcv > _ltc6804_gcv_tick_time) {
-        _ltc6804_gcv = true;
-    }
-
-    if (!_ltc6804_gcv) {
-        return;
-    }
-
+#ifndef TEST_HARDWARE
+static GCV_OP_STATUS_T Gcv_Convert(void) {
     LTC6804_STATUS_T res = LTC6804_GetCellVoltages(&ltc6804_config, &ltc6804_state, &ltc6804_adc_res, msTicks);
     switch (res) {
         case LTC6804_FAIL:
             Board_Println("Get Vol FAIL");
-            break;
+            return GCV_OP_ERROR;
         case LTC6804_PEC_ERROR:
             Board_Println("Get Vol PEC_ERROR");
             Error_Assert(ERROR_LTC6804_PEC,msTicks);
-            break;
+            return GCV_OP_ERROR;
         case LTC6804_PASS:
-            pack_status->pack_cell_min_mV = ltc6804_adc_res.pack_cell_min_mV;
-            pack_status->pack_cell_max_mV = ltc6804_adc_res.pack_cell_max_mV;
-            LTC6804_ClearCellVoltages(&ltc6804_config, &ltc6804_state, msTicks); // [TODO] Use this to your advantage
-            _ltc6804_gcv = false;
-            _ltc6804_last_gcv = msTicks;
             Error_Pass(ERROR_LTC6804_PEC);
+            return GCV_OP_PASS;
         case LTC6804_WAITING:
         case LTC6804_WAITING_REFUP:
-            break;
+            return GCV_OP_WAITING;
         default:
             Board_Println("WTF");
+            return GCV_OP_ERROR;
     }
+}
+
+static GCV_OP_STATUS_T Gcv_Clear(void) {
+    LTC6804_STATUS_T res = LTC6804_ClearCellVoltages(&ltc6804_config, &ltc6804_state, msTicks);
+    switch (res) {
+        case LTC6804_PASS:
+            return GCV_OP_PASS;
+        case LTC6804_WAITING:
+        case LTC6804_WAITING_REFUP:
+            return GCV_OP_WAITING;
+        default:
+            return GCV_OP_ERROR;
+    }
+}
+
+static void Gcv_Publish(void) {
+    _gcv_pack_status->cell_voltages_ms = GcvPipeline_GetSampleTime();
+    CellFilter_Update(_gcv_cell_voltages_raw_mV, _gcv_pack_status->cell_voltages_mV,
+            _gcv_num_cells);
+    PackStats_UpdateVoltages(_gcv_pack_status, ltc6804_config.num_modules,
+            ltc6804_config.module_cell_count);
+    PackStats_UpdateCellSum(_gcv_pack_status, ltc6804_config.num_modules,
+            ltc6804_config.module_cell_count);
+}
 #endif
+
+#if !defined(TEST_HARDWARE) && defined(FSAE_DRIVERS)
+static uint8_t Board_ThermistorAddress(uint8_t thermistor) {
+    if (thermistor <= THERMISTOR_GROUP_ONE_END) {
+        return thermistor + THERMISTOR_GROUP_ONE_OFFSET;
+    } else if ((THERMISTOR_GROUP_TWO_START <= thermistor) && 
+            (thermistor <= THERMISTOR_GROUP_TWO_END)) {
+        return thermistor + THERMISTOR_GROUP_TWO_OFFSET;
+    } else if ((THERMISTOR_GROUP_THREE_START <= thermistor) && 
+            (thermistor <= THERMISTOR_GROUP_THREE_END)) {
+        return thermistor + THERMISTOR_GROUP_THREE_OFFSET;
+    }
+    Board_Println("Invalid value of currentThermistor. You should never reach here");
+    Error_Assert(ERROR_CONTROL_FLOW, msTicks);
+    return 0;
+}
+
+static MUX_WRITE_STATUS_T Mux_Write(MUX_PIN_T pin, bool level) {
+    static const uint8_t gpio[] = {
+        LTC6804_SHIFT_REGISTER_DATA_IN,     // MUX_PIN_DATA
+        LTC6804_SHIFT_REGISTER_CLOCK,       // MUX_PIN_CLOCK
+        LTC6804_SHIFT_REGISTER_LATCH        // MUX_PIN_LATCH
+    };
+    LTC6804_STATUS_T res = LTC6804_SetGPIOState(&ltc6804_config, &ltc6804_state,
+            gpio[pin], level, msTicks);
+    Board_HandleLtc6804Status(res);
+    switch (res) {
+        case LTC6804_PASS:
+            return MUX_WRITE_PASS;
+        case LTC6804_WAITING:
+        case LTC6804_WAITING_REFUP:
+            return MUX_WRITE_WAITING;
+        default:
+            return MUX_WRITE_ERROR;
+    }
 }
+#endif
 
-void Board_LTC6804_GetCellTemperatures(BMS_PACK_STATUS_T * pack_status, uint8_t num_modules) {
+bool Board_LTC6804_GetCellTemperatures(BMS_PACK_STATUS_T * pack_status, uint8_t num_modules) {
 #ifndef TEST_HARDWARE
 #ifdef FSAE_DRIVERS
-    if ((msTicks - board_lastThermistorShiftTime_ms) > TIME_PER_THERMISTOR_MS) {
-        board_lastThermistorShiftTime_ms = msTicks;
-
-        // if we finished reading previous thermistor voltage, go to next thermistor
-        if (!ltc6804_setMultiplexerAddressFlag && !ltc6804_getThermistorVoltagesFlag) {
-            if (currentThermistor < (MAX_THERMISTORS_PER_MODULE-1)) {
-                currentThermistor += 1;
-            } else {
-                currentThermistor = 0;
-            }
-            
-            // set flags to true
-            ltc6804_setMultiplexerAddressFlag = true;
-            ltc6804_getThermistorVoltagesFlag = true;
-        }
-
+    // if we finished reading previous thermistor voltage, go to the next
+    // thermistor, hottest and fastest rising first (see thermistor_scan.h)
+    if (!ltc6804_setMultiplexerAddressFlag && !ltc6804_getThermistorVoltagesFlag) {
+        currentThermistor = ThermistorScan_Next();
+        MuxSequence_Select(&mux_sequence, Board_ThermistorAddress(currentThermistor));
+        
+        // set flags to true
+        ltc6804_setMultiplexerAddressFlag = true;
+        ltc6804_getThermistorVoltagesFlag = true;
     }
 
-     LTC6804_STATUS_T status;
+    LTC6804_STATUS_T status;
 
-    // set multiplexer address 
+    // set multiplexer address, resuming where the chain last stopped us
     // if flag is not true, skip this step
     if (ltc6804_setMultiplexerAddressFlag) {
-
-        // initalize CLOCK and LATCH input to the shift register
-        status = LTC6804_SetGPIOState(&ltc6804_config, &ltc6804_state,
-                LTC6804_SHIFT_REGISTER_CLOCK, 0, msTicks);
-        Board_HandleLtc6804Status(status);
-        if (status != LTC6804_PASS) return;
-
-        status = LTC6804_SetGPIOState(&ltc6804_config, &ltc6804_state,
-                LTC6804_SHIFT_REGISTER_LATCH, 0, msTicks);
-        Board_HandleLtc6804Status(status);
-        if (status != LTC6804_PASS) return;
-        
-        // Get thermistor address
-        uint8_t thermistorAddress = 0;
-        if (currentThermistor <= THERMISTOR_GROUP_ONE_END) {
-            thermistorAddress = currentThermistor + THERMISTOR_GROUP_ONE_OFFSET;
-        } else if ((THERMISTOR_GROUP_TWO_START <= currentThermistor) && 
-                (currentThermistor <= THERMISTOR_GROUP_TWO_END)) {
-            thermistorAddress = currentThermistor + THERMISTOR_GROUP_TWO_OFFSET;
-        } else if ((THERMISTOR_GROUP_THREE_START <= currentThermistor) && 
-                (currentThermistor <= THERMISTOR_GROUP_THREE_END)) {
-            thermistorAddress = currentThermistor + THERMISTOR_GROUP_THREE_OFFSET;
-        } else {
-            Board_Println("Invalid value of currentThermistor. You should never reach here");
-            Error_Assert(ERROR_CONTROL_FLOW, msTicks);
-        }
-
-        // shift bits into shift resgister
-        int8_t i;
-        for (i=7; i>=0; i--) {
-            uint8_t addressBit = (thermistorAddress & (1<<i) ) >> i;
-            status = LTC6804_SetGPIOState(&ltc6804_config, &ltc6804_state, 
-                    LTC6804_SHIFT_REGISTER_DATA_IN, addressBit, msTicks);
-            Board_HandleLtc6804Status(status);
-            if (status != LTC6804_PASS) return;
-
-            status = LTC6804_SetGPIOState(&ltc6804_config, &ltc6804_state,
-                    LTC6804_SHIFT_REGISTER_CLOCK, 1, msTicks);
-            Board_HandleLtc6804Status(status);
-            if (status != LTC6804_PASS) return;
-
-            status = LTC6804_SetGPIOState(&ltc6804_config, &ltc6804_state,
-                    LTC6804_SHIFT_REGISTER_CLOCK, 0, msTicks);
-            Board_HandleLtc6804Status(status);
-            if (status != LTC6804_PASS) return;
-
+        if (MuxSequence_Run(&mux_sequence, Mux_Write) != MUX_WRITE_PASS) {
+            return false;
         }
 
-        // Latch the outputs
-        status = LTC6804_SetGPIOState(&ltc6804_config, &ltc6804_state, 
-                LTC6804_SHIFT_REGISTER_LATCH, 1, msTicks);
-        Board_HandleLtc6804Status(status);
-        if (status != LTC6804_PASS) return;
-
-        status = LTC6804_SetGPIOState(&ltc6804_config, &ltc6804_state, 
-                LTC6804_SHIFT_REGISTER_LATCH, 0, msTicks);
-        Board_HandleLtc6804Status(status);
-        if (status != LTC6804_PASS) return;
-
         // Finished setting multiplexer address. Reset flag
         ltc6804_setMultiplexerAddressFlag = false;
-        
     }
 
 
     // Get thermistor voltages
     // if flag is not true, return
     if (!ltc6804_getThermistorVoltagesFlag) {
-        return;
+        return true;
     }
     
     uint32_t gpioVoltages[MAX_NUM_MODULES * LTC6804_GPIO_COUNT];
     status = LTC6804_GetGPIOVoltages(&ltc6804_config, &ltc6804_state, gpioVoltages, 
             msTicks);
     Board_HandleLtc6804Status(status);
-    if (status != LTC6804_PASS) return;
+    if (status != LTC6804_PASS) return false;
 
     CellTemperatures_UpdateCellTemperaturesArray(gpioVoltages, currentThermistor, 
             pack_status, num_modules);
+    ThermistorScan_Record(currentThermistor, pack_status->cell_temperatures_dC,
+            num_modules, msTicks);
+    pack_status->cell_temperatures_ms = msTicks;
 
     // Finished getting thermistor voltages. Reset flag
     ltc6804_getThermistorVoltagesFlag = false;
+    return true;
 
-    if (currentThermistor == THERMISTOR_GROUP_THREE_END) {
-        CellTemperatures_UpdateMaxMinAvgCellTemperatures(pack_status, num_modules);
-    }
-    
     #else 
         UNUSED(pack_status);
         UNUSED(num_modules);
+        return true;
     #endif // FSAE_DRIVERS
 #else 
     UNUSED(pack_status);
     UNUSED(num_modules);
+    return true;
 #endif //TEST_HARDWARE
 }
 
@@ -624,12 +697,23 @@ bool Board_LTC6804_CVST(void) {
 }
 
 //[TODO] add error handling
-void Board_LTC6804_UpdateBalanceStates(bool *balance_req) {
+void Board_LTC6804_UpdateBalanceStates(uint16_t *balance_req) {
 #ifdef TEST_HARDWARE
     UNUSED(balance_req);
     return;
 #else
-    LTC6804_UpdateBalanceStates(&ltc6804_config, &ltc6804_state, balance_req, msTicks);
+    // the driver still takes one bool per cell and builds its DCC masks
+    // from them, so spread the words out on the stack for the call
+    bool cell_balance_req[MAX_NUM_MODULES*MAX_CELLS_PER_MODULE];
+    uint16_t cell = 0;
+    uint8_t module, i;
+    for (module = 0; module < ltc6804_config.num_modules; module++) {
+        uint16_t req = balance_req[module];
+        for (i = 0; i < ltc6804_config.module_cell_count[module]; i++, cell++) {
+            cell_balance_req[cell] = (req >> i) & 1;
+        }
+    }
+    LTC6804_UpdateBalanceStates(&ltc6804_config, &ltc6804_state, cell_balance_req, msTicks);
 #endif
 }
 
@@ -652,15 +736,32 @@ bool Board_LTC6804_OpenWireTest(void) {
 #ifdef TEST_HARDWARE
     return true; // Change to simulate during test
 #else
+    return Gcv_OpenWire() == GCV_OP_PASS;
+#endif
+}
 
-    if (msTicks - _ltc6804_last_owt > _ltc6804_owt_tick_time) {
-        _ltc6804_owt = true;
-    }
-
-    if (!_ltc6804_owt) {
+bool Board_LTC6804_OpenWireSlot(void) {
+#ifdef TEST_HARDWARE
+    return true;
+#else
+    if (GcvPipeline_OpenWirePending()) {
         return false;
     }
+    if (_owt_requested) {
+        _owt_requested = false;
+        if (_owt_passed) {
+            return true;
+        }
+    }
+    // first call, or the last test failed: queue another
+    GcvPipeline_RequestOpenWire();
+    _owt_requested = true;
+    return false;
+#endif
+}
 
+#ifndef TEST_HARDWARE
+static GCV_OP_STATUS_T Gcv_OpenWire(void) {
     LTC6804_STATUS_T res;
     res = LTC6804_OpenWireTest(&ltc6804_config, &ltc6804_state, &ltc6804_owt_res, msTicks);
 
@@ -673,27 +774,29 @@ bool Board_LTC6804_OpenWireTest(void) {
             itoa(ltc6804_owt_res.failed_wire, str, 10);
             Board_Println(str);
             Error_Assert(ERROR_LTC6804_OWT, msTicks);
-            return false;
+            _owt_passed = false;
+            return GCV_OP_ERROR;
         case LTC6804_PEC_ERROR:
             Board_Println("OWT PEC_ERROR");
             Error_Assert(ERROR_LTC6804_PEC,msTicks);
-            return false;
+            _owt_passed = false;
+            return GCV_OP_ERROR;
         case LTC6804_PASS:
             Board_Println("OWT PASS");
-            _ltc6804_owt = false;
-            _ltc6804_last_owt = msTicks;
             Error_Pass(ERROR_LTC6804_OWT);
-            return true;
+            _owt_passed = true;
+            return GCV_OP_PASS;
         case LTC6804_WAITING:
         case LTC6804_WAITING_REFUP:
             // Board_Println("*");
-            return false;
+            return GCV_OP_WAITING;
         default:
             Board_Println("WTF");
-            return false;
+            _owt_passed = false;
+            return GCV_OP_ERROR;
     }
-#endif
 }
+#endif
 
 #ifndef TEST_HARDWARE
 
@@ -0,0 +1,83 @@
+#include "can_rx.h"
+
+#include "board.h"
+#include "bms_utils.h"
+
+static CAN_RX_STATS_T stats;
+
+void CanRx_Init(void) {
+    memset(&stats, 0, sizeof(stats));
+}
+
+// the tables are a handful of entries, a scan beats anything cleverer
+CAN_RX_HANDLER_T CanRx_Lookup(const CAN_RX_ENTRY_T *table, uint8_t table_len, uint32_t key) {
+    uint8_t i;
+    for (i = 0; i < table_len; i++) {
+        if (table[i].key == key) {
+            return table[i].handler;
+        }
+    }
+    return NULL;
+}
+
+uint16_t CanRx_Drain(const CAN_RX_ENTRY_T *table, uint8_t table_len,
+        CAN_RX_POP_T pop, void *msg) {
+    uint32_t drain_start_us = Board_Micros();
+    uint16_t handled = 0;
+    uint16_t polls;
+
+    // errors count towards the cap too, a driver stuck reporting them
+    // must not hang the loop
+    for (polls = 0; polls < CAN_RX_MAX_PER_LOOP; polls++) {
+        uint32_t key;
+        CAN_RX_POP_STATUS_T status = pop(&key, msg);
+        if (status == CAN_RX_EMPTY) {
+            break;
+        } else if (status == CAN_RX_ERROR) {
+            stats.dropped++;
+            continue;
+        }
+
+        handled++;
+        CAN_RX_HANDLER_T handler = CanRx_Lookup(table, table_len, key);
+        if (handler == NULL) {
+            stats.unhandled++;
+            continue;
+        }
+
+        uint32_t start_us = Board_Micros();
+        handler(msg);
+        uint32_t handler_us = Board_Micros() - start_us;
+        if (handler_us > stats.max_handler_us) stats.max_handler_us = handler_us;
+    }
+
+    if (polls == CAN_RX_MAX_PER_LOOP) {
+        stats.capped++;
+    }
+    stats.frames += handled;
+    if (handled > stats.max_per_pass) stats.max_per_pass = handled;
+
+    uint32_t drain_us = Board_Micros() - drain_start_us;
+    if (drain_us > stats.max_drain_us) stats.max_drain_us = drain_us;
+    return handled;
+}
+
+const CAN_RX_STATS_T * CanRx_GetStats(void) {
+    return &stats;
+}
+
+uint8_t CanRx_PackCanFrame(uint8_t *data) {
+    uint16_t dropped = Saturate_u16(stats.dropped);
+    uint16_t unhandled = Saturate_u16(stats.unhandled);
+    uint16_t max_handler_us = Saturate_u16(stats.max_handler_us);
+
+    data[0] = dropped & 0xFF;
+    data[1] = dropped >> 8;
+    data[2] = unhandled & 0xFF;
+    data[3] = unhandled >> 8;
+    data[4] = (stats.max_per_pass > UINT8_MAX) ? UINT8_MAX : stats.max_per_pass;
+    data[5] = (stats.capped > UINT8_MAX) ? UINT8_MAX : stats.capped;
+    data[6] = max_handler_us & 0xFF;
+    data[7] = max_handler_us >> 8;
+    return 8;
+}
@@ -0,0 +1,190 @@
+#include "can_tx.h"
+
+#include "board.h"
+#include "bms_utils.h"
+
+static CAN_TX_FRAME_T frames[CAN_TX_MAX_FRAMES];
+static uint8_t num_frames;
+
+// bus-load budget, as a bucket of bits refilled at the budgeted rate
+static uint32_t baud;
+static int32_t budget_bits;
+static int32_t budget_cap_bits;
+static uint32_t budget_bits_per_ms;
+static uint32_t budget_refill_ms;
+
+// bits sent in the current one second load window
+static uint32_t load_bits;
+static uint32_t load_window_ms;
+static uint8_t load_pct;
+
+#define CAN_TX_LOAD_WINDOW_ms 1000
+
+void CanTx_Init(uint32_t baud_rate, uint8_t budget_pct, uint32_t msTicks) {
+    memset(frames, 0, sizeof(frames));
+    num_frames = 0;
+
+    baud = baud_rate;
+    budget_bits_per_ms = baud_rate / 1000 * budget_pct / 100;
+    budget_cap_bits = budget_bits_per_ms * CAN_TX_BURST_ms;
+    // a small budget still has to fit one full frame
+    if (budget_cap_bits < CanTx_FrameBits(8)) budget_cap_bits = CanTx_FrameBits(8);
+    budget_bits = budget_cap_bits;
+    budget_refill_ms = msTicks;
+
+    load_bits = 0;
+    load_window_ms = msTicks;
+    load_pct = 0;
+}
+
+// SOF, 11 bit id, RTR, IDE, r0, DLC, data and CRC can all be stuffed, one
+// bit in four at worst after the first. CRC delimiter, ACK, EOF and
+// interframe space are not
+uint16_t CanTx_FrameBits(uint8_t dlc) {
+    uint16_t stuffable = 34 + 8 * dlc;
+    return stuffable + 13 + (stuffable - 1) / 4;
+}
+
+uint8_t CanTx_AddFrame(const char *name, CAN_TX_SEND_T send, uint32_t period_ms,
+        uint8_t dlc, uint8_t priority, uint32_t msTicks) {
+    if (num_frames == CAN_TX_MAX_FRAMES || period_ms == 0) {
+        return CAN_TX_MAX_FRAMES;
+    }
+
+    CAN_TX_FRAME_T *frame = &frames[num_frames];
+    memset(frame, 0, sizeof(*frame));
+    frame->name = name;
+    frame->send = send;
+    frame->period_ms = period_ms;
+    frame->bits = CanTx_FrameBits(dlc);
+    frame->priority = priority;
+    frame->next_ms = msTicks + num_frames * CAN_TX_STAGGER_ms;
+    return num_frames++;
+}
+
+static void _refill(uint32_t msTicks) {
+    uint32_t elapsed_ms = msTicks - budget_refill_ms;
+    budget_refill_ms = msTicks;
+    if (budget_bits_per_ms == 0) {
+        return;
+    }
+    // compare before multiplying, elapsed_ms is unbounded after a stall
+    uint32_t room_bits = budget_cap_bits - budget_bits;
+    if (elapsed_ms > room_bits / budget_bits_per_ms) {
+        budget_bits = budget_cap_bits;
+    } else {
+        budget_bits += elapsed_ms * budget_bits_per_ms;
+    }
+}
+
+static void _update_load(uint32_t msTicks) {
+    uint32_t elapsed_ms = msTicks - load_window_ms;
+    if (elapsed_ms < CAN_TX_LOAD_WINDOW_ms) {
+        return;
+    }
+    uint32_t pct = (uint64_t)load_bits * 100 * 1000 / ((uint64_t)baud * elapsed_ms);
+    load_pct = (pct > 100) ? 100 : pct;
+    load_bits = 0;
+    load_window_ms = msTicks;
+}
+
+// mark frames that came due. A period that passes while the frame is still
+// pending is counted and folded into the one transmission, keeping the phase
+static void _release(CAN_TX_FRAME_T *frame, uint32_t msTicks) {
+    if ((int32_t)(msTicks - frame->next_ms) < 0) {
+        return;
+    }
+    uint32_t periods = (msTicks - frame->next_ms) / frame->period_ms + 1;
+    uint32_t missed = frame->missed + periods - 1;
+    if (frame->pending) {
+        missed++;
+    } else {
+        frame->pending = true;
+        frame->due_ms = frame->next_ms;
+    }
+    frame->missed = Saturate_u16(missed);
+    frame->next_ms += periods * frame->period_ms;
+}
+
+// true if a should go before b
+static bool _sends_before(const CAN_TX_FRAME_T *a, const CAN_TX_FRAME_T *b) {
+    if (a->priority != b->priority) {
+        return a->priority < b->priority;
+    }
+    return (int32_t)(a->due_ms - b->due_ms) < 0;
+}
+
+uint8_t CanTx_Run(uint32_t msTicks) {
+    bool polled[CAN_TX_MAX_FRAMES];
+    memset(polled, 0, sizeof(polled));
+    uint8_t sent = 0;
+    uint8_t i;
+
+    _refill(msTicks);
+    _update_load(msTicks);
+    for (i = 0; i < num_frames; i++) {
+        _release(&frames[i], msTicks);
+    }
+
+    while (1) {
+        CAN_TX_FRAME_T *next = NULL;
+        uint8_t next_id = 0;
+        for (i = 0; i < num_frames; i++) {
+            if (polled[i] || !frames[i].pending) continue;
+            if (next == NULL || _sends_before(&frames[i], next)) {
+                next = &frames[i];
+                next_id = i;
+            }
+        }
+
+        if (next == NULL) {
+            return sent;
+        }
+        polled[next_id] = true;
+
+        if (next->priority != CAN_TX_PRIORITY_SAFETY && budget_bits < next->bits) {
+            if (next->deferred < UINT16_MAX) next->deferred++;
+            continue;
+        }
+
+        CAN_TX_STATUS_T status = next->send();
+        if (status == CAN_TX_BUSY) {
+            // every frame shares the mailboxes, the rest would fail too
+            if (next->retries < UINT16_MAX) next->retries++;
+            return sent;
+        }
+
+        if (status == CAN_TX_NOTHING) {
+            next->pending = false;
+            continue;
+        }
+
+        // safety frames may overdraw, which holds the others back until
+        // the bus has had time to carry them
+        budget_bits -= next->bits;
+        if (budget_bits < -budget_cap_bits) budget_bits = -budget_cap_bits;
+        load_bits += next->bits;
+        next->sent++;
+        sent++;
+
+        if (status == CAN_TX_MORE) {
+            polled[next_id] = false;
+            continue;
+        }
+        next->pending = false;
+        uint16_t latency_ms = Saturate_u16(msTicks - next->due_ms);
+        if (latency_ms > next->max_latency_ms) next->max_latency_ms = latency_ms;
+    }
+}
+
+uint8_t CanTx_GetLoad_pct(void) {
+    return load_pct;
+}
+
+uint8_t CanTx_GetFrameCount(void) {
+    return num_frames;
+}
+
+const CAN_TX_FRAME_T * CanTx_GetFrame(uint8_t id) {
+    return &frames[id];
+}
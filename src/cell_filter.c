@@ -0,0 +1,137 @@
+#include "cell_filter.h"
+
+#include <string.h>
+
+#define CELL_FILTER_MAX_CELLS (MAX_NUM_MODULES*MAX_CELLS_PER_MODULE)
+#define CELL_FILTER_IIR_FRAC_BITS 8
+#define CELL_FILTER_MAX_OFFSET_mV 127
+
+#if CELL_FILTER_OUTLIER_MAX > 15
+#error "CELL_FILTER_OUTLIER_MAX must fit the 4 bit reject count"
+#endif
+
+static CELL_FILTER_MODE_T mode;
+static bool seeded;
+static uint32_t rejected;
+static uint16_t rejecting;  // cells with a reject count, to skip the lookups when none has
+
+// only one mode runs at a time, so they share the RAM. Everything is kept
+// relative to the cell's last output, which is the filtered array itself
+static union {
+    int8_t iir_frac[CELL_FILTER_MAX_CELLS];         // IIR state less the output, 1/256 mV
+    struct {
+        int8_t older_mV[CELL_FILTER_MAX_CELLS];     // last two accepted samples
+        int8_t newer_mV[CELL_FILTER_MAX_CELLS];     // less the output
+    } median;
+} state;
+static uint8_t rejects[(CELL_FILTER_MAX_CELLS + 1) / 2]; // outliers in a row, 4 bits per cell
+
+void CellFilter_Init(CELL_FILTER_MODE_T mode_arg) {
+    mode = mode_arg;
+    seeded = false;
+    rejected = 0;
+    memset(rejects, 0, sizeof(rejects));
+    rejecting = 0;
+}
+
+static uint8_t _rejects(uint16_t i) {
+    return (rejects[i / 2] >> ((i % 2) * 4)) & 0x0F;
+}
+
+static void _set_rejects(uint16_t i, uint8_t count) {
+    uint8_t shift = (i % 2) * 4;
+    if (_rejects(i) == 0) {
+        rejecting++;
+    }
+    if (count == 0) {
+        rejecting--;
+    }
+    rejects[i / 2] = (rejects[i / 2] & ~(0x0F << shift)) | (count << shift);
+}
+
+static int8_t _offset(int32_t mV, uint16_t out) {
+    int32_t offset = mV - out;
+    if (offset > CELL_FILTER_MAX_OFFSET_mV) return CELL_FILTER_MAX_OFFSET_mV;
+    if (offset < -CELL_FILTER_MAX_OFFSET_mV) return -CELL_FILTER_MAX_OFFSET_mV;
+    return offset;
+}
+
+static uint16_t _seed(uint16_t i, uint16_t x) {
+    state.iir_frac[i] = 0;
+    if (mode == CELL_FILTER_MEDIAN3) {
+        state.median.older_mV[i] = 0;
+        state.median.newer_mV[i] = 0;
+    }
+    if (_rejects(i) != 0) {
+        _set_rejects(i, 0);
+    }
+    return x;
+}
+
+static int32_t _median3(int32_t a, int32_t b, int32_t c) {
+    int32_t lo = (a < b) ? a : b;
+    int32_t hi = (a < b) ? b : a;
+    if (c <= lo) return lo;
+    if (c >= hi) return hi;
+    return c;
+}
+
+static uint16_t _accept(uint16_t i, uint16_t x, uint16_t last) {
+    if (mode == CELL_FILTER_IIR) {
+        int32_t iir_q8 = ((int32_t)last << CELL_FILTER_IIR_FRAC_BITS) + state.iir_frac[i];
+        iir_q8 += (((int32_t)x << CELL_FILTER_IIR_FRAC_BITS) - iir_q8) >> CELL_FILTER_IIR_SHIFT;
+        uint16_t out = (iir_q8 + (1 << (CELL_FILTER_IIR_FRAC_BITS - 1)))
+                >> CELL_FILTER_IIR_FRAC_BITS;
+        // rounding to the nearest mV leaves -128..127
+        state.iir_frac[i] = iir_q8 - ((int32_t)out << CELL_FILTER_IIR_FRAC_BITS);
+        return out;
+    }
+    int32_t newer = last + state.median.newer_mV[i];
+    uint16_t out = _median3(last + state.median.older_mV[i], newer, x);
+    state.median.older_mV[i] = _offset(newer, out);
+    state.median.newer_mV[i] = _offset(x, out);
+    return out;
+}
+
+void CellFilter_Update(const uint32_t *raw_mV, uint32_t *filtered_mV, uint16_t num_cells) {
+    uint16_t i;
+    if (mode == CELL_FILTER_NONE) {
+        for (i = 0; i < num_cells; i++) {
+            filtered_mV[i] = raw_mV[i];
+        }
+        return;
+    }
+
+    for (i = 0; i < num_cells; i++) {
+        uint16_t x = (raw_mV[i] > UINT16_MAX) ? UINT16_MAX : raw_mV[i];
+        if (!seeded) {
+            filtered_mV[i] = _seed(i, x);
+            continue;
+        }
+        uint16_t last = filtered_mV[i];
+        uint16_t dev = (x > last) ? x - last : last - x;
+        uint8_t count = (rejecting == 0) ? 0 : _rejects(i);
+        if (dev <= CELL_FILTER_OUTLIER_mV) {
+            if (count != 0) {
+                _set_rejects(i, 0);
+            }
+            filtered_mV[i] = _accept(i, x, last);
+        } else if (count < CELL_FILTER_OUTLIER_MAX) {
+            // dropped, the last output stands
+            _set_rejects(i, count + 1);
+            rejected++;
+        } else {
+            // still there after CELL_FILTER_OUTLIER_MAX samples, so it is real
+            filtered_mV[i] = _seed(i, x);
+        }
+    }
+    seeded = true;
+}
+
+CELL_FILTER_MODE_T CellFilter_GetMode(void) {
+    return mode;
+}
+
+uint32_t CellFilter_GetRejected(void) {
+    return rejected;
+}
@@ -0,0 +1,91 @@
+#include "cell_history.h"
+#include "bms_utils.h"
+
+static uint16_t tracked_mV[CELL_HISTORY_LEN];   // tracked cell
+static uint16_t pack_mV[CELL_HISTORY_LEN];      // pack average
+static uint32_t times_ms[CELL_HISTORY_LEN];
+static uint16_t cell;
+static uint8_t newest;
+static uint8_t count;
+
+void CellHistory_Init(void) {
+    cell = 0;
+    newest = 0;
+    count = 0;
+}
+
+static uint8_t _oldest(void) {
+    return (newest + CELL_HISTORY_LEN - (count - 1)) % CELL_HISTORY_LEN;
+}
+
+bool CellHistory_Append(const uint32_t *cell_voltages_mV, uint16_t min_position,
+        uint32_t average_mV, uint32_t msTicks) {
+    if (count != 0 && msTicks - times_ms[newest] < CELL_HISTORY_PERIOD_ms) {
+        return false;
+    }
+
+    if (count == 0
+            || cell_voltages_mV[min_position] + CELL_HISTORY_SWITCH_mV < cell_voltages_mV[cell]) {
+        cell = min_position;
+        count = 0;
+    }
+    newest = (count == 0) ? 0 : (newest + 1) % CELL_HISTORY_LEN;
+    tracked_mV[newest] = Saturate_u16(cell_voltages_mV[cell]);
+    pack_mV[newest] = Saturate_u16(average_mV);
+    times_ms[newest] = msTicks;
+    if (count < CELL_HISTORY_LEN) {
+        count++;
+    }
+    return true;
+}
+
+uint8_t CellHistory_GetCount(void) {
+    return count;
+}
+
+uint32_t CellHistory_GetSpan_ms(void) {
+    if (count == 0) {
+        return 0;
+    }
+    return times_ms[newest] - times_ms[_oldest()];
+}
+
+uint16_t CellHistory_GetCell(void) {
+    return cell;
+}
+
+uint16_t CellHistory_GetSample_mV(uint8_t age) {
+    return tracked_mV[(newest + CELL_HISTORY_LEN - age) % CELL_HISTORY_LEN];
+}
+
+// newest less oldest sample, over the span
+static int32_t _slope_mV_s(const uint16_t *samples_mV) {
+    if (count < 2) {
+        return 0;
+    }
+    int32_t window_mV = (int32_t)samples_mV[newest] - samples_mV[_oldest()];
+    return window_mV * 1000 / (int32_t)CellHistory_GetSpan_ms();
+}
+
+int32_t CellHistory_GetSlope_mV_s(void) {
+    return _slope_mV_s(tracked_mV);
+}
+
+int32_t CellHistory_GetAverageSlope_mV_s(void) {
+    return _slope_mV_s(pack_mV);
+}
+
+uint32_t CellHistory_GetSag_mV_s(uint16_t *position) {
+    if (position) {
+        *position = cell;
+    }
+    if (count < 2) {
+        return 0;
+    }
+    int32_t sag_mV = ((int32_t)pack_mV[newest] - pack_mV[_oldest()])
+            - ((int32_t)tracked_mV[newest] - tracked_mV[_oldest()]);
+    if (sag_mV <= 0) {
+        return 0;
+    }
+    return sag_mV * 1000 / CellHistory_GetSpan_ms();
+}
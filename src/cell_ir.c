@@ -0,0 +1,110 @@
+#include "cell_ir.h"
+
+#define CELL_IR_MAX_uOhm UINT16_MAX
+// keeps dV * 10^6 in 32 bits, a bigger jump is not a resistance anyway
+#define CELL_IR_MAX_DELTA_mV 2000
+
+static uint16_t prev_mV[CELL_IR_WINDOW];     // previous readback of the window
+static uint16_t window_start;
+static int32_t prev_current_mA;
+static uint32_t prev_ms;
+static bool have_prev;
+static uint32_t updates;
+
+void CellIr_Init(void) {
+    have_prev = false;
+    window_start = 0;
+}
+
+static uint16_t _window_end(uint16_t num_cells) {
+    return (num_cells - window_start > CELL_IR_WINDOW) ?
+            window_start + CELL_IR_WINDOW : num_cells;
+}
+
+static void _record(const uint32_t *cell_voltages_mV, uint16_t num_cells,
+        int32_t discharge_current_mA, uint32_t msTicks) {
+    if (window_start >= num_cells) {
+        window_start = 0;
+    }
+    uint16_t end = _window_end(num_cells);
+    uint16_t i;
+    for (i = window_start; i < end; i++) {
+        prev_mV[i - window_start] = (cell_voltages_mV[i] > UINT16_MAX) ?
+                UINT16_MAX : cell_voltages_mV[i];
+    }
+    prev_current_mA = discharge_current_mA;
+    prev_ms = msTicks;
+    have_prev = true;
+}
+
+bool CellIr_Update(const uint32_t *cell_voltages_mV, uint16_t num_cells,
+        int32_t discharge_current_mA, uint32_t msTicks, uint16_t *cell_ir_uOhm) {
+    int32_t step_mA = discharge_current_mA - prev_current_mA;
+    if (!have_prev || msTicks - prev_ms > CELL_IR_MAX_GAP_ms
+            || (step_mA < CELL_IR_MIN_STEP_mA && step_mA > -CELL_IR_MIN_STEP_mA)) {
+        _record(cell_voltages_mV, num_cells, discharge_current_mA, msTicks);
+        return false;
+    }
+
+    bool changed = false;
+    uint16_t end = _window_end(num_cells);
+    uint16_t i;
+    for (i = window_start; i < end; i++) {
+        uint16_t v = (cell_voltages_mV[i] > UINT16_MAX) ? UINT16_MAX : cell_voltages_mV[i];
+        int32_t drop_mV = (int32_t)prev_mV[i - window_start] - v;
+        if (drop_mV > CELL_IR_MAX_DELTA_mV || drop_mV < -CELL_IR_MAX_DELTA_mV) {
+            continue;
+        }
+        int32_t pair_uOhm = drop_mV * 1000000 / step_mA;
+        if (pair_uOhm <= 0 || pair_uOhm > CELL_IR_MAX_uOhm) {
+            continue;
+        }
+        int32_t ir = cell_ir_uOhm[i];
+        if (ir == 0) {
+            ir = pair_uOhm;
+        } else {
+            ir += (pair_uOhm - ir) >> CELL_IR_SHIFT;
+        }
+        if (ir < 1) {
+            ir = 1;
+        }
+        if (ir != cell_ir_uOhm[i]) {
+            cell_ir_uOhm[i] = ir;
+            changed = true;
+        }
+    }
+    if (changed) {
+        updates++;
+    }
+    // the next step measures the next window, from this readback
+    window_start = end;
+    _record(cell_voltages_mV, num_cells, discharge_current_mA, msTicks);
+    return changed;
+}
+
+uint32_t CellIr_GetUpdates(void) {
+    return updates;
+}
+
+uint32_t CellIr_MaxCurrent_mA(const uint32_t *cell_voltages_mV, const uint16_t *cell_ir_uOhm,
+        uint16_t num_cells, uint32_t discharge_current_mA, uint32_t cell_min_mV) {
+    uint32_t limit_A = UINT32_MAX;
+    // amps times uOhm stays in 32 bits, mA would not
+    uint32_t current_A = discharge_current_mA / 1000;
+    uint16_t i;
+    for (i = 0; i < num_cells; i++) {
+        uint32_t ir = cell_ir_uOhm[i];
+        if (ir == 0) {
+            continue;
+        }
+        uint32_t ocv_mV = cell_voltages_mV[i] + current_A * ir / 1000;
+        if (ocv_mV <= cell_min_mV) {
+            return 0;
+        }
+        uint32_t cell_A = (ocv_mV - cell_min_mV) * 1000 / ir;
+        if (cell_A < limit_A) {
+            limit_A = cell_A;
+        }
+    }
+    return (limit_A >= UINT32_MAX / 1000) ? UINT32_MAX : limit_A * 1000;
+}
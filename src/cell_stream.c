@@ -0,0 +1,104 @@
+#include "cell_stream.h"
+
+void CellStream_Init(CELL_STREAM_T *stream) {
+    stream->page = 0;
+}
+
+uint8_t CellStream_NumPages(uint16_t num_values) {
+    return (num_values + CELL_STREAM_VALUES_PER_PAGE - 1) / CELL_STREAM_VALUES_PER_PAGE;
+}
+
+// the pack can shrink between pages when the config is reloaded
+static uint8_t _page(CELL_STREAM_T *stream, uint16_t num_values) {
+    if (stream->page >= CellStream_NumPages(num_values)) {
+        stream->page = 0;
+    }
+    return stream->page;
+}
+
+// header plus the values of this page, returns the index of the first value
+static uint16_t _header(uint8_t page, uint16_t num_values, uint8_t *data, uint8_t *len) {
+    uint16_t first = page * CELL_STREAM_VALUES_PER_PAGE;
+    uint16_t count = num_values - first;
+    if (count > CELL_STREAM_VALUES_PER_PAGE) count = CELL_STREAM_VALUES_PER_PAGE;
+
+    data[0] = page;
+    data[1] = CellStream_NumPages(num_values);
+    *len = CELL_STREAM_PAGE_HEADER + 2 * count;
+    return first;
+}
+
+uint8_t CellStream_PackVoltages(CELL_STREAM_T *stream, const void *cell_voltages_mV,
+        uint16_t num_cells, uint8_t *data) {
+    const uint32_t *values = cell_voltages_mV;
+    if (num_cells == 0) {
+        return 0;
+    }
+    uint8_t len;
+    uint16_t idx = _header(_page(stream, num_cells), num_cells, data, &len);
+    uint8_t pos;
+    for (pos = CELL_STREAM_PAGE_HEADER; pos < len; pos += 2, idx++) {
+        uint32_t mV = values[idx];
+        if (mV > UINT16_MAX) mV = UINT16_MAX;
+        data[pos] = mV & 0xFF;
+        data[pos+1] = mV >> 8;
+    }
+    return len;
+}
+
+uint8_t CellStream_PackTemperatures(CELL_STREAM_T *stream, const void *cell_temperatures_dC,
+        uint16_t num_thermistors, uint8_t *data) {
+    const int16_t *values = cell_temperatures_dC;
+    if (num_thermistors == 0) {
+        return 0;
+    }
+    uint8_t len;
+    uint16_t idx = _header(_page(stream, num_thermistors), num_thermistors, data, &len);
+    uint8_t pos;
+    for (pos = CELL_STREAM_PAGE_HEADER; pos < len; pos += 2, idx++) {
+        uint16_t dC = (uint16_t)values[idx];
+        data[pos] = dC & 0xFF;
+        data[pos+1] = dC >> 8;
+    }
+    return len;
+}
+
+uint8_t CellStream_PackResistances(CELL_STREAM_T *stream, const void *cell_ir_uOhm,
+        uint16_t num_cells, uint8_t *data) {
+    const uint16_t *values = cell_ir_uOhm;
+    if (num_cells == 0) {
+        return 0;
+    }
+    uint8_t len;
+    uint16_t idx = _header(_page(stream, num_cells), num_cells, data, &len);
+    uint8_t pos;
+    for (pos = CELL_STREAM_PAGE_HEADER; pos < len; pos += 2, idx++) {
+        data[pos] = values[idx] & 0xFF;
+        data[pos+1] = values[idx] >> 8;
+    }
+    return len;
+}
+
+bool CellStream_NextPage(CELL_STREAM_T *stream, uint16_t num_values) {
+    stream->page++;
+    if (stream->page >= CellStream_NumPages(num_values)) {
+        stream->page = 0;
+        return true;
+    }
+    return false;
+}
+
+CAN_TX_STATUS_T CellStream_Send(CELL_STREAM_T *stream, uint32_t can_id, CELL_STREAM_PACK_T pack,
+        const void *values, uint16_t num_values, CELL_STREAM_TRANSMIT_T transmit) {
+    uint8_t data[8];
+    uint8_t len = pack(stream, values, num_values, data);
+    if (len == 0) {
+        return CAN_TX_NOTHING;
+    }
+
+    CAN_TX_STATUS_T status = transmit(can_id, data, len);
+    if (status == CAN_TX_BUSY) {
+        return status;
+    }
+    return CellStream_NextPage(stream, num_values) ? CAN_TX_SENT : CAN_TX_MORE;
+}
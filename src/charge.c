@@ -2,13 +2,14 @@
 #include "bms_utils.h"
 
 static uint16_t total_num_cells;
+static uint8_t num_modules;
 static uint32_t cc_charge_voltage_mV;
 static uint32_t cc_charge_current_mA;
 static uint32_t cv_charge_voltage_mV;
 static uint32_t cv_charge_current_mA;
 static uint32_t last_time_above_cv_min_curr;
 
-bool _calc_balance(bool *balance_req, uint32_t *cell_voltages_mV, uint32_t balance_mV, PACK_CONFIG_T *config);
+bool _calc_balance(uint16_t *balance_req, uint32_t *cell_voltages_mV, uint32_t balance_mV, PACK_CONFIG_T *config);
 void _set_output(bool close_contactors, bool charger_on, uint32_t charge_voltage_mV, uint32_t charge_current_mA, BMS_OUTPUT_T *output);
 
 void Charge_Init(BMS_STATE_T *state) {
@@ -18,6 +19,7 @@ void Charge_Init(BMS_STATE_T *state) {
 
 void Charge_Config(PACK_CONFIG_T *pack_config) {
     total_num_cells = Get_Total_Cell_Count(pack_config);
+    num_modules = pack_config->num_modules;
 
     cc_charge_voltage_mV = pack_config->cc_cell_voltage_mV * total_num_cells;
     cc_charge_current_mA = pack_config->cell_capacity_cAh * pack_config->cell_charge_c_rating_cC * pack_config->pack_cells_p / 10;
@@ -64,11 +66,11 @@ void Charge_Step(BMS_INPUT_T *input, BMS_STATE_T *state, BMS_OUTPUT_T *output) {
     switch (state->charge_state) {
         case BMS_CHARGE_OFF:
             _set_output(false, false, 0, 0, output);
-            memset(output->balance_req, 0, sizeof(output->balance_req[0])*total_num_cells);
+            memset(output->balance_req, 0, sizeof(output->balance_req[0])*num_modules);
             break;
         case BMS_CHARGE_INIT:
             _set_output((input->mode_request == BMS_SSM_MODE_CHARGE), false, 0, 0, output);
-            memset(output->balance_req, 0, sizeof(output->balance_req[0])*total_num_cells);
+            memset(output->balance_req, 0, sizeof(output->balance_req[0])*num_modules);
             
             if (input->contactors_closed == output->close_contactors) {
                 if(input->mode_request == BMS_SSM_MODE_CHARGE) {
@@ -108,7 +110,7 @@ void Charge_Step(BMS_INPUT_T *input, BMS_STATE_T *state, BMS_OUTPUT_T *output) {
                 if (input->pack_status->pack_current_mA < state->pack_config->cv_min_current_mA*state->pack_config->pack_cells_p) {
                     if ((input->msTicks - last_time_above_cv_min_curr) >= state->pack_config->cv_min_current_ms) {
                         _set_output(false, false, 0, 0, output);
-                        memset(output->balance_req, 0, sizeof(output->balance_req[0])*total_num_cells);
+                        memset(output->balance_req, 0, sizeof(output->balance_req[0])*num_modules);
                         state->charge_state = BMS_CHARGE_DONE;
                         break;
                     }
@@ -142,7 +144,7 @@ void Charge_Step(BMS_INPUT_T *input, BMS_STATE_T *state, BMS_OUTPUT_T *output) {
             break;
         case BMS_CHARGE_DONE:
             _set_output(false, false, 0, 0, output);
-            memset(output->balance_req, 0, sizeof(output->balance_req[0])*total_num_cells);
+            memset(output->balance_req, 0, sizeof(output->balance_req[0])*num_modules);
 
             // if not in Charge or Balance, that means SSM is trying to switch to another mode so wait for contactors to close
             // if in charge or balance, make sure we don't need to go back to charge or balance
@@ -172,18 +174,23 @@ void Charge_Step(BMS_INPUT_T *input, BMS_STATE_T *state, BMS_OUTPUT_T *output) {
 // checks that each cell is within some threshold of the minimum cell
             //  voltage. uses two different thresholds based on whether 
             //  we were just balancing or not (account for hysteresis)
-bool _calc_balance(bool *balance_req, uint32_t *cell_voltages_mV, uint32_t balance_mV, PACK_CONFIG_T *config) {
-    bool balancing = false;
-    int i;
-    for (i = 0; i < total_num_cells; i++) {
-        if (balance_req[i]) {
-            balance_req[i] = (cell_voltages_mV[i] > balance_mV + config->bal_off_thresh_mV);
-        } else {
-            balance_req[i] = (cell_voltages_mV[i] > balance_mV + config->bal_on_thresh_mV);
+bool _calc_balance(uint16_t *balance_req, uint32_t *cell_voltages_mV, uint32_t balance_mV, PACK_CONFIG_T *config) {
+    uint16_t any = 0;
+    uint16_t cell = 0;
+    uint8_t module, i;
+    for (module = 0; module < num_modules; module++) {
+        uint16_t req = 0;
+        for (i = 0; i < config->module_cell_count[module]; i++, cell++) {
+            uint32_t thresh_mV = ((balance_req[module] >> i) & 1) ?
+                    config->bal_off_thresh_mV : config->bal_on_thresh_mV;
+            if (cell_voltages_mV[cell] > balance_mV + thresh_mV) {
+                req |= 1 << i;
+            }
         }
-        if (balance_req[i]) balancing = true;
+        balance_req[module] = req;
+        any |= req;
     }
-    return balancing;
+    return any != 0;
 }
 
 void _set_output(bool close_contactors, bool charger_on, uint32_t charge_voltage_mV, uint32_t charge_current_mA, BMS_OUTPUT_T *output) {
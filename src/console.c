@@ -6,6 +6,13 @@
 #include "microrl.h"
 #include "console_types.h"
 #include "error_handler.h"
+#include "timing.h"
+#include "scheduler.h"
+#include "soc.h"
+#include "can_rx.h"
+#include "can_tx.h"
+#include "sampling.h"
+#include "cell_history.h"
 
 /***************************************
         Private Variables
@@ -108,6 +115,18 @@ static void get(const char * const * argv) {
                 utoa(bms_state->pack_config->max_cell_temp_dC, tempstr,10);
                 Board_Println(tempstr);
                 break;
+            case RWL_sample_fast_current_mA:
+                utoa(bms_state->pack_config->sample_fast_current_mA, tempstr,10);
+                Board_Println(tempstr);
+                break;
+            case RWL_sample_fast_margin_mV:
+                utoa(bms_state->pack_config->sample_fast_margin_mV, tempstr,10);
+                Board_Println(tempstr);
+                break;
+            case RWL_sample_fast_dvdt_mV_s:
+                utoa(bms_state->pack_config->sample_fast_dvdt_mV_s, tempstr,10);
+                Board_Println(tempstr);
+                break;
             case RWL_LENGTH:
                 break;
         }
@@ -190,6 +209,162 @@ static void get(const char * const * argv) {
                         }
                     }
                     break;
+                case ROL_timing:
+                    // one line per stage: name min max p99 count, in us
+                    for (i = 0; i < TIMING_NUM_STAGES; i++) {
+                        const TIMING_STATS_T * stats = Timing_GetStats(i);
+                        Board_Print_BLOCKING(TIMING_STAGE_NAMES[i]);
+                        Board_Print_BLOCKING(": ");
+                        utoa((stats->count == 0) ? 0 : stats->min_us, tempstr, 10);
+                        Board_Print_BLOCKING(tempstr);
+                        Board_Print_BLOCKING(",");
+                        utoa(stats->max_us, tempstr, 10);
+                        Board_Print_BLOCKING(tempstr);
+                        Board_Print_BLOCKING(",");
+                        utoa(Timing_Percentile_us(i, 99), tempstr, 10);
+                        Board_Print_BLOCKING(tempstr);
+                        Board_Print_BLOCKING(",");
+                        utoa(stats->count, tempstr, 10);
+                        Board_Println_BLOCKING(tempstr);
+                    }
+                    Board_Print_BLOCKING("overruns: ");
+                    utoa(Timing_GetLoopOverruns(), tempstr, 10);
+                    Board_Println_BLOCKING(tempstr);
+                    break;
+                case ROL_tasks:
+                    // one line per task: name period runs overruns max_jitter max_latency max_exec_us
+                    for (i = 0; i < Scheduler_GetTaskCount(); i++) {
+                        const SCHEDULER_TASK_T * task = Scheduler_GetTask(i);
+                        Board_Print_BLOCKING(task->name);
+                        Board_Print_BLOCKING(": ");
+                        utoa(task->period_ms, tempstr, 10);
+                        Board_Print_BLOCKING(tempstr);
+                        Board_Print_BLOCKING(",");
+                        utoa(task->runs, tempstr, 10);
+                        Board_Print_BLOCKING(tempstr);
+                        Board_Print_BLOCKING(",");
+                        utoa(task->overruns, tempstr, 10);
+                        Board_Print_BLOCKING(tempstr);
+                        Board_Print_BLOCKING(",");
+                        utoa(task->max_jitter_ms, tempstr, 10);
+                        Board_Print_BLOCKING(tempstr);
+                        Board_Print_BLOCKING(",");
+                        utoa(task->max_latency_ms, tempstr, 10);
+                        Board_Print_BLOCKING(tempstr);
+                        Board_Print_BLOCKING(",");
+                        utoa(task->max_exec_us, tempstr, 10);
+                        Board_Println_BLOCKING(tempstr);
+                    }
+                    break;
+                case ROL_soc:
+                    // hundredths of a percent
+                    if (SOC_Valid()) {
+                        utoa(SOC_Estimate_cpct(), tempstr, 10);
+                        Board_Println(tempstr);
+                    } else {
+                        Board_Println("unknown");
+                    }
+                    break;
+                case ROL_can_rx:
+                    {
+                        // frames dropped unhandled capped max_per_pass max_handler_us max_drain_us
+                        const CAN_RX_STATS_T * can_rx = CanRx_GetStats();
+                        utoa(can_rx->frames, tempstr, 10);
+                        Board_Print_BLOCKING(tempstr);
+                        Board_Print_BLOCKING(",");
+                        utoa(can_rx->dropped, tempstr, 10);
+                        Board_Print_BLOCKING(tempstr);
+                        Board_Print_BLOCKING(",");
+                        utoa(can_rx->unhandled, tempstr, 10);
+                        Board_Print_BLOCKING(tempstr);
+                        Board_Print_BLOCKING(",");
+                        utoa(can_rx->capped, tempstr, 10);
+                        Board_Print_BLOCKING(tempstr);
+                        Board_Print_BLOCKING(",");
+                        utoa(can_rx->max_per_pass, tempstr, 10);
+                        Board_Print_BLOCKING(tempstr);
+                        Board_Print_BLOCKING(",");
+                        utoa(can_rx->max_handler_us, tempstr, 10);
+                        Board_Print_BLOCKING(tempstr);
+                        Board_Print_BLOCKING(",");
+                        utoa(can_rx->max_drain_us, tempstr, 10);
+                        Board_Println_BLOCKING(tempstr);
+                    }
+                    break;
+                case ROL_can_tx:
+                    // bus load, then one line per frame: name period sent retries deferred missed max_latency
+                    utoa(CanTx_GetLoad_pct(), tempstr, 10);
+                    Board_Print_BLOCKING("load %: ");
+                    Board_Println_BLOCKING(tempstr);
+                    for (i = 0; i < CanTx_GetFrameCount(); i++) {
+                        const CAN_TX_FRAME_T * frame = CanTx_GetFrame(i);
+                        Board_Print_BLOCKING(frame->name);
+                        Board_Print_BLOCKING(": ");
+                        utoa(frame->period_ms, tempstr, 10);
+                        Board_Print_BLOCKING(tempstr);
+                        Board_Print_BLOCKING(",");
+                        utoa(frame->sent, tempstr, 10);
+                        Board_Print_BLOCKING(tempstr);
+                        Board_Print_BLOCKING(",");
+                        utoa(frame->retries, tempstr, 10);
+                        Board_Print_BLOCKING(tempstr);
+                        Board_Print_BLOCKING(",");
+                        utoa(frame->deferred, tempstr, 10);
+                        Board_Print_BLOCKING(tempstr);
+                        Board_Print_BLOCKING(",");
+                        utoa(frame->missed, tempstr, 10);
+                        Board_Print_BLOCKING(tempstr);
+                        Board_Print_BLOCKING(",");
+                        utoa(frame->max_latency_ms, tempstr, 10);
+                        Board_Println_BLOCKING(tempstr);
+                    }
+                    break;
+                case ROL_sampling:
+                    // rate, then the fastest min/max cell dV/dt in mV/s
+                    Board_Print_BLOCKING(SAMPLING_RATE_NAMES[Sampling_GetRate()]);
+                    Board_Print_BLOCKING(",");
+                    utoa(Sampling_GetDvdt_mV_s(), tempstr, 10);
+                    Board_Println_BLOCKING(tempstr);
+                    break;
+                case ROL_cell_sag:
+                    // sag and cell, then the cell's and the pack average's slope in mV/s
+                    utoa(bms_input->pack_status->max_cell_sag_mV_s, tempstr, 10);
+                    Board_Print_BLOCKING(tempstr);
+                    Board_Print_BLOCKING(",");
+                    utoa(bms_input->pack_status->max_cell_sag_position, tempstr, 10);
+                    Board_Println_BLOCKING(tempstr);
+                    itoa(CellHistory_GetSlope_mV_s(), tempstr, 10);
+                    Board_Print_BLOCKING(tempstr);
+                    Board_Print_BLOCKING(",");
+                    itoa(CellHistory_GetAverageSlope_mV_s(), tempstr, 10);
+                    Board_Println_BLOCKING(tempstr);
+                    break;
+                case ROL_cell_ir:
+                    // discharge limit, then every cell's resistance in uOhm, 0 if unknown
+                    if (bms_input->pack_status->cell_ir_limit_mA == UINT32_MAX) {
+                        Board_Println_BLOCKING("no limit");
+                    } else {
+                        utoa(bms_input->pack_status->cell_ir_limit_mA, tempstr, 10);
+                        Board_Println_BLOCKING(tempstr);
+                    }
+                    idx = 0;
+                    for (i = 0; i < bms_state->pack_config->num_modules; i++) {
+                        uint8_t cc = bms_state->pack_config->module_cell_count[i];
+                        utoa(i, tempstr, 10);
+                        Board_Print_BLOCKING("module ");
+                        Board_Print_BLOCKING(tempstr);
+                        Board_Print_BLOCKING(": ");
+                        for (j = 0; j+1 < cc; j++) {
+                            utoa(bms_input->pack_status->cell_ir_uOhm[idx], tempstr, 10);
+                            Board_Print_BLOCKING(tempstr);
+                            Board_Print_BLOCKING(",");
+                            idx++;
+                        }
+                        utoa(bms_input->pack_status->cell_ir_uOhm[idx], tempstr, 10);
+                        Board_Println_BLOCKING(tempstr);
+                        idx++;
+                    }
+                    break;
                 case ROL_LENGTH:
                     break; //how the hell?
             }
@@ -219,7 +394,9 @@ static void set(const char * const * argv) {
     if(foundloc){
         uint8_t ret;
         ret = EEPROM_ChangeConfig(rwloc,my_atou(argv[2]));
-        if(ret != 0) {
+        if(ret == 2) {
+            Board_Println("EEPROM busy, set it again");
+        } else if(ret != 0) {
             Board_Println("Set failed (command not yet implemented?)!");
         }
     } else {
@@ -309,12 +486,22 @@ static void measure(const char * const * argv) {
                 Board_Println("Pack Current: Off");
             }
 
+            if(console_output->measure_binary) {
+                Board_Println("Binary: On");
+            } else {
+                Board_Println("Binary: Off");
+            }
+
         } else if (strcmp(argv[1],"temps") == 0) {
             console_output->measure_temp = !console_output->measure_temp;
 
         } else if (strcmp(argv[1],"voltages") == 0) {
             console_output->measure_voltage = !console_output->measure_voltage;
 
+        } else if (strcmp(argv[1],"binary") == 0) {
+            // framed output for scripts/decode_telemetry.py, see telemetry.h
+            console_output->measure_binary = !console_output->measure_binary;
+
         } else if (strcmp(argv[1],"packcurrent") == 0) {
             console_output->measure_packcurrent = !console_output->measure_packcurrent;
             Board_Println("Not implemented yet!");
@@ -416,6 +603,7 @@ void console_init(BMS_INPUT_T * input, BMS_STATE_T * state, CONSOLE_OUTPUT_T *co
     console_output->measure_voltage = false;
     console_output->measure_packcurrent = false;
     console_output->measure_packvoltage = false;
+    console_output->measure_binary = false;
 }
 
 void executerl(int32_t argc, const char * const * argv){
@@ -0,0 +1,83 @@
+#include "current_sense.h"
+
+#define CURRENT_SENSE_NOMINAL_OFFSET (CURRENT_SENSE_ZERO_COUNTS * CURRENT_SENSE_OVERSAMPLE)
+#define CURRENT_SENSE_MAX_OFFSET (CURRENT_SENSE_MAX_OFFSET_COUNTS * CURRENT_SENSE_OVERSAMPLE)
+
+// written by the sampling interrupt
+static volatile uint32_t acc;
+static volatile uint8_t acc_count;
+static volatile uint32_t reading;
+static volatile uint32_t reading_ms;
+static volatile bool reading_ready;
+
+static uint32_t offset;
+static bool calibrated;
+static uint32_t cal_sum;
+static uint8_t cal_count;
+
+void CurrentSense_Init(void) {
+    acc = 0;
+    acc_count = 0;
+    reading_ready = false;
+    offset = CURRENT_SENSE_NOMINAL_OFFSET;
+    calibrated = false;
+    cal_sum = 0;
+    cal_count = 0;
+}
+
+void CurrentSense_AddSample(uint16_t counts, uint32_t msTicks) {
+    acc += counts;
+    if (++acc_count < CURRENT_SENSE_OVERSAMPLE) {
+        return;
+    }
+    // a reading the main loop has not picked up is overwritten
+    reading = acc;
+    reading_ms = msTicks;
+    reading_ready = true;
+    acc = 0;
+    acc_count = 0;
+}
+
+static void _calibrate(uint32_t sum, bool at_rest) {
+    if (!at_rest) {
+        cal_sum = 0;
+        cal_count = 0;
+        return;
+    }
+    cal_sum += sum;
+    if (++cal_count < CURRENT_SENSE_CAL_READINGS) {
+        return;
+    }
+    uint32_t mean = (cal_sum + CURRENT_SENSE_CAL_READINGS / 2) / CURRENT_SENSE_CAL_READINGS;
+    uint32_t dev = (mean > CURRENT_SENSE_NOMINAL_OFFSET) ?
+            mean - CURRENT_SENSE_NOMINAL_OFFSET : CURRENT_SENSE_NOMINAL_OFFSET - mean;
+    if (dev <= CURRENT_SENSE_MAX_OFFSET) {
+        offset = mean;
+        calibrated = true;
+    }
+    cal_sum = 0;
+    cal_count = 0;
+}
+
+bool CurrentSense_Read(bool at_rest, int32_t *current_mA, uint32_t *sample_ms) {
+    if (!reading_ready) {
+        return false;
+    }
+    // one reading per CURRENT_SENSE_OVERSAMPLE interrupts, far longer than this takes
+    uint32_t sum = reading;
+    *sample_ms = reading_ms;
+    reading_ready = false;
+
+    _calibrate(sum, at_rest);
+    int64_t diff = (int64_t)sum - offset;
+    *current_mA = diff * CURRENT_SENSE_uA_PER_COUNT / (CURRENT_SENSE_OVERSAMPLE * 1000);
+    return true;
+}
+
+bool CurrentSense_IsCalibrated(void) {
+    return calibrated;
+}
+
+uint32_t CurrentSense_GetOffset(void) {
+    return offset;
+}
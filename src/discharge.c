@@ -1,6 +1,7 @@
 #include "discharge.h"
 
 #include "board.h"
+#include "config.h"
 
 #ifdef FSAE_DRIVERS
     #include "fsae_can.h"
@@ -9,6 +10,7 @@
 static uint16_t total_num_cells;
 static uint32_t min_cell_voltage_mV;
 static uint32_t max_pack_current_mA;
+static uint32_t allowed_pack_current_mA;
 static uint16_t max_cell_temp_thres_C;
 // current, temperature, and voltage
 
@@ -24,6 +26,15 @@ uint32_t Calculate_Max_Current(
     return cell_capacity_cAh * discharge_rating_cC * pack_cells_p / 10;
 }
 
+uint32_t Calculate_Allowed_Current(uint32_t max_current_mA, uint32_t cell_sag_mV_s) {
+    if (cell_sag_mV_s <= CELL_SAG_TAPER_mV_s) {
+        return max_current_mA;
+    }
+    uint32_t floor_mA = max_current_mA / 100 * CELL_SAG_TAPER_FLOOR_pct;
+    uint32_t allowed_mA = max_current_mA / cell_sag_mV_s * CELL_SAG_TAPER_mV_s;
+    return (allowed_mA > floor_mA) ? allowed_mA : floor_mA;
+}
+
 void Discharge_Config(PACK_CONFIG_T *pack_config) {
     total_num_cells = Get_Total_Cell_Count(pack_config);
 
@@ -34,6 +45,7 @@ void Discharge_Config(PACK_CONFIG_T *pack_config) {
                             pack_config->cell_discharge_c_rating_cC,
                             pack_config->pack_cells_p,
                             max_cell_temp_thres_C); // approx. initialization pt
+    allowed_pack_current_mA = max_pack_current_mA;
 }
 
 void Discharge_Step(BMS_INPUT_T *input, BMS_STATE_T *state, BMS_OUTPUT_T *output) {
@@ -74,6 +86,13 @@ handler:
                                     state->pack_config->cell_discharge_c_rating_cC,
                                     state->pack_config->pack_cells_p,
                                     input->pack_status->max_cell_temp_dC);
+            // a sagging cell lowers what we ask for, not the over current limit
+            allowed_pack_current_mA = Calculate_Allowed_Current(max_pack_current_mA,
+                                    input->pack_status->max_cell_sag_mV_s);
+            // and so does the weakest cell's resistance (see cell_ir.h)
+            if (input->pack_status->cell_ir_limit_mA < allowed_pack_current_mA) {
+                allowed_pack_current_mA = input->pack_status->cell_ir_limit_mA;
+            }
             if(input->pack_status->pack_current_mA > max_pack_current_mA) {
                 Error_Assert(ERROR_OVER_CURRENT, input->msTicks);
             } else {
@@ -114,3 +133,19 @@ handler:
 uint32_t Read_Max_Current(void) {
     return max_pack_current_mA;
 }
+
+uint32_t Read_Allowed_Current(void) {
+    return allowed_pack_current_mA;
+}
+
+uint8_t Discharge_PackCanFrame(uint8_t *data) {
+    data[0] = allowed_pack_current_mA & 0xFF;
+    data[1] = (allowed_pack_current_mA >> 8) & 0xFF;
+    data[2] = (allowed_pack_current_mA >> 16) & 0xFF;
+    data[3] = allowed_pack_current_mA >> 24;
+    data[4] = max_pack_current_mA & 0xFF;
+    data[5] = (max_pack_current_mA >> 8) & 0xFF;
+    data[6] = (max_pack_current_mA >> 16) & 0xFF;
+    data[7] = max_pack_current_mA >> 24;
+    return 8;
+}
@@ -0,0 +1,194 @@
+#include "eeprom_async.h"
+
+#include <string.h>
+#include "lc1024.h"
+#include "error_handler.h"
+
+#define LC1024_STATUS_WIP 0x01 // write in progress bit of the status register
+
+extern volatile uint32_t msTicks;
+
+static EEPROM_ASYNC_REQ_T queue[EEPROM_ASYNC_QUEUE_LEN];
+static uint8_t queue_head;
+static uint8_t queue_count;
+static bool head_started;           // head request has been sent to the LC1024
+static uint32_t write_start_ms;
+
+static EEPROM_ASYNC_REQ_T * _entry(uint8_t pos) {
+    return &queue[(queue_head + pos) % EEPROM_ASYNC_QUEUE_LEN];
+}
+
+// queue position of a waiting write the dirty range [start, end) of block
+// can be merged into, or queue_count if there is none
+static uint8_t _find_mergeable(uint32_t block_address, uint8_t start, uint8_t end,
+        EEPROM_ASYNC_CALLBACK callback) {
+    uint8_t first = head_started ? 1 : 0;
+    uint8_t pos;
+    for (pos = queue_count; pos > first; pos--) {
+        EEPROM_ASYNC_REQ_T *req = _entry(pos - 1);
+        if (req->op == EEPROM_ASYNC_READ) {
+            // a queued read must not see bytes written after it
+            break;
+        }
+        if (req->address == block_address
+                && start <= req->dirty_end && end >= req->dirty_start) {
+            if (req->callback == NULL || req->callback == callback) {
+                return pos - 1;
+            }
+            // merging into an older write would let this one's bytes,
+            // queued before ours, land last
+            break;
+        }
+    }
+    return queue_count;
+}
+
+static void _address_bytes(uint32_t address, uint8_t *bytes) {
+    bytes[0] = (address >> 16) & 0xFF;
+    bytes[1] = (address >> 8) & 0xFF;
+    bytes[2] = address & 0xFF;
+}
+
+static void _complete(bool success) {
+    EEPROM_ASYNC_CALLBACK callback = queue[queue_head].callback;
+    queue_head = (queue_head + 1) % EEPROM_ASYNC_QUEUE_LEN;
+    queue_count--;
+    head_started = false;
+    if (callback) {
+        callback(success);
+    }
+}
+
+void EEPROM_Async_Init(void) {
+    queue_head = 0;
+    queue_count = 0;
+    head_started = false;
+}
+
+bool EEPROM_Async_Write(uint32_t address, const uint8_t *data, uint16_t length,
+        EEPROM_ASYNC_CALLBACK callback) {
+    if (length == 0) {
+        return true;
+    }
+
+    // first pass: make sure every block has a slot before queueing anything
+    uint8_t new_slots = 0;
+    uint32_t addr = address;
+    uint32_t end_address = address + length;
+    while (addr < end_address) {
+        uint32_t block_address = addr - (addr % EEPROM_ASYNC_BLOCK_SIZE);
+        uint32_t block_end = block_address + EEPROM_ASYNC_BLOCK_SIZE;
+        uint32_t chunk_end = (end_address < block_end) ? end_address : block_end;
+        if (_find_mergeable(block_address, addr - block_address, chunk_end - block_address,
+                    callback) == queue_count) {
+            new_slots++;
+        }
+        addr = chunk_end;
+    }
+    if (queue_count + new_slots > EEPROM_ASYNC_QUEUE_LEN) {
+        return false;
+    }
+
+    // second pass: copy the data in, the callback goes on the last
+    // request in queue order that holds any of it
+    EEPROM_ASYNC_REQ_T *last = NULL;
+    uint8_t last_pos = 0;
+    addr = address;
+    while (addr < end_address) {
+        uint32_t block_address = addr - (addr % EEPROM_ASYNC_BLOCK_SIZE);
+        uint32_t block_end = block_address + EEPROM_ASYNC_BLOCK_SIZE;
+        uint32_t chunk_end = (end_address < block_end) ? end_address : block_end;
+        uint8_t start = addr - block_address;
+        uint8_t end = chunk_end - block_address;
+
+        uint8_t pos = _find_mergeable(block_address, start, end, callback);
+        EEPROM_ASYNC_REQ_T *req = _entry(pos);
+        if (pos == queue_count) {
+            req->op = EEPROM_ASYNC_WRITE;
+            req->address = block_address;
+            req->dirty_start = start;
+            req->dirty_end = end;
+            req->callback = NULL;
+            queue_count++;
+        } else {
+            if (start < req->dirty_start) req->dirty_start = start;
+            if (end > req->dirty_end) req->dirty_end = end;
+        }
+        memcpy(&req->block[start], &data[addr - address], end - start);
+
+        if (last == NULL || pos >= last_pos) {
+            last = req;
+            last_pos = pos;
+        }
+        addr = chunk_end;
+    }
+    last->callback = callback;
+    return true;
+}
+
+bool EEPROM_Async_Read(uint32_t address, uint8_t *buf, uint8_t length,
+        EEPROM_ASYNC_CALLBACK callback) {
+    if (queue_count == EEPROM_ASYNC_QUEUE_LEN) {
+        return false;
+    }
+
+    EEPROM_ASYNC_REQ_T *req = _entry(queue_count);
+    req->op = EEPROM_ASYNC_READ;
+    req->address = address;
+    req->length = length;
+    req->read_buf = buf;
+    req->callback = callback;
+    queue_count++;
+    return true;
+}
+
+void EEPROM_Async_Service(uint32_t msTicks) {
+    if (queue_count == 0) {
+        return;
+    }
+
+    EEPROM_ASYNC_REQ_T *req = &queue[queue_head];
+    uint8_t address[3]; // LC1024 eeprom address length is 3 bytes
+
+    if (!head_started) {
+        if (req->op == EEPROM_ASYNC_READ) {
+            _address_bytes(req->address, address);
+            LC1024_ReadMem(address, req->read_buf, req->length);
+            _complete(true);
+        } else {
+            _address_bytes(req->address + req->dirty_start, address);
+            LC1024_WriteEnable();
+            LC1024_WriteEnable();
+            LC1024_WriteMem(address, &req->block[req->dirty_start],
+                    req->dirty_end - req->dirty_start);
+            head_started = true;
+            write_start_ms = msTicks;
+        }
+        return;
+    }
+
+    // write in progress, reads and the next write have to wait for it
+    uint8_t status = LC1024_STATUS_WIP;
+    LC1024_ReadStatusReg(&status);
+    if (!(status & LC1024_STATUS_WIP)) {
+        Error_Pass(ERROR_EEPROM);
+        _complete(true);
+    } else if (msTicks - write_start_ms > EEPROM_ASYNC_WRITE_TIMEOUT_ms) {
+        Error_Assert(ERROR_EEPROM, msTicks);
+        _complete(false);
+    }
+}
+
+void EEPROM_Async_Flush(void) {
+    while (queue_count > 0) {
+        EEPROM_Async_Service(msTicks);
+    }
+}
+
+bool EEPROM_Async_Idle(void) {
+    return queue_count == 0;
+}
+
+uint8_t EEPROM_Async_QueueLength(void) {
+    return queue_count;
+}
@@ -1,23 +1,30 @@
 #include "eeprom_config.h"
+#include "eeprom_async.h"
 #include "error_handler.h"
 #include "board.h"
 
 
 #define DATA_BLOCK_SIZE sizeof(PACK_CONFIG_T) + ERROR_BYTESIZE + CHECKSUM_BYTESIZE + VERSION_BYTESIZE + MAX_NUM_MODULES
 #define CC_PAGE_SZ 64
+// version, cell count (2 bytes), checksum, then the resistances
+#define CELL_IR_HEADER_SZ 4
+#define CELL_IR_READ_SZ 192
+
 static uint8_t eeprom_data_buf[DATA_BLOCK_SIZE];
 static PACK_CONFIG_T eeprom_packconf_buf;
 static uint8_t mcc[MAX_NUM_MODULES];
-static uint8_t eeprom_data_addr_pckcfg[3]; // LC1024 eeprom address length is 3 bytes
-static uint8_t eeprom_data_addr_cc[3];
 static uint8_t saved_bms_error;
+// RAM copy of the CC page, loaded once and kept in sync with every write
+static uint8_t cc_page_buf[CC_PAGE_SZ];
+static bool cc_page_loaded;
 
 
 static bool Validate_PackConfig(PACK_CONFIG_T *pack_config, uint16_t version, uint8_t checksum);
 static uint8_t Calculate_Checksum(PACK_CONFIG_T *pack_config);
 static void Load_PackConfig_Defaults(PACK_CONFIG_T *pack_config);
 static void Zero_EEPROM_DataBuffer(void);
-static void Write_PackConfig_EEPROM(void);
+static bool Write_PackConfig_EEPROM(void);
+static void Load_CCPage(void);
 // static void Print_EEPROM_DataBuffer(void);
 // static void Run_EEPROM_Test(void);
 
@@ -69,89 +76,145 @@ static void Zero_EEPROM_DataBuffer(void) {
 
 void EEPROM_Init(LPC_SSP_T *pSSP, uint32_t baud, uint8_t cs_gpio, uint8_t cs_pin){
     LC1024_Init(pSSP, baud, cs_gpio, cs_pin);
-
-    eeprom_data_addr_pckcfg[0] = EEPROM_DATA_START_PCKCFG >> 16;
-    eeprom_data_addr_pckcfg[1] = (EEPROM_DATA_START_PCKCFG & 0xFF00) >> 8;
-    eeprom_data_addr_pckcfg[2] = (EEPROM_DATA_START_PCKCFG & 0xFF);
-
-    eeprom_data_addr_cc[0] = EEPROM_DATA_START_CC >> 16;
-    eeprom_data_addr_cc[1] = (EEPROM_DATA_START_CC & 0xFF00) >> 8;
-    eeprom_data_addr_cc[2] = (EEPROM_DATA_START_CC & 0xFF);
+    EEPROM_Async_Init();
 
     // Run_EEPROM_Test();
 
     Zero_EEPROM_DataBuffer();
     eeprom_packconf_buf.module_cell_count = mcc;
     saved_bms_error = 255;
+    cc_page_loaded = false;
 
     Board_Println_BLOCKING("Finished EEPROM init...");
-    Board_BlockingDelay(200);
 }
 
-void EEPROM_WriteCCPage(uint32_t *cc) {
-    Board_Println_BLOCKING("Writing CC Page to EEPROM...");
-    memcpy(eeprom_data_buf, cc, CC_PAGE_SZ);
-    LC1024_WriteEnable();
-    LC1024_WriteEnable();
-    LC1024_WriteMem(eeprom_data_addr_cc, eeprom_data_buf, CC_PAGE_SZ);
-    Board_BlockingDelay(150);
-    Board_Println_BLOCKING("Done writing CC Page to EEPROM...");
+// blocking, only done once before the first CC page access
+static void Load_CCPage(void) {
+    EEPROM_Async_Flush(); // make room and let pending writes land first
+    EEPROM_Async_Read(EEPROM_DATA_START_CC, cc_page_buf, CC_PAGE_SZ, NULL);
+    EEPROM_Async_Flush();
+    cc_page_loaded = true;
+}
+
+// a full queue is backpressure, not a fault: false and the caller retries
+bool EEPROM_WriteCCPage(uint32_t *cc) {
+    memcpy(cc_page_buf, cc, CC_PAGE_SZ);
+    cc_page_loaded = true;
+    return EEPROM_Async_Write(EEPROM_DATA_START_CC, cc_page_buf, CC_PAGE_SZ, NULL);
 }
 
 void EEPROM_LoadCCPage(uint32_t *cc) {
-    Board_Println_BLOCKING("Loading CC Page from EEPROM...");
-    LC1024_WriteEnable();
-    LC1024_WriteEnable();
-    LC1024_ReadMem(eeprom_data_addr_cc, eeprom_data_buf, CC_PAGE_SZ);
-    Board_BlockingDelay(150);
-    memcpy(cc, eeprom_data_buf, CC_PAGE_SZ);
-    Board_Println_BLOCKING("Done loading CC Page from EEPROM...");
+    if (!cc_page_loaded) {
+        Load_CCPage();
+    }
+    memcpy(cc, cc_page_buf, CC_PAGE_SZ);
 }
 
-// idx should be from 0-63 inclusive
-void EEPROM_WriteCCPage_Num(uint8_t idx, uint32_t val) {
-    Board_Println_BLOCKING("Writing CC Num to EEPROM...");
+// idx should be from 0-15 inclusive
+bool EEPROM_WriteCCPage_Num(uint8_t idx, uint32_t val) {
+    if (!cc_page_loaded) {
+        Load_CCPage();
+    }
+
+    cc_page_buf[idx<<2] = val >> 24;
+    cc_page_buf[(idx<<2)+1] = (val & 0x00FF0000) >> 16;
+    cc_page_buf[(idx<<2)+2] = (val & 0x0000FF00) >> 8;
+    cc_page_buf[(idx<<2)+3] = (val & 0x000000FF);
 
-    LC1024_WriteEnable();
-    LC1024_WriteEnable();
-    LC1024_ReadMem(eeprom_data_addr_cc, eeprom_data_buf, CC_PAGE_SZ);
-    Board_BlockingDelay(150);
+    // repeated writes to the page are merged while they wait in the queue
+    return EEPROM_Async_Write(EEPROM_DATA_START_CC + (idx<<2), &cc_page_buf[idx<<2], 4, NULL);
+}
 
-    eeprom_data_buf[idx<<2] = val >> 24;
-    eeprom_data_buf[(idx<<2)+1] = (val & 0x00FF0000) >> 16;
-    eeprom_data_buf[(idx<<2)+2] = (val & 0x0000FF00) >> 8;
-    eeprom_data_buf[(idx<<2)+3] = (val & 0x000000FF);
+// idx should be from 0-15 inclusive
+uint32_t EEPROM_LoadCCPage_Num(uint8_t idx) {
+    if (!cc_page_loaded) {
+        Load_CCPage();
+    }
+    return ((cc_page_buf[idx<<2] << 24) 
+            + (cc_page_buf[(idx<<2)+1] << 16)
+            + (cc_page_buf[(idx<<2)+2] << 8)
+            + cc_page_buf[(idx<<2)+3]);
+}
+
+static uint8_t Calculate_CellIR_Checksum(const uint16_t *cell_ir_uOhm, uint16_t num_cells) {
+    const uint8_t *data = (const uint8_t *) cell_ir_uOhm;
+    uint8_t checksum = 0;
+    uint16_t i;
+    for (i = 0; i < num_cells * sizeof(uint16_t); i++) {
+        checksum += data[i];
+    }
+    return checksum;
+}
 
-    LC1024_WriteEnable();
-    LC1024_WriteEnable();
-    LC1024_WriteMem(eeprom_data_addr_cc, eeprom_data_buf, CC_PAGE_SZ);
-    Board_BlockingDelay(150);
+bool EEPROM_LoadCellIR(uint16_t *cell_ir_uOhm, uint16_t num_cells) {
+    uint8_t header[CELL_IR_HEADER_SZ];
+    uint8_t *data = (uint8_t *) cell_ir_uOhm;
+    uint16_t size = num_cells * sizeof(uint16_t);
+    uint16_t i;
+
+    EEPROM_Async_Flush(); // make room and let pending writes land first
+    EEPROM_Async_Read(EEPROM_DATA_START_CELL_IR, header, CELL_IR_HEADER_SZ, NULL);
+    EEPROM_Async_Flush();
+    if (header[0] == CELL_IR_STORAGE_VERSION
+            && (header[1] | (header[2] << 8)) == num_cells) {
+        // reads are at most 255 bytes
+        for (i = 0; i < size; i += CELL_IR_READ_SZ) {
+            uint16_t len = size - i;
+            if (len > CELL_IR_READ_SZ) len = CELL_IR_READ_SZ;
+            EEPROM_Async_Read(EEPROM_DATA_START_CELL_IR + CELL_IR_HEADER_SZ + i,
+                    &data[i], len, NULL);
+            EEPROM_Async_Flush();
+        }
+        if (Calculate_CellIR_Checksum(cell_ir_uOhm, num_cells) == header[3]) {
+            Board_Println_BLOCKING("Loaded cell resistances from EEPROM");
+            return true;
+        }
+    }
 
-    Board_Println_BLOCKING("Done writing CC Num to EEPROM...");
+    Board_Println_BLOCKING("No saved cell resistances for this pack");
+    for (i = 0; i < num_cells; i++) {
+        cell_ir_uOhm[i] = 0;
+    }
+    return false;
 }
 
-// idx should be from 0-63 inclusive
-uint32_t EEPROM_LoadCCPage_Num(uint8_t idx) {
-    Board_Println_BLOCKING("Loading CC Num from EEPROM...");
-    LC1024_WriteEnable();
-    LC1024_WriteEnable();
-    LC1024_ReadMem(eeprom_data_addr_cc, eeprom_data_buf, CC_PAGE_SZ);
-    Board_BlockingDelay(150);
-    Board_Println_BLOCKING("Done loading CC Num from EEPROM...");
-    return ((eeprom_data_buf[idx<<2] << 24) 
-            + (eeprom_data_buf[(idx<<2)+1] << 16)
-            + (eeprom_data_buf[(idx<<2)+2] << 8)
-            + eeprom_data_buf[(idx<<2)+3]);
+bool EEPROM_WriteCellIR(const uint16_t *cell_ir_uOhm, uint16_t num_cells, uint16_t *offset) {
+    const uint8_t *data = (const uint8_t *) cell_ir_uOhm;
+    uint16_t size = CELL_IR_HEADER_SZ + num_cells * sizeof(uint16_t);
+    uint8_t header[CELL_IR_HEADER_SZ];
+    uint8_t block[EEPROM_ASYNC_BLOCK_SIZE];
+
+    header[0] = CELL_IR_STORAGE_VERSION;
+    header[1] = num_cells & 0xFF;
+    header[2] = num_cells >> 8;
+    header[3] = (*offset < CELL_IR_HEADER_SZ) ?
+            Calculate_CellIR_Checksum(cell_ir_uOhm, num_cells) : 0;
+
+    // one queue slot per block, the rest waits for the next call
+    while (*offset < size) {
+        uint32_t address = EEPROM_DATA_START_CELL_IR + *offset;
+        uint16_t len = EEPROM_ASYNC_BLOCK_SIZE - (address % EEPROM_ASYNC_BLOCK_SIZE);
+        if (len > size - *offset) len = size - *offset;
+        uint16_t i;
+        for (i = 0; i < len; i++) {
+            uint16_t pos = *offset + i;
+            block[i] = (pos < CELL_IR_HEADER_SZ) ? header[pos] : data[pos - CELL_IR_HEADER_SZ];
+        }
+        if (!EEPROM_Async_Write(address, block, len, NULL)) {
+            return false;
+        }
+        *offset += len;
+    }
+    return true;
 }
 
 // entry from Process_Output(..) in main.c, executed during start
 bool EEPROM_LoadPackConfig(PACK_CONFIG_T *pack_config) {
 
     Board_Println_BLOCKING("Loading PackConfig from EEPROM...");
-    LC1024_WriteEnable();
-    LC1024_WriteEnable();
-    LC1024_ReadMem(eeprom_data_addr_pckcfg, eeprom_data_buf, DATA_BLOCK_SIZE);
-    Board_BlockingDelay(200);
+    EEPROM_Async_Flush(); // make room and let pending writes land first
+    EEPROM_Async_Read(EEPROM_DATA_START_PCKCFG, eeprom_data_buf, DATA_BLOCK_SIZE, NULL);
+    EEPROM_Async_Flush();
 
     // offset in the below line: we do not copy module cell count ptr (1 byte)
     // loading into the eeprom driver packconfig buffer
@@ -204,17 +267,20 @@ void Set_EEPROM_Error(uint8_t error) {
     saved_bms_error = error;
 }
 
+// called from the forced hang, where nothing services the queue afterwards
 void Write_EEPROM_Error(void) {
+    EEPROM_Async_Flush(); // make room, the write below must not be dropped
     Write_PackConfig_EEPROM();
+    EEPROM_Async_Flush();
 }
 
 void Write_EEPROM_PackConfig_Defaults(void) {
     Board_Println_BLOCKING("Using pre-configured defaults...");
-    LC1024_WriteEnable();
-    LC1024_WriteEnable();
     Load_PackConfig_Defaults(&eeprom_packconf_buf);
     Board_Println_BLOCKING("Finished loading pre-configured defaults...");
+    EEPROM_Async_Flush(); // make room, the write below must not be dropped
     Write_PackConfig_EEPROM();
+    EEPROM_Async_Flush();
     Board_Println_BLOCKING("Wrote pre-configured defaults to EEPROM.");
 }
 
@@ -232,6 +298,9 @@ static void Load_PackConfig_Defaults(PACK_CONFIG_T *pack_config) {
     pack_config->cc_cell_voltage_mV = CC_CELL_VOLTAGE_mV;
     pack_config->cell_discharge_c_rating_cC = CELL_DISCHARGE_C_RATING_cC;
     pack_config->max_cell_temp_dC = MAX_CELL_TEMP_dC;
+    pack_config->sample_fast_current_mA = SAMPLE_FAST_CURRENT_mA;
+    pack_config->sample_fast_margin_mV = SAMPLE_FAST_MARGIN_mV;
+    pack_config->sample_fast_dvdt_mV_s = SAMPLE_FAST_DVDT_mV_s;
 
     // FSAE specific pack configurations
 #ifdef FSAE_DRIVERS
@@ -291,15 +360,24 @@ uint8_t EEPROM_ChangeConfig(rw_loc_label_t rw_loc, uint32_t val) {
         case RWL_max_cell_temp_dC:
             eeprom_packconf_buf.max_cell_temp_dC = val;
             break;
+        case RWL_sample_fast_current_mA:
+            eeprom_packconf_buf.sample_fast_current_mA = val;
+            break;
+        case RWL_sample_fast_margin_mV:
+            eeprom_packconf_buf.sample_fast_margin_mV = val;
+            break;
+        case RWL_sample_fast_dvdt_mV_s:
+            eeprom_packconf_buf.sample_fast_dvdt_mV_s = val;
+            break;
         case RWL_LENGTH:
             break;
     }
 
-    Write_PackConfig_EEPROM();
-    return 0;
+    // the change stays in eeprom_packconf_buf, so setting it again retries
+    return Write_PackConfig_EEPROM() ? 0 : 2;
 }
 
-static void Write_PackConfig_EEPROM(void) {
+static bool Write_PackConfig_EEPROM(void) {
     // offset in the below line: we do not copy the module cell count ptr (1 byte) 
     memcpy(eeprom_data_buf, &eeprom_packconf_buf, sizeof(PACK_CONFIG_T)-sizeof(void*)); 
     memcpy(&eeprom_data_buf[sizeof(PACK_CONFIG_T)], mcc, MAX_NUM_MODULES); 
@@ -307,13 +385,8 @@ static void Write_PackConfig_EEPROM(void) {
     eeprom_data_buf[DATA_BLOCK_SIZE - CHECKSUM_BYTESIZE - ERROR_BYTESIZE] = Calculate_Checksum(&eeprom_packconf_buf);
     eeprom_data_buf[DATA_BLOCK_SIZE - ERROR_BYTESIZE] = saved_bms_error;
 
-
-    LC1024_WriteEnable();
-    LC1024_WriteEnable();
-
-    LC1024_WriteMem(eeprom_data_addr_pckcfg, eeprom_data_buf, DATA_BLOCK_SIZE);
-    Board_BlockingDelay(200);
-    Board_Println_BLOCKING("Finished writing pack config to EEPROM.");
+    // the data is copied into the queue, eeprom_data_buf is free again on return
+    return EEPROM_Async_Write(EEPROM_DATA_START_PCKCFG, eeprom_data_buf, DATA_BLOCK_SIZE, NULL);
 }
 
 
@@ -344,6 +417,7 @@ static bool Validate_PackConfig(PACK_CONFIG_T *pack_config, uint16_t version, ui
     check &= pack_config->num_modules < 30;
     check &= pack_config->bal_on_thresh_mV < 1000;
     check &= pack_config->bal_off_thresh_mV < 1000;
+    check &= pack_config->sample_fast_margin_mV < 1000;
     if(!check) {
         Board_Println_BLOCKING("Values in PACK_CONFIG are nonsensical! Pack validation failed!");
         return false;
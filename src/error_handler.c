@@ -11,6 +11,7 @@
 #define CAN_timeout_count 				5
 #define EEPROM_timeout_count  			5
 #define CONFLICTING_MODE_REQUESTS_count   2
+#define PACK_VOLTAGE_MISMATCH_count       2
 
 #ifdef FSAE_DRIVERS
 
@@ -44,7 +45,8 @@ static ERROR_HANDLER error_handler_vector[ERROR_NUM_ERRORS] = {
                             {_Error_Handle_Timeout, OVER_CURRENT_timeout_ms},
                             {_Error_Handle_Count, 	BRUSA_timeout_count},
                             {_Error_Handle_Count, 	CAN_timeout_count},
-                            {_Error_Handle_Count,   CONFLICTING_MODE_REQUESTS_count}
+                            {_Error_Handle_Count,   CONFLICTING_MODE_REQUESTS_count},
+                            {_Error_Handle_Count,   PACK_VOLTAGE_MISMATCH_count}
 #ifdef FSAE_DRIVERS
                             ,{_Error_Handle_Count,  VCU_DEAD_count}
                             ,{_Error_Handle_Count,  CONTROL_FLOW_count}
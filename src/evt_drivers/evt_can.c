@@ -1,54 +1,97 @@
 #include "evt_can.h"
 
+#include <string.h>
+
 #include "board.h"
 #include "brusa.h"
 #include "can.h"
 #include "error_handler.h"
+#include "timing.h"
+#include "can_rx.h"
+#include "can_tx.h"
+#include "cell_stream.h"
+#include "bms_utils.h"
+#include "sample_sync.h"
+#include "current_sense.h"
+#include "discharge.h"
+
+// [TODO] Make timing.h that has this (or board.h)
+// Make python script generate
+#define NLG5_CTL_DLY_mS 99
 
-static uint32_t _last_brusa_ctrl = 0;
 static volatile uint32_t *msTicksPtr;
 
+// send callbacks reach the bms structs through these while CanTx_Run is running
+static BMS_INPUT_T *_tx_input;
+static BMS_STATE_T *_tx_state;
+static BMS_OUTPUT_T *_tx_output;
+
+static CELL_STREAM_T _voltage_stream;
+static CELL_STREAM_T _temperature_stream;
+static CELL_STREAM_T _ir_stream;
+
+// handlers reach the bms structs through these while a drain is running
+static BMS_INPUT_T *_rx_input;
+static BMS_OUTPUT_T *_rx_output;
+
+static CAN_RX_POP_STATUS_T Pop_Rx_Msg(uint32_t *key, void *msg);
+static void Receive_Brusa_ActI(void *msg);
+static void Receive_Brusa_Err(void *msg);
+static void Receive_Ignored(void *msg);
+
+static CAN_TX_STATUS_T Send_Brusa_Ctrl(void);
+static CAN_TX_STATUS_T Send_Timing(void);
+static CAN_TX_STATUS_T Send_CanRx(void);
+static CAN_TX_STATUS_T Send_CellVoltageStream(void);
+static CAN_TX_STATUS_T Send_CellTempStream(void);
+static CAN_TX_STATUS_T Send_CellIrStream(void);
+static CAN_TX_STATUS_T Send_CurrentLimit(void);
+static CAN_TX_STATUS_T Transmit(CCAN_MSG_OBJ_T *msg);
+
+static const CAN_RX_ENTRY_T rx_handlers[] = {
+    {NLG5_STATUS, Receive_Ignored}, // [TODO] use info from brusa message
+    {NLG5_ACT_I, Receive_Brusa_ActI},
+    {NLG5_ACT_II, Receive_Ignored},
+    {NLG5_TEMP, Receive_Ignored},
+    {NLG5_ERR, Receive_Brusa_Err}
+};
+
 void Evt_Can_Init(uint32_t baudRateHz, volatile uint32_t* msTicksPtrArg) {
     CAN_Init(baudRateHz, msTicksPtr);
     msTicksPtr = msTicksPtrArg;
+    CanRx_Init();
+
+    uint32_t msTicks = *msTicksPtrArg;
+    CanTx_Init(baudRateHz, CAN_TX_BUS_LOAD_pct, msTicks);
+    CanTx_AddFrame("brusa_ctrl", Send_Brusa_Ctrl, NLG5_CTL_DLY_mS,
+            8, CAN_TX_PRIORITY_SAFETY, msTicks);
+    CanTx_AddFrame("timing", Send_Timing, TIMING_CAN_PERIOD_ms, 8, 1, msTicks);
+    CanTx_AddFrame("can_rx", Send_CanRx, TIMING_CAN_PERIOD_ms, 8, 1, msTicks);
+
+    CellStream_Init(&_voltage_stream);
+    CellStream_Init(&_temperature_stream);
+    CellStream_Init(&_ir_stream);
+    CanTx_AddFrame("cell_voltages", Send_CellVoltageStream, CELL_STREAM_VOLTAGE_PERIOD_ms,
+            8, 2, msTicks);
+    CanTx_AddFrame("cell_temps_all", Send_CellTempStream, CELL_STREAM_TEMP_PERIOD_ms,
+            8, 2, msTicks);
+    CanTx_AddFrame("cell_ir", Send_CellIrStream, CELL_STREAM_IR_PERIOD_ms,
+            8, 2, msTicks);
+    CanTx_AddFrame("current_limit", Send_CurrentLimit, CURRENT_LIMIT_PERIOD_ms,
+            8, 1, msTicks);
 }
 
 void Evt_Can_Transmit(BMS_INPUT_T *bms_input, BMS_STATE_T *bms_state, BMS_OUTPUT_T *bms_output) {
 
-    UNUSED(bms_state);
-
-    // [TODO] Make timing.h that has this (or board.h)
-    // Make python script generate
-    #define NLG5_CTL_DLY_mS 99
-
-    // Easy way to turn off charger in case of accident
-    if (bms_output->charge_req->charger_on && bms_input->msTicks - _last_brusa_ctrl >= NLG5_CTL_DLY_mS) {
-        NLG5_CTL_T brusa_control;
-        CCAN_MSG_OBJ_T temp_msg;
-        brusa_control.enable = 1;
-        brusa_control.ventilation_request = 0;
-        brusa_control.max_mains_cAmps = 1000; // [TODO] Magic Numbers
-        brusa_control.output_mV = bms_output->charge_req->charge_voltage_mV;
-        brusa_control.output_cA = bms_output->charge_req->charge_current_mA / 10;
-        const ERROR_STATUS_T * stat = Error_GetStatus(ERROR_BRUSA);
-        if (stat->handling) {
-            brusa_control.clear_error = stat->count & 1;
-            brusa_control.output_mV = 0;
-            brusa_control.output_cA = 0;
-            bms_input->charger_on = false;
-        } else {
-             brusa_control.clear_error = 0;
-             bms_input->charger_on = true;
-        }
-
-        Brusa_MakeCTL(&brusa_control, &temp_msg);
-        CAN_TransmitMsgObj(&temp_msg);
-        _last_brusa_ctrl = bms_input->msTicks;
-    }
+    _tx_input = bms_input;
+    _tx_state = bms_state;
+    _tx_output = bms_output;
+    CanTx_Run(bms_input->msTicks);
 
     if (!bms_output->charge_req->charger_on) {
         bms_input->charger_on = false;
     }
+
     if (CAN_GetErrorStatus()) {
         Board_Println("CAN Error");
         Error_Assert(ERROR_CAN, bms_input->msTicks);
@@ -58,33 +101,136 @@ void Evt_Can_Transmit(BMS_INPUT_T *bms_input, BMS_STATE_T *bms_state, BMS_OUTPUT
 
 }
 
+static CAN_TX_STATUS_T Transmit(CCAN_MSG_OBJ_T *msg) {
+    return (CAN_TransmitMsgObj(msg) == NO_CAN_ERROR) ? CAN_TX_SENT : CAN_TX_BUSY;
+}
+
+static CAN_TX_STATUS_T Send_Brusa_Ctrl(void) {
+    // Easy way to turn off charger in case of accident
+    if (!_tx_output->charge_req->charger_on) {
+        return CAN_TX_NOTHING;
+    }
+
+    NLG5_CTL_T brusa_control;
+    CCAN_MSG_OBJ_T temp_msg;
+    brusa_control.enable = 1;
+    brusa_control.ventilation_request = 0;
+    brusa_control.max_mains_cAmps = 1000; // [TODO] Magic Numbers
+    brusa_control.output_mV = _tx_output->charge_req->charge_voltage_mV;
+    brusa_control.output_cA = _tx_output->charge_req->charge_current_mA / 10;
+    const ERROR_STATUS_T * stat = Error_GetStatus(ERROR_BRUSA);
+    if (stat->handling) {
+        brusa_control.clear_error = stat->count & 1;
+        brusa_control.output_mV = 0;
+        brusa_control.output_cA = 0;
+        _tx_input->charger_on = false;
+    } else {
+         brusa_control.clear_error = 0;
+         _tx_input->charger_on = true;
+    }
+
+    Brusa_MakeCTL(&brusa_control, &temp_msg);
+    return Transmit(&temp_msg);
+}
+
+static CAN_TX_STATUS_T Send_Timing(void) {
+    CCAN_MSG_OBJ_T timing_msg;
+    timing_msg.mode_id = TIMING_CAN_ID;
+    timing_msg.dlc = Timing_PackCanFrame(timing_msg.data);
+    return Transmit(&timing_msg);
+}
+
+static CAN_TX_STATUS_T Send_CanRx(void) {
+    CCAN_MSG_OBJ_T can_rx_msg;
+    can_rx_msg.mode_id = CAN_RX_STATS_CAN_ID;
+    can_rx_msg.dlc = CanRx_PackCanFrame(can_rx_msg.data);
+    return Transmit(&can_rx_msg);
+}
+
+static CAN_TX_STATUS_T Transmit_Stream(uint32_t can_id, const uint8_t *data, uint8_t len) {
+    CCAN_MSG_OBJ_T msg;
+    msg.mode_id = can_id;
+    msg.dlc = len;
+    memcpy(msg.data, data, len);
+    return Transmit(&msg);
+}
+
+static CAN_TX_STATUS_T Send_CellVoltageStream(void) {
+    return CellStream_Send(&_voltage_stream, CELL_STREAM_VOLTAGE_CAN_ID, CellStream_PackVoltages,
+            _tx_input->pack_status->cell_voltages_mV,
+            Get_Total_Cell_Count(_tx_state->pack_config), Transmit_Stream);
+}
+
+static CAN_TX_STATUS_T Send_CellTempStream(void) {
+    return CellStream_Send(&_temperature_stream, CELL_STREAM_TEMP_CAN_ID,
+            CellStream_PackTemperatures, _tx_input->pack_status->cell_temperatures_dC,
+            _tx_state->pack_config->num_modules*MAX_THERMISTORS_PER_MODULE, Transmit_Stream);
+}
+
+static CAN_TX_STATUS_T Send_CellIrStream(void) {
+    return CellStream_Send(&_ir_stream, CELL_STREAM_IR_CAN_ID, CellStream_PackResistances,
+            _tx_input->pack_status->cell_ir_uOhm,
+            Get_Total_Cell_Count(_tx_state->pack_config), Transmit_Stream);
+}
+
+static CAN_TX_STATUS_T Send_CurrentLimit(void) {
+    CCAN_MSG_OBJ_T limit_msg;
+    limit_msg.mode_id = CURRENT_LIMIT_CAN_ID;
+    limit_msg.dlc = Discharge_PackCanFrame(limit_msg.data);
+    return Transmit(&limit_msg);
+}
+
 void Evt_Can_Receive(BMS_INPUT_T *bms_input, BMS_OUTPUT_T *bms_output) {
     CCAN_MSG_OBJ_T rx_msg;
-    if (CAN_Receive(&rx_msg) != NO_RX_CAN_MESSAGE) {
-        if (rx_msg.mode_id == NLG5_STATUS) { 
-            // [TODO] use info from brusa message
-        } else if (rx_msg.mode_id == NLG5_ACT_I) {
-            NLG5_ACT_I_T act_i;
-            Brusa_DecodeActI(&act_i, &rx_msg);
-            bms_input->pack_status->pack_current_mA = act_i.output_cAmps*10; // [TODO] Consider using current sense as well
-            bms_input->pack_status->pack_voltage_mV = act_i.output_mVolts;
-
-            // If current > requested current + thresh throw error
-        } else if (rx_msg.mode_id == NLG5_ACT_II) {
-
-        } else if (rx_msg.mode_id == NLG5_TEMP) {
-
-        } else if (rx_msg.mode_id == NLG5_ERR && bms_output->charge_req->charger_on) {
-            // [TODO] distinguish errors
-            if (!Brusa_CheckErr(&rx_msg)) { // We've recevied a Brusa Error Message
-                // if (output->charge_req->charger_on) {
-                    Error_Assert(ERROR_BRUSA, bms_input->msTicks);
-                // }
-                // We should try to clear but also assert error for count
-                // Timing idea: Brusa error msg happens as often as ctrl message
-            } else {
-                Error_Pass(ERROR_BRUSA);
-            }
-        }
+    _rx_input = bms_input;
+    _rx_output = bms_output;
+    CanRx_Drain(rx_handlers, ARRAY_SIZE(rx_handlers), Pop_Rx_Msg, &rx_msg);
+}
+
+static CAN_RX_POP_STATUS_T Pop_Rx_Msg(uint32_t *key, void *msg) {
+    CCAN_MSG_OBJ_T *rx_msg = (CCAN_MSG_OBJ_T *) msg;
+    uint32_t status = CAN_Receive(rx_msg);
+    if (status == NO_RX_CAN_MESSAGE) {
+        return CAN_RX_EMPTY;
+    } else if (status != NO_CAN_ERROR) {
+        return CAN_RX_ERROR;
+    }
+    *key = rx_msg->mode_id;
+    return CAN_RX_FRAME;
+}
+
+static void Receive_Brusa_ActI(void *msg) {
+    NLG5_ACT_I_T act_i;
+    Brusa_DecodeActI(&act_i, (CCAN_MSG_OBJ_T *) msg);
+    uint32_t msTicks = *msTicksPtr;
+    // the current sensor, once it is working, sees the whole pack, not just
+    // the charger
+    if (!(CURRENT_SENSE_ENABLED && CurrentSense_IsCalibrated())) {
+        _rx_input->pack_status->pack_current_mA = act_i.output_cAmps*10;
+        _rx_input->pack_status->pack_current_ms = msTicks;
+        // the charger's current flows into the pack
+        SampleSync_AddCurrent(-(int32_t)_rx_input->pack_status->pack_current_mA, msTicks);
+    }
+    _rx_input->pack_status->pack_voltage_mV = act_i.output_mVolts;
+    _rx_input->pack_status->pack_voltage_ms = msTicks;
+
+    // If current > requested current + thresh throw error
+}
+
+static void Receive_Brusa_Err(void *msg) {
+    if (!_rx_output->charge_req->charger_on) {
+        return;
     }
+    // [TODO] distinguish errors
+    if (!Brusa_CheckErr((CCAN_MSG_OBJ_T *) msg)) { // We've recevied a Brusa Error Message
+        Error_Assert(ERROR_BRUSA, _rx_input->msTicks);
+        // We should try to clear but also assert error for count
+        // Timing idea: Brusa error msg happens as often as ctrl message
+    } else {
+        Error_Pass(ERROR_BRUSA);
+    }
+}
+
+static void Receive_Ignored(void *msg) {
+    UNUSED(msg);
 }
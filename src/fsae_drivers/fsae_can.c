@@ -1,26 +1,59 @@
 #include "fsae_can.h"
 
+#include <string.h>
+
 #include "MY17_Can_Library.h"
 #include "error_handler.h"
 #include "board.h"
+#include "timing.h"
+#include "soc.h"
+#include "can_rx.h"
+#include "can_tx.h"
+#include "cell_stream.h"
+#include "bms_utils.h"
+#include "discharge.h"
 
 #define BMS_HEARTBEAT_PERIOD    1000
 #define BMS_ERRORS_PERIOD       10000
 #define BMS_CELL_TEMPS_PERIOD   10000
 #define BMS_PACK_STATUS_PERIOD  100
 
-static uint32_t last_bms_heartbeat_time = 0;
-static uint32_t last_bms_errors_time = 0;
-static uint32_t last_bms_cellTemps_time = 0;
-static uint32_t last_bms_packStatus_time = 0;
+// the MY17 spec frames are budgeted at full length
+#define BMS_FRAME_DLC 8
+
+// send callbacks reach the bms structs through these while CanTx_Run is running
+static BMS_INPUT_T *tx_input;
+static BMS_STATE_T *tx_state;
+
+static CELL_STREAM_T voltage_stream;
+static CELL_STREAM_T temperature_stream;
+static CELL_STREAM_T ir_stream;
 
-void Receive_Vcu_Heartbeat(BMS_INPUT_T *bms_input);
-void Receive_Unknown_Message(void);
+// handlers reach the bms structs through this while a drain is running
+static BMS_INPUT_T *rx_input;
 
-void Send_Bms_Heartbeat(BMS_INPUT_T *bms_input, BMS_STATE_T *bms_state);
-void Send_Bms_Errors(uint32_t msTicks);
-void Send_Bms_CellTemps(BMS_PACK_STATUS_T * pack_status);
-void Send_Bms_PackStatus(BMS_PACK_STATUS_T * pack_status);
+static CAN_RX_POP_STATUS_T Pop_Rx_Msg(uint32_t *key, void *msg);
+void Receive_Vcu_Heartbeat(void *msg);
+void Receive_Unknown_Message(void *msg);
+
+// keyed by the message type the MY17 library decodes
+static const CAN_RX_ENTRY_T rx_handlers[] = {
+    {Can_Unknown_Msg, Receive_Unknown_Message},
+    {Can_Vcu_BmsHeartbeat_Msg, Receive_Vcu_Heartbeat}
+    // TODO handle current messages
+};
+
+CAN_TX_STATUS_T Send_Bms_Heartbeat(void);
+CAN_TX_STATUS_T Send_Bms_Errors(void);
+CAN_TX_STATUS_T Send_Bms_CellTemps(void);
+CAN_TX_STATUS_T Send_Bms_PackStatus(void);
+CAN_TX_STATUS_T Send_Bms_Timing(void);
+CAN_TX_STATUS_T Send_Bms_CanRx(void);
+CAN_TX_STATUS_T Send_Bms_CellVoltageStream(void);
+CAN_TX_STATUS_T Send_Bms_CellTempStream(void);
+CAN_TX_STATUS_T Send_Bms_CellIrStream(void);
+CAN_TX_STATUS_T Send_Bms_CurrentLimit(void);
+static CAN_TX_STATUS_T Tx_Status(Can_ErrorID_T error);
 
 Can_Bms_ErrorID_T bms_error_to_can_error(ERROR_T error);
 Can_Bms_ErrorID_T get_error_status(uint32_t msTicks);
@@ -28,59 +61,76 @@ bool is_pack_error(Can_Bms_ErrorID_T errorType);
 
 void Fsae_Can_Init(uint32_t baud_rate, volatile uint32_t *msTicksPtr) {
     Can_Init(baud_rate, msTicksPtr);
+    CanRx_Init();
+
+    // safety frames first, registration order sets the stagger
+    uint32_t msTicks = *msTicksPtr;
+    CanTx_Init(baud_rate, CAN_TX_BUS_LOAD_pct, msTicks);
+    CanTx_AddFrame("heartbeat", Send_Bms_Heartbeat, BMS_HEARTBEAT_PERIOD,
+            BMS_FRAME_DLC, CAN_TX_PRIORITY_SAFETY, msTicks);
+    CanTx_AddFrame("errors", Send_Bms_Errors, BMS_ERRORS_PERIOD,
+            BMS_FRAME_DLC, CAN_TX_PRIORITY_SAFETY, msTicks);
+    CanTx_AddFrame("pack_status", Send_Bms_PackStatus, BMS_PACK_STATUS_PERIOD,
+            BMS_FRAME_DLC, 1, msTicks);
+    CanTx_AddFrame("cell_temps", Send_Bms_CellTemps, BMS_CELL_TEMPS_PERIOD,
+            BMS_FRAME_DLC, 2, msTicks);
+    CanTx_AddFrame("timing", Send_Bms_Timing, TIMING_CAN_PERIOD_ms, 8, 3, msTicks);
+    CanTx_AddFrame("can_rx", Send_Bms_CanRx, TIMING_CAN_PERIOD_ms, 8, 3, msTicks);
+
+    CellStream_Init(&voltage_stream);
+    CellStream_Init(&temperature_stream);
+    CellStream_Init(&ir_stream);
+    CanTx_AddFrame("cell_voltages", Send_Bms_CellVoltageStream, CELL_STREAM_VOLTAGE_PERIOD_ms,
+            8, 4, msTicks);
+    CanTx_AddFrame("cell_temps_all", Send_Bms_CellTempStream, CELL_STREAM_TEMP_PERIOD_ms,
+            8, 4, msTicks);
+    CanTx_AddFrame("cell_ir", Send_Bms_CellIrStream, CELL_STREAM_IR_PERIOD_ms,
+            8, 4, msTicks);
+    CanTx_AddFrame("current_limit", Send_Bms_CurrentLimit, CURRENT_LIMIT_PERIOD_ms,
+            8, 1, msTicks);
 }
 
 void Fsae_Can_Receive(BMS_INPUT_T *bms_input, BMS_OUTPUT_T *bms_output) {
     UNUSED(bms_output);
+    rx_input = bms_input;
+    CanRx_Drain(rx_handlers, ARRAY_SIZE(rx_handlers), Pop_Rx_Msg, NULL);
+}
+
+static CAN_RX_POP_STATUS_T Pop_Rx_Msg(uint32_t *key, void *msg) {
+    UNUSED(msg);
     Can_MsgID_T msgType = Can_MsgType();
     if (msgType == Can_No_Msg) {
-      return;
-    }
-    else if (msgType == Can_Unknown_Msg) {
-      Receive_Unknown_Message();
-    }
-    else if (msgType == Can_Vcu_BmsHeartbeat_Msg){
-      Receive_Vcu_Heartbeat(bms_input);
-    }
-    else {
-        // TODO handle current messages
+        return CAN_RX_EMPTY;
     }
+    *key = msgType;
+    return CAN_RX_FRAME;
 }
 
 void Fsae_Can_Transmit(BMS_INPUT_T *bms_input, BMS_STATE_T *bms_state, BMS_OUTPUT_T *bms_output) {
     UNUSED(bms_output);
-    uint32_t msTicks = bms_input->msTicks;
-    if ( (msTicks - last_bms_heartbeat_time) > BMS_HEARTBEAT_PERIOD) {
-        last_bms_heartbeat_time = msTicks;
-        Send_Bms_Heartbeat(bms_input, bms_state);
-    }
-    if ( (msTicks - last_bms_errors_time) > BMS_ERRORS_PERIOD) {
-        last_bms_errors_time = msTicks;
-        Send_Bms_Errors(msTicks);
-    }
-    if ( (msTicks - last_bms_cellTemps_time) > BMS_CELL_TEMPS_PERIOD) {
-        last_bms_cellTemps_time = msTicks;
-        Send_Bms_CellTemps(bms_input->pack_status);
-    }
-    if ( (msTicks - last_bms_packStatus_time) > BMS_PACK_STATUS_PERIOD) {
-        last_bms_packStatus_time = msTicks;
-        Send_Bms_PackStatus(bms_input->pack_status);
-    }
+    tx_input = bms_input;
+    tx_state = bms_state;
+    CanTx_Run(bms_input->msTicks);
+}
 
+static CAN_TX_STATUS_T Tx_Status(Can_ErrorID_T error) {
+    return (error == Can_Error_NONE) ? CAN_TX_SENT : CAN_TX_BUSY;
 }
 
-void Receive_Vcu_Heartbeat(BMS_INPUT_T *bms_input) {
-    bms_input->last_vcu_msg_ms = bms_input->msTicks;
+void Receive_Vcu_Heartbeat(void *msg) {
+    UNUSED(msg);
+    rx_input->last_vcu_msg_ms = rx_input->msTicks;
 }
 
-void Receive_Unknown_Message(void) {
+void Receive_Unknown_Message(void *msg) {
+    UNUSED(msg);
     Frame frame;
     Can_UnknownRead(&frame);
 }
 
-void Send_Bms_Heartbeat(BMS_INPUT_T *bms_input, BMS_STATE_T * bms_state) {
+CAN_TX_STATUS_T Send_Bms_Heartbeat(void) {
     Can_Bms_Heartbeat_T bmsHeartbeat;
-    Can_Bms_ErrorID_T error_type = get_error_status(bms_input->msTicks);
+    Can_Bms_ErrorID_T error_type = get_error_status(tx_input->msTicks);
     if (error_type != CAN_BMS_ERROR_NONE) {
         if (is_pack_error(error_type)) {
             bmsHeartbeat.state = CAN_BMS_STATE_BATTERY_FAULT;
@@ -88,7 +138,7 @@ void Send_Bms_Heartbeat(BMS_INPUT_T *bms_input, BMS_STATE_T * bms_state) {
             bmsHeartbeat.state = CAN_BMS_STATE_BMS_FAULT;
         }
     } else {
-        switch (bms_state->curr_mode) {
+        switch (tx_state->curr_mode) {
             case BMS_SSM_MODE_INIT: 
                 bmsHeartbeat.state = CAN_BMS_STATE_INIT;
                 break;
@@ -107,31 +157,29 @@ void Send_Bms_Heartbeat(BMS_INPUT_T *bms_input, BMS_STATE_T * bms_state) {
             default:
                 // You should never reach here
                 Board_Println("Unexpected curr_mode");
-                Error_Assert(ERROR_CONTROL_FLOW, bms_input->msTicks);
+                Error_Assert(ERROR_CONTROL_FLOW, tx_input->msTicks);
                 break;
         }
     }
 
-    // TODO when we get SOC working
-    bmsHeartbeat.soc = 0;
+    bmsHeartbeat.soc = SOC_Estimate();
 
-    Can_Bms_Heartbeat_Write(&bmsHeartbeat);
+    return Tx_Status(Can_Bms_Heartbeat_Write(&bmsHeartbeat));
 }
 
-void Send_Bms_Errors(uint32_t msTicks) {
+CAN_TX_STATUS_T Send_Bms_Errors(void) {
     Can_Bms_Error_T error_msg;
-    error_msg.type = get_error_status(msTicks);
-    Can_Bms_Error_Write(&error_msg);
+    error_msg.type = get_error_status(tx_input->msTicks);
+    return Tx_Status(Can_Bms_Error_Write(&error_msg));
 }
 
 /**
- * @details Sends cell temperatures over Can
- *
- * @param pack_status datatype containing average cell temperature, maximum cell
- * temperature, max cell temperature id, minimum cell temperature, and minimum
- * cell temperature id
+ * @details Sends cell temperatures over Can: average cell temperature,
+ * maximum cell temperature, max cell temperature id, minimum cell temperature,
+ * and minimum cell temperature id
  */
-void Send_Bms_CellTemps(BMS_PACK_STATUS_T * pack_status) {
+CAN_TX_STATUS_T Send_Bms_CellTemps(void) {
+    BMS_PACK_STATUS_T *pack_status = tx_input->pack_status;
     Can_Bms_CellTemps_T cellTemps;
     cellTemps.avg_cell_temp = pack_status->avg_cell_temp_dC;
     cellTemps.min_cell_temp = pack_status->min_cell_temp_dC;
@@ -139,25 +187,90 @@ void Send_Bms_CellTemps(BMS_PACK_STATUS_T * pack_status) {
     cellTemps.max_cell_temp = pack_status->max_cell_temp_dC;
     cellTemps.id_max_cell_temp = pack_status->max_cell_temp_position;
 
-    Can_Bms_CellTemps_Write(&cellTemps);
+    return Tx_Status(Can_Bms_CellTemps_Write(&cellTemps));
 }
 
 /**
  * @details Sends pack status can message (details in fsae can spec)
- *
- * @param pack_status datatype containing information about the status of the pack
  */
-void Send_Bms_PackStatus(BMS_PACK_STATUS_T * pack_status) {
+CAN_TX_STATUS_T Send_Bms_PackStatus(void) {
+    BMS_PACK_STATUS_T *pack_status = tx_input->pack_status;
     Can_Bms_PackStatus_T canPackStatus;
     canPackStatus.pack_voltage = pack_status->pack_voltage_mV;
     canPackStatus.pack_current = pack_status->pack_current_mA;
-    canPackStatus.avg_cell_voltage = 0; //TODO: get actual average cell voltage
+    canPackStatus.avg_cell_voltage = pack_status->avg_cell_voltage_mV;
     canPackStatus.min_cell_voltage = pack_status->pack_cell_min_mV;
-    canPackStatus.id_min_cell_voltage = 0; //TODO: get actual id min cell voltage
+    canPackStatus.id_min_cell_voltage = pack_status->min_cell_voltage_position;
     canPackStatus.max_cell_voltage = pack_status->pack_cell_max_mV;
-    canPackStatus.id_max_cell_voltage = 0; //TODO: get actual id max cell voltage
+    canPackStatus.id_max_cell_voltage = pack_status->max_cell_voltage_position;
+
+    return Tx_Status(Can_Bms_PackStatus_Write(&canPackStatus));
+}
+
+/**
+ * @details Sends main loop timing diagnostics for one stage (see timing.h)
+ */
+CAN_TX_STATUS_T Send_Bms_Timing(void) {
+    Frame frame;
+    frame.id = TIMING_CAN_ID;
+    frame.len = Timing_PackCanFrame(frame.data);
+
+    return Tx_Status(Can_RawWrite(&frame));
+}
+
+CAN_TX_STATUS_T Send_Bms_CanRx(void) {
+    Frame frame;
+    frame.id = CAN_RX_STATS_CAN_ID;
+    frame.len = CanRx_PackCanFrame(frame.data);
+
+    return Tx_Status(Can_RawWrite(&frame));
+}
+
+static CAN_TX_STATUS_T Transmit_Stream(uint32_t can_id, const uint8_t *data, uint8_t len) {
+    Frame frame;
+    frame.id = can_id;
+    frame.len = len;
+    memcpy(frame.data, data, len);
+    return Tx_Status(Can_RawWrite(&frame));
+}
+
+/**
+ * @details Sends the next page of every cell voltage (see cell_stream.h), one
+ * sweep of the pack per period
+ */
+CAN_TX_STATUS_T Send_Bms_CellVoltageStream(void) {
+    return CellStream_Send(&voltage_stream, CELL_STREAM_VOLTAGE_CAN_ID, CellStream_PackVoltages,
+            tx_input->pack_status->cell_voltages_mV,
+            Get_Total_Cell_Count(tx_state->pack_config), Transmit_Stream);
+}
+
+/**
+ * @details Sends the next page of every thermistor temperature
+ */
+CAN_TX_STATUS_T Send_Bms_CellTempStream(void) {
+    return CellStream_Send(&temperature_stream, CELL_STREAM_TEMP_CAN_ID,
+            CellStream_PackTemperatures, tx_input->pack_status->cell_temperatures_dC,
+            tx_state->pack_config->num_modules*MAX_THERMISTORS_PER_MODULE, Transmit_Stream);
+}
+
+/**
+ * @details Sends the next page of every cell resistance (see cell_ir.h)
+ */
+CAN_TX_STATUS_T Send_Bms_CellIrStream(void) {
+    return CellStream_Send(&ir_stream, CELL_STREAM_IR_CAN_ID, CellStream_PackResistances,
+            tx_input->pack_status->cell_ir_uOhm,
+            Get_Total_Cell_Count(tx_state->pack_config), Transmit_Stream);
+}
+
+/**
+ * @details Sends the discharge current limits (see discharge.h) for the load
+ */
+CAN_TX_STATUS_T Send_Bms_CurrentLimit(void) {
+    Frame frame;
+    frame.id = CURRENT_LIMIT_CAN_ID;
+    frame.len = Discharge_PackCanFrame(frame.data);
 
-    Can_Bms_PackStatus_Write(&canPackStatus);
+    return Tx_Status(Can_RawWrite(&frame));
 }
 
 Can_Bms_ErrorID_T get_error_status(uint32_t msTicks) {
@@ -223,6 +336,7 @@ Can_Bms_ErrorID_T bms_error_to_can_error(ERROR_T error) {
         case ERROR_CONTROL_FLOW:
             return CAN_BMS_ERROR_CONTROL_FLOW;
         case ERROR_BRUSA:
+        case ERROR_PACK_VOLTAGE_MISMATCH:
         case ERROR_NUM_ERRORS:
             return CAN_BMS_ERROR_OTHER;
         default:
@@ -0,0 +1,82 @@
+#include "gcv_pipeline.h"
+
+static const GCV_PIPELINE_OPS_T *ops;
+static bool pipelined;
+static GCV_PIPELINE_STATE_T state;
+static uint32_t start_ms;   // conversion running or last started
+static uint32_t sample_ms;  // conversion being published
+static bool open_wire_requested;
+
+void GcvPipeline_Init(const GCV_PIPELINE_OPS_T *ops_arg, bool pipelined_arg) {
+    ops = ops_arg;
+    pipelined = pipelined_arg;
+    state = GCV_STATE_IDLE;
+    open_wire_requested = false;
+}
+
+bool GcvPipeline_Step(uint32_t msTicks) {
+    GCV_OP_STATUS_T status;
+
+    if (state == GCV_STATE_IDLE && open_wire_requested) {
+        state = GCV_STATE_OPEN_WIRE;
+    }
+    if (state == GCV_STATE_OPEN_WIRE) {
+        if (ops->open_wire() == GCV_OP_WAITING) {
+            return false;
+        }
+        // pass or fail, the driver has reported it; the slot is over
+        open_wire_requested = false;
+        state = GCV_STATE_IDLE;
+    }
+
+    if (state == GCV_STATE_IDLE || state == GCV_STATE_CONVERTING) {
+        if (state == GCV_STATE_IDLE) {
+            start_ms = msTicks;
+        }
+        status = ops->convert();
+        if (status == GCV_OP_WAITING) {
+            state = GCV_STATE_CONVERTING;
+            return false;
+        } else if (status == GCV_OP_ERROR) {
+            state = GCV_STATE_IDLE;
+            return false;
+        }
+        state = GCV_STATE_CLEARING;
+        sample_ms = start_ms;
+    }
+
+    // the readback passed, so the results are good even if clearing fails;
+    // the failed clear only costs the next conversion its stale check
+    status = ops->clear();
+    if (status == GCV_OP_WAITING) {
+        return false;
+    }
+
+    state = GCV_STATE_IDLE;
+    // a requested open wire test takes the slot the next conversion would
+    if (pipelined && status == GCV_OP_PASS && !open_wire_requested) {
+        // kick the next conversion before spending time on these results
+        start_ms = msTicks;
+        if (ops->convert() == GCV_OP_WAITING) {
+            state = GCV_STATE_CONVERTING;
+        }
+    }
+    ops->publish();
+    return true;
+}
+
+void GcvPipeline_RequestOpenWire(void) {
+    open_wire_requested = true;
+}
+
+bool GcvPipeline_OpenWirePending(void) {
+    return open_wire_requested;
+}
+
+uint32_t GcvPipeline_GetSampleTime(void) {
+    return sample_ms;
+}
+
+GCV_PIPELINE_STATE_T GcvPipeline_GetState(void) {
+    return state;
+}
@@ -8,6 +8,16 @@
 #include "eeprom_config.h"
 #include "config.h"
 #include "error_handler.h"
+#include "timing.h"
+#include "pack_stats.h"
+#include "scheduler.h"
+#include "eeprom_async.h"
+#include "telemetry.h"
+#include "sampling.h"
+#include "cell_history.h"
+#include "cell_ir.h"
+#include "sample_sync.h"
+#include "current_sense.h"
 #include "brusa.h"
 
 #ifdef FSAE_DRIVERS
@@ -21,7 +31,7 @@ extern volatile uint32_t msTicks;
 static char str[10];
 
 // memory allocation for BMS_OUTPUT_T
-static bool balance_reqs[MAX_NUM_MODULES*MAX_CELLS_PER_MODULE];
+static uint16_t balance_reqs[MAX_NUM_MODULES];
 static BMS_CHARGE_REQ_T charge_req;
 static BMS_OUTPUT_T bms_output;
 
@@ -32,6 +42,8 @@ static BMS_INPUT_T bms_input;
 // memory allocation for BMS_STATE_T
 static BMS_CHARGER_STATUS_T charger_status;
 static uint32_t cell_voltages[MAX_NUM_MODULES*MAX_CELLS_PER_MODULE];
+static uint32_t cell_voltages_raw[MAX_NUM_MODULES*MAX_CELLS_PER_MODULE];
+static uint16_t cell_ir[MAX_NUM_MODULES*MAX_CELLS_PER_MODULE];
 static int16_t cell_temperatures[MAX_NUM_MODULES*MAX_THERMISTORS_PER_MODULE];
 static uint8_t module_cell_count[MAX_NUM_MODULES];
 static PACK_CONFIG_T pack_config;
@@ -41,20 +53,162 @@ static BMS_STATE_T bms_state;
 static microrl_t rl;
 static CONSOLE_OUTPUT_T console_output;
 
+// binary measurement mode runs the measure task faster
+static uint8_t measure_task;
+// periods set by the adaptive sampling task
+static uint8_t cell_voltages_task;
+static uint8_t cell_temps_task;
+
+// cell resistance save in progress, the estimates hold still until it is queued
+static bool cell_ir_saving;
+static uint16_t cell_ir_save_offset;
+static uint32_t cell_ir_saved_updates;
+
 
 /****************************
  *        HELPERS
  ****************************/
 
+/****************************
+ *     SCHEDULED TASKS
+ ****************************/
+
+static SCHEDULER_TASK_STATUS_T Task_Soc(uint32_t msTicks) {
+    if (bms_state.curr_mode == BMS_SSM_MODE_INIT) {
+        return SCHEDULER_TASK_DONE;
+    }
+    SOC_Step(&pack_status, bms_state.curr_mode, msTicks);
+    return SCHEDULER_TASK_DONE;
+}
+
+static SCHEDULER_TASK_STATUS_T Task_CellVoltages(uint32_t msTicks) {
+    if (bms_state.curr_mode == BMS_SSM_MODE_INIT) {
+        return SCHEDULER_TASK_DONE;
+    }
+    if (!Board_LTC6804_GetCellVoltages(&pack_status)) {
+        return SCHEDULER_TASK_BUSY;
+    }
+    uint16_t num_cells = Get_Total_Cell_Count(&pack_config);
+    // everything below works on the instant the cells were sampled
+    uint32_t sample_ms = pack_status.cell_voltages_ms;
+    pack_status.cell_voltages_current_mA = SampleSync_CurrentAt_mA(sample_ms);
+    int32_t discharge_current_mA = pack_status.cell_voltages_current_mA;
+    // a current held from well before the sample is not the current at it
+    if (!cell_ir_saving && SampleSync_CurrentLead_ms(sample_ms) >= -CELL_IR_MAX_GAP_ms) {
+        CellIr_Update(pack_status.cell_voltages_raw_mV, num_cells, discharge_current_mA,
+                sample_ms, cell_ir);
+    }
+    pack_status.cell_ir_limit_mA = CellIr_MaxCurrent_mA(pack_status.cell_voltages_raw_mV,
+            cell_ir, num_cells, (discharge_current_mA > 0) ? discharge_current_mA : 0,
+            pack_config.cell_min_mV + CELL_IR_MARGIN_mV);
+    if (CellHistory_Append(pack_status.cell_voltages_mV, pack_status.min_cell_voltage_position,
+            pack_status.avg_cell_voltage_mV, sample_ms)) {
+        pack_status.max_cell_sag_mV_s = CellHistory_GetSag_mV_s(
+                &pack_status.max_cell_sag_position);
+    }
+    // the pack voltage only reads the pack with the contactors closed, and
+    // only one taken close to the cells measures the same pack
+    int32_t skew_ms = (int32_t)(pack_status.pack_voltage_ms - sample_ms);
+    if (bms_input.contactors_closed && pack_status.pack_voltage_mV != 0
+            && skew_ms <= PACK_VOLTAGE_MAX_SKEW_ms && skew_ms >= -PACK_VOLTAGE_MAX_SKEW_ms) {
+        if (PackStats_PackVoltageMismatch(pack_status.pack_cell_sum_mV,
+                pack_status.pack_voltage_mV)) {
+            Error_Assert(ERROR_PACK_VOLTAGE_MISMATCH, msTicks);
+        } else {
+            Error_Pass(ERROR_PACK_VOLTAGE_MISMATCH);
+        }
+    }
+    return SCHEDULER_TASK_DONE;
+}
+
+static SCHEDULER_TASK_STATUS_T Task_CellTemperatures(uint32_t msTicks) {
+    UNUSED(msTicks);
+    if (bms_state.curr_mode == BMS_SSM_MODE_INIT) {
+        return SCHEDULER_TASK_DONE;
+    }
+    return Board_LTC6804_GetCellTemperatures(&pack_status, pack_config.num_modules) ?
+            SCHEDULER_TASK_DONE : SCHEDULER_TASK_BUSY;
+}
+
+static SCHEDULER_TASK_STATUS_T Task_OpenWireTest(uint32_t msTicks) {
+    UNUSED(msTicks);
+    if (bms_state.curr_mode == BMS_SSM_MODE_INIT) {
+        return SCHEDULER_TASK_DONE;
+    }
+    return Board_LTC6804_OpenWireSlot() ? SCHEDULER_TASK_DONE : SCHEDULER_TASK_BUSY;
+}
+
+static SCHEDULER_TASK_STATUS_T Task_Sampling(uint32_t msTicks) {
+    const SAMPLING_PERIODS_T *periods = Sampling_GetPeriods(
+            Sampling_Update(&pack_config, &pack_status, bms_state.curr_mode, msTicks));
+    Scheduler_SetPeriod(cell_voltages_task, periods->cell_voltages_ms);
+    Scheduler_SetPeriod(cell_temps_task, periods->thermistor_ms);
+    return SCHEDULER_TASK_DONE;
+}
+
+static SCHEDULER_TASK_STATUS_T Task_Measure(uint32_t msTicks) {
+    Scheduler_SetPeriod(measure_task,
+            console_output.measure_binary ? MEASURE_BINARY_PERIOD_ms : MEASURE_PERIOD_ms);
+    Output_Measurements(&console_output, &bms_input, &bms_state, msTicks);
+    return SCHEDULER_TASK_DONE;
+}
+
+static SCHEDULER_TASK_STATUS_T Task_Telemetry(uint32_t msTicks) {
+    UNUSED(msTicks);
+    Measure_Service(&console_output, &bms_input, &bms_state);
+    return SCHEDULER_TASK_DONE;
+}
+
+static SCHEDULER_TASK_STATUS_T Task_Eeprom(uint32_t msTicks) {
+    EEPROM_Async_Service(msTicks);
+    return SCHEDULER_TASK_DONE;
+}
+
+static SCHEDULER_TASK_STATUS_T Task_CellIrSave(uint32_t msTicks) {
+    UNUSED(msTicks);
+    if (!cell_ir_saving) {
+        if (bms_state.curr_mode == BMS_SSM_MODE_INIT
+                || CellIr_GetUpdates() == cell_ir_saved_updates) {
+            return SCHEDULER_TASK_DONE;
+        }
+        cell_ir_saved_updates = CellIr_GetUpdates();
+        cell_ir_save_offset = 0;
+        cell_ir_saving = true;
+    }
+    if (!EEPROM_WriteCellIR(cell_ir, Get_Total_Cell_Count(&pack_config), &cell_ir_save_offset)) {
+        return SCHEDULER_TASK_BUSY; // write queue full
+    }
+    cell_ir_saving = false;
+    return SCHEDULER_TASK_DONE;
+}
+
+static SCHEDULER_TASK_STATUS_T Task_Heartbeat(uint32_t msTicks) {
+    UNUSED(msTicks);
+    Board_LED_Toggle(LED1);
+    return SCHEDULER_TASK_DONE;
+}
+
 /****************************
  *     INITIALIZERS
  ****************************/
 
+// a task that does not fit would silently never run, stop here instead
+static uint8_t Add_Task(const char *name, SCHEDULER_TASK_FUNC func, uint32_t period_ms,
+        uint8_t priority) {
+    uint8_t id = Scheduler_AddTask(name, func, period_ms, priority, msTicks);
+    if (id == SCHEDULER_MAX_TASKS) {
+        Board_Print_BLOCKING("Scheduler full, raise SCHEDULER_MAX_TASKS for task ");
+        Board_Println_BLOCKING(name);
+        while(1);
+    }
+    return id;
+}
+
 void Init_BMS_Structs(void) {
     bms_output.charge_req = &charge_req;
     bms_output.close_contactors = false;
     bms_output.balance_req = balance_reqs;
-    memset(balance_reqs, 0, sizeof(balance_reqs[0])*MAX_NUM_MODULES*MAX_CELLS_PER_MODULE);
+    memset(balance_reqs, 0, sizeof(balance_reqs[0])*MAX_NUM_MODULES);
     bms_output.read_eeprom_packconfig = false;
     bms_output.check_packconfig_with_ltc = false;
     // FSAE specific BMS outputs
@@ -114,13 +268,28 @@ void Init_BMS_Structs(void) {
 #endif // FSAE_DRIVERS
 
     memset(cell_voltages, 0, sizeof(cell_voltages));
+    memset(cell_voltages_raw, 0, sizeof(cell_voltages_raw));
     memset(cell_temperatures, 0, sizeof(cell_temperatures));
     pack_status.cell_voltages_mV = cell_voltages;
+    pack_status.cell_voltages_raw_mV = cell_voltages_raw;
+    pack_status.cell_voltages_ms = 0;
+    pack_status.cell_voltages_current_mA = 0;
     pack_status.cell_temperatures_dC = cell_temperatures;
+    pack_status.cell_temperatures_ms = 0;
     pack_status.pack_cell_max_mV = 0;
     pack_status.pack_cell_min_mV = 0xFFFFFFFF;
     pack_status.pack_current_mA = 0;
+    pack_status.pack_current_ms = 0;
     pack_status.pack_voltage_mV = 0;
+    pack_status.pack_voltage_ms = 0;
+    pack_status.pack_cell_sum_mV = 0;
+    pack_status.avg_cell_voltage_mV = 0;
+    pack_status.max_cell_voltage_position = 0;
+    pack_status.min_cell_voltage_position = 0;
+    pack_status.max_cell_sag_mV_s = 0;
+    pack_status.max_cell_sag_position = 0;
+    pack_status.cell_ir_uOhm = cell_ir;
+    pack_status.cell_ir_limit_mA = UINT32_MAX;
     pack_status.max_cell_temp_dC = 0;
 #ifdef FSAE_DRIVERS
     pack_status.min_cell_temp_dC = -100;
@@ -128,6 +297,7 @@ void Init_BMS_Structs(void) {
     pack_status.min_cell_temp_position = 0;
     pack_status.max_cell_temp_position = 0;
 #endif //FSAE_DRIVERS
+    PackStats_Init(&pack_status);
 
 }
 
@@ -141,10 +311,22 @@ void Process_Input(BMS_INPUT_T* bms_input) {
     if (bms_state.curr_mode != BMS_SSM_MODE_INIT) {
         Board_CAN_ProcessInput(bms_input, &bms_output);
         Board_GetModeRequest(&console_output, bms_input);
-        Board_LTC6804_ProcessInputs(&pack_status, &bms_state);
     }
     bms_input->msTicks = msTicks;
     bms_input->contactors_closed = Board_Contactors_Closed();
+
+    // with the contactors open no current flows, so the sensor reads its zero.
+    // Until it has found one its readings are not trusted and the charger's
+    // current report stands in
+    int32_t current_mA;
+    uint32_t current_ms;
+    if (CURRENT_SENSE_ENABLED
+            && CurrentSense_Read(!bms_input->contactors_closed, &current_mA, &current_ms)
+            && CurrentSense_IsCalibrated()) {
+        bms_input->pack_status->pack_current_mA = (current_mA < 0) ? -current_mA : current_mA;
+        bms_input->pack_status->pack_current_ms = current_ms;
+        SampleSync_AddCurrent(current_mA, current_ms);
+    }
 }
 
 void Process_Output(BMS_INPUT_T* bms_input, BMS_OUTPUT_T* bms_output, BMS_STATE_T * bms_state) {
@@ -173,10 +355,15 @@ void Process_Output(BMS_INPUT_T* bms_input, BMS_OUTPUT_T* bms_output, BMS_STATE_
         Set_EEPROM_Error(255); // magic # for no error
         Charge_Config(&pack_config);
         Discharge_Config(&pack_config);
+        SOC_Config(&pack_config, msTicks);
+        CellHistory_Init();
+        EEPROM_LoadCellIR(cell_ir, Get_Total_Cell_Count(&pack_config));
+        CellIr_Init();
+        cell_ir_saving = false;
         Board_LTC6804_DeInit(); 
 
     } else if (bms_output->check_packconfig_with_ltc) {
-        bms_input->ltc_packconfig_check_done = Board_LTC6804_Init(&pack_config, cell_voltages);
+        bms_input->ltc_packconfig_check_done = Board_LTC6804_Init(&pack_config, cell_voltages_raw);
     } else {
         Board_LTC6804_ProcessOutput(bms_output->balance_req);
         Board_CAN_ProcessOutput(bms_input, bms_state, bms_output);
@@ -194,8 +381,6 @@ void Process_Keyboard(void) {
 
 // [TODO] Undervoltage (create error handler)           WHO:Erpo
 // [TODO] SOC error (create error handler [CAN msg])    WHO:Erpo
-// [TODO] Reasonable way to change polling speeds       WHO:ALL
-// [TODO] Add current sense handling                    WHO:Jorge
 // [TODO] Add thermistor array handling                 WHO:Jorge
 // [TODO] CAN error handling for different CAN errors   WHO:Skanda/Rango
 // [TODO] Do heartbeats                           WHO:Rango
@@ -230,6 +415,9 @@ int main(void) {
 
     Board_Chip_Init();
     Board_GPIO_Init();
+    if (CURRENT_SENSE_ENABLED) {
+        Board_CurrentSense_Init();
+    }
     Board_CAN_Init(CAN_BAUD, &msTicks);
     Board_UART_Init(UART_BAUD);
 
@@ -239,8 +427,30 @@ int main(void) {
     Board_Println_BLOCKING("Finished EEPROM init");
     
     Error_Init();
+    Timing_Init();
+    SOC_Init();
+    Telemetry_Init();
+    Sampling_Init();
+    CellHistory_Init();
+    CellIr_Init();
+    SampleSync_Init();
     SSM_Init(&bms_input, &bms_state, &bms_output);
 
+    // periodic tasks, highest priority first
+    Scheduler_Init();
+    Add_Task("soc", Task_Soc, 0, 0);
+    cell_voltages_task = Add_Task("cell_voltages", Task_CellVoltages,
+            Sampling_GetPeriods(SAMPLING_RATE_NORMAL)->cell_voltages_ms, 0);
+    cell_temps_task = Add_Task("cell_temps", Task_CellTemperatures,
+            Sampling_GetPeriods(SAMPLING_RATE_NORMAL)->thermistor_ms, 1);
+    Add_Task("open_wire", Task_OpenWireTest, OPEN_WIRE_TEST_PERIOD_ms, 2);
+    measure_task = Add_Task("measure", Task_Measure, MEASURE_PERIOD_ms, 3);
+    Add_Task("heartbeat", Task_Heartbeat, HEARTBEAT_PERIOD_ms, 4);
+    Add_Task("sampling", Task_Sampling, SAMPLING_PERIOD_ms, 4);
+    Add_Task("eeprom", Task_Eeprom, 0, 5);
+    Add_Task("telemetry", Task_Telemetry, 0, 5);
+    Add_Task("cell_ir", Task_CellIrSave, CELL_IR_SAVE_PERIOD_ms, 5);
+
     //setup readline
     microrl_init(&rl, Board_Print);
     microrl_set_execute_callback(&rl, executerl);
@@ -248,31 +458,30 @@ int main(void) {
 
     Board_Println("Applications Up");
 
-    uint32_t last_count = msTicks;
-
     while(1) {
 
         Board_Headroom_Toggle(); // Used for measuring main-loop length
+        Timing_LoopStart();
 
         Process_Keyboard(); // Handle UART Input
+        Timing_Mark(TIMING_STAGE_KEYBOARD);
         Process_Input(&bms_input); // Process Inputs to board for bms
+        Timing_Mark(TIMING_STAGE_INPUT);
+        Scheduler_Run(msTicks); // LTC6804 sampling, measurement printouts, heartbeat
+        Timing_Mark(TIMING_STAGE_SCHEDULER);
         SSM_Step(&bms_input, &bms_state, &bms_output);
+        Timing_Mark(TIMING_STAGE_SSM);
         Process_Output(&bms_input, &bms_output, &bms_state);
-        Output_Measurements(&console_output, &bms_input, &bms_state, msTicks);
+        Timing_Mark(TIMING_STAGE_OUTPUT);
 
-        if (Error_Handle(bms_input.msTicks) == HANDLER_HALT) {
+        ERROR_HANDLER_STATUS_T handler_status = Error_Handle(bms_input.msTicks);
+        Timing_Mark(TIMING_STAGE_ERROR);
+        if (handler_status == HANDLER_HALT) {
             break; // Handler requested a Halt
         }
         
         // Testing Code
         bms_input.contactors_closed = bms_output.close_contactors; // [DEBUG] For testing purposes
-
-        // LED Heartbeat
-        if (msTicks - last_count > 1000) {
-            last_count = msTicks;
-            Board_LED_Toggle(LED1);  
-            // Board_PrintNum(SOC_Estimate(), 10);
-        }
     }
 
     Board_Println("FORCED HANG");
@@ -280,7 +489,7 @@ int main(void) {
 
     bms_output.close_contactors = false;
     bms_output.charge_req->charger_on = false;
-    memset(bms_output.balance_req, 0, sizeof(bms_output.balance_req[0])*Get_Total_Cell_Count(&pack_config));
+    memset(bms_output.balance_req, 0, sizeof(bms_output.balance_req[0])*pack_config.num_modules);
     bms_output.read_eeprom_packconfig = false;
     bms_output.check_packconfig_with_ltc = false;
 #ifdef FSAE_DRIVERS
@@ -311,7 +520,7 @@ int hardware_test(void) {
     Board_Println("HW Test Board Up"); 
 
     EEPROM_Init(LPC_SSP1, EEPROM_BAUD, EEPROM_CS_PIN);
-    Board_LTC6804_Init(&pack_config, cell_voltages);
+    Board_LTC6804_Init(&pack_config, cell_voltages_raw);
 
     Board_Println("HW Test Drivers Up"); 
 
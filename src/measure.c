@@ -1,11 +1,18 @@
 #include "console.h"
 #include "board.h"
 #include "measure.h"
+#include "telemetry.h"
 
-#define VOLTAGES_PRINT_PERIOD_ms 1000
-#define TEMPS_PRINT_PERIOD_ms 1000
-static uint32_t lastVoltagesPrintTime = 0;
-static uint32_t lastTempsPrintTime = 0;
+// binary mode queues the sweep a module at a time as the telemetry buffer
+// drains, so a full pack never blocks the loop
+static bool sweep_active;
+static bool sweep_temps;
+static uint8_t sweep_module;
+static uint16_t sweep_cell_idx;
+static uint32_t sweep_ms;
+
+static void Continue_Sweep(CONSOLE_OUTPUT_T *console_output, BMS_INPUT_T* bms_input,
+        BMS_STATE_T* bms_state);
 
 void Output_Measurements(
         CONSOLE_OUTPUT_T *console_output, 
@@ -16,8 +23,20 @@ void Output_Measurements(
 
     char tempstr[20];
 
+    if(console_output->measure_on && console_output->measure_binary) {
+        // a sweep still going when the next one is due just runs on
+        if (!sweep_active) {
+            sweep_active = true;
+            sweep_temps = false;
+            sweep_module = 0;
+            sweep_cell_idx = 0;
+            sweep_ms = msTicks;
+        }
+        return;
+    }
+
     if(console_output->measure_on) {
-        if(console_output->measure_temp && (msTicks - lastTempsPrintTime) > TEMPS_PRINT_PERIOD_ms) {
+        if(console_output->measure_temp) {
             uint8_t module;
             for (module = 0; module < bms_state->pack_config->num_modules; module++) {
                 utoa(msTicks, tempstr, 10); // print msTicks
@@ -32,10 +51,9 @@ void Output_Measurements(
 
                 Board_PrintThermistorTemperatures(module, bms_input->pack_status);
             }
-            lastTempsPrintTime = msTicks;
         }
 
-        if(console_output->measure_voltage && (msTicks - lastVoltagesPrintTime) > VOLTAGES_PRINT_PERIOD_ms) {
+        if(console_output->measure_voltage) {
             uint8_t i, j;
             uint32_t idx;
             idx = 0;
@@ -61,7 +79,6 @@ void Output_Measurements(
                 idx++;
                 Board_Print_BLOCKING("\n");
             }
-            lastVoltagesPrintTime = msTicks;
         }
 
         if(console_output->measure_packcurrent) {
@@ -73,3 +90,41 @@ void Output_Measurements(
         }
     }
 }
+
+void Measure_Service(CONSOLE_OUTPUT_T *console_output, BMS_INPUT_T* bms_input,
+        BMS_STATE_T* bms_state) {
+    if (sweep_active) {
+        Continue_Sweep(console_output, bms_input, bms_state);
+    }
+    Telemetry_Drain(Board_Write);
+}
+
+static void Continue_Sweep(CONSOLE_OUTPUT_T *console_output, BMS_INPUT_T* bms_input,
+        BMS_STATE_T* bms_state) {
+    PACK_CONFIG_T *pack_config = bms_state->pack_config;
+    BMS_PACK_STATUS_T *pack_status = bms_input->pack_status;
+
+    while (sweep_module < pack_config->num_modules) {
+        if (!sweep_temps && console_output->measure_voltage) {
+            uint8_t count = pack_config->module_cell_count[sweep_module];
+            if (!Telemetry_QueueVoltages(sweep_ms, sweep_module,
+                    &pack_status->cell_voltages_mV[sweep_cell_idx], count)) {
+                return;
+            }
+            sweep_cell_idx += count;
+        } else if (sweep_temps && console_output->measure_temp) {
+            if (!Telemetry_QueueTemperatures(sweep_ms, sweep_module,
+                    &pack_status->cell_temperatures_dC[sweep_module*MAX_THERMISTORS_PER_MODULE],
+                    MAX_THERMISTORS_PER_MODULE)) {
+                return;
+            }
+        }
+
+        sweep_module++;
+        if (sweep_module == pack_config->num_modules && !sweep_temps) {
+            sweep_temps = true;
+            sweep_module = 0;
+        }
+    }
+    sweep_active = false;
+}
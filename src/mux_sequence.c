@@ -0,0 +1,83 @@
+#include "mux_sequence.h"
+
+static void _add(MUX_SEQUENCE_T *seq, uint8_t *levels, bool *known,
+        MUX_PIN_T pin, bool level) {
+    uint8_t mask = 1 << pin;
+    if (*known && ((*levels & mask) != 0) == level) {
+        return;
+    }
+    seq->steps[seq->len].pin = pin;
+    seq->steps[seq->len].level = level;
+    seq->len++;
+    if (level) {
+        *levels |= mask;
+    } else {
+        *levels &= ~mask;
+    }
+}
+
+static void _build(MUX_SEQUENCE_T *seq) {
+    // the sequence is planned from the levels the chain has now
+    uint8_t levels = seq->levels;
+    bool known = seq->levels_known;
+
+    seq->len = 0;
+    seq->next = 0;
+
+    _add(seq, &levels, &known, MUX_PIN_CLOCK, false);
+    _add(seq, &levels, &known, MUX_PIN_LATCH, false);
+    // data has not been written yet if the levels were unknown
+    bool data_known = known;
+    known = true;
+
+    int8_t i;
+    for (i = MUX_SEQUENCE_BITS - 1; i >= 0; i--) {
+        bool bit = (seq->address >> i) & 1;
+        _add(seq, &levels, &data_known, MUX_PIN_DATA, bit);
+        data_known = true;
+        _add(seq, &levels, &known, MUX_PIN_CLOCK, true);
+        _add(seq, &levels, &known, MUX_PIN_CLOCK, false);
+    }
+    _add(seq, &levels, &known, MUX_PIN_LATCH, true);
+    _add(seq, &levels, &known, MUX_PIN_LATCH, false);
+}
+
+void MuxSequence_Init(MUX_SEQUENCE_T *seq) {
+    seq->len = 0;
+    seq->next = 0;
+    seq->address = 0;
+    seq->levels = 0;
+    seq->levels_known = false;
+}
+
+uint8_t MuxSequence_Select(MUX_SEQUENCE_T *seq, uint8_t address) {
+    seq->address = address;
+    _build(seq);
+    return seq->len;
+}
+
+MUX_WRITE_STATUS_T MuxSequence_Run(MUX_SEQUENCE_T *seq, MUX_WRITE_T write) {
+    while (seq->next < seq->len) {
+        const MUX_STEP_T *step = &seq->steps[seq->next];
+        MUX_WRITE_STATUS_T status = write(step->pin, step->level);
+        if (status == MUX_WRITE_WAITING) {
+            return status;
+        } else if (status == MUX_WRITE_ERROR) {
+            seq->levels_known = false;
+            _build(seq);
+            return status;
+        }
+
+        if (step->level) {
+            seq->levels |= 1 << step->pin;
+        } else {
+            seq->levels &= ~(1 << step->pin);
+        }
+        seq->next++;
+        if (seq->next == seq->len) {
+            // a complete sequence has driven every pin
+            seq->levels_known = true;
+        }
+    }
+    return MUX_WRITE_PASS;
+}
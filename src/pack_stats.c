@@ -0,0 +1,177 @@
+#include "pack_stats.h"
+
+static PACK_STATS_T module_temperatures[MAX_NUM_MODULES];
+
+static void _rescan_voltages(PACK_STATS_T *stats, const uint32_t *cell_voltages_mV,
+        uint16_t num_cells) {
+    stats->min = INT16_MAX;
+    stats->max = INT16_MIN;
+    stats->sum = 0;
+    stats->min_position = 0;
+    stats->max_position = 0;
+
+    uint16_t idx;
+    for (idx = 0; idx < num_cells; idx++) {
+        int32_t val = cell_voltages_mV[idx];
+        stats->sum += val;
+        if (val > stats->max) {
+            stats->max = val;
+            stats->max_position = idx;
+        }
+        if (val < stats->min) {
+            stats->min = val;
+            stats->min_position = idx;
+        }
+    }
+}
+
+static void _rescan_temperatures(PACK_STATS_T *stats, const int16_t *cell_temperatures_dC,
+        uint8_t module) {
+    // 255 * 24 < UINT16_MAX so this is safe
+    uint16_t start = module*MAX_THERMISTORS_PER_MODULE;
+    stats->min = INT16_MAX;
+    stats->max = INT16_MIN;
+    stats->sum = 0;
+
+    uint16_t idx;
+    for (idx = start; idx < start + MAX_THERMISTORS_PER_MODULE; idx++) {
+        int32_t val = cell_temperatures_dC[idx];
+        stats->sum += val;
+        if (val > stats->max) {
+            stats->max = val;
+            stats->max_position = idx;
+        }
+        if (val < stats->min) {
+            stats->min = val;
+            stats->min_position = idx;
+        }
+    }
+}
+
+// combine the module statistics of the first num_modules modules
+static void _combine(const PACK_STATS_T *modules, uint8_t num_modules, PACK_STATS_T *pack) {
+    uint8_t module;
+    *pack = modules[0];
+    for (module = 1; module < num_modules; module++) {
+        const PACK_STATS_T *stats = &modules[module];
+        pack->sum += stats->sum;
+        if (stats->max > pack->max) {
+            pack->max = stats->max;
+            pack->max_position = stats->max_position;
+        }
+        if (stats->min < pack->min) {
+            pack->min = stats->min;
+            pack->min_position = stats->min_position;
+        }
+    }
+}
+
+void PackStats_Init(BMS_PACK_STATUS_T *pack_status) {
+    uint8_t module;
+    for (module = 0; module < MAX_NUM_MODULES; module++) {
+        _rescan_temperatures(&module_temperatures[module], pack_status->cell_temperatures_dC,
+                module);
+    }
+}
+
+void PackStats_UpdateVoltages(BMS_PACK_STATUS_T *pack_status, uint8_t num_modules,
+        const uint8_t *module_cell_count) {
+    if (num_modules == 0) {
+        return;
+    }
+
+    uint8_t module;
+    uint16_t num_cells = 0;
+    for (module = 0; module < num_modules; module++) {
+        num_cells += module_cell_count[module];
+    }
+
+    PACK_STATS_T pack;
+    _rescan_voltages(&pack, pack_status->cell_voltages_mV, num_cells);
+    pack_status->pack_cell_max_mV = pack.max;
+    pack_status->pack_cell_min_mV = pack.min;
+    pack_status->avg_cell_voltage_mV = (num_cells == 0) ? 0 : pack.sum / num_cells;
+    pack_status->max_cell_voltage_position = pack.max_position;
+    pack_status->min_cell_voltage_position = pack.min_position;
+}
+
+void PackStats_UpdateCellSum(BMS_PACK_STATUS_T *pack_status, uint8_t num_modules,
+        const uint8_t *module_cell_count) {
+    uint16_t num_cells = 0;
+    uint8_t module;
+    for (module = 0; module < num_modules; module++) {
+        num_cells += module_cell_count[module];
+    }
+    // no running sums, so a pack config with fewer modules leaves nothing stale
+    uint32_t sum_mV = 0;
+    uint16_t idx;
+    for (idx = 0; idx < num_cells; idx++) {
+        sum_mV += pack_status->cell_voltages_raw_mV[idx];
+    }
+    pack_status->pack_cell_sum_mV = sum_mV;
+}
+
+bool PackStats_PackVoltageMismatch(uint32_t cell_sum_mV, uint32_t pack_voltage_mV) {
+    uint32_t diff_mV = (cell_sum_mV > pack_voltage_mV) ?
+            cell_sum_mV - pack_voltage_mV : pack_voltage_mV - cell_sum_mV;
+    // a 1 kV pack times the permille stays far inside 32 bits
+    uint32_t tolerance_mV = PACK_VOLTAGE_MISMATCH_mV
+            + cell_sum_mV / 1000 * PACK_VOLTAGE_MISMATCH_PERMILLE;
+    return diff_mV > tolerance_mV;
+}
+
+void PackStats_UpdateTemperature(int16_t *cell_temperatures_dC, uint8_t module,
+        uint8_t thermistor, int16_t temp_dC) {
+    PACK_STATS_T *stats = &module_temperatures[module];
+    uint16_t idx = module*MAX_THERMISTORS_PER_MODULE + thermistor;
+    int16_t old_temp_dC = cell_temperatures_dC[idx];
+
+    cell_temperatures_dC[idx] = temp_dC;
+    stats->sum += temp_dC - old_temp_dC;
+
+    // a reading that was the module extreme moved inwards, the new extreme
+    // could be anywhere in the module
+    if ((idx == stats->max_position && temp_dC < old_temp_dC)
+            || (idx == stats->min_position && temp_dC > old_temp_dC)) {
+        _rescan_temperatures(stats, cell_temperatures_dC, module);
+        return;
+    }
+
+    if (temp_dC > stats->max) {
+        stats->max = temp_dC;
+        stats->max_position = idx;
+    }
+    if (temp_dC < stats->min) {
+        stats->min = temp_dC;
+        stats->min_position = idx;
+    }
+}
+
+void PackStats_WriteTemperatures(BMS_PACK_STATUS_T *pack_status, uint8_t num_modules) {
+    if (num_modules == 0) {
+        return;
+    }
+
+    PACK_STATS_T pack;
+    _combine(module_temperatures, num_modules, &pack);
+    pack_status->max_cell_temp_dC = pack.max;
+#ifdef FSAE_DRIVERS
+    pack_status->min_cell_temp_dC = pack.min;
+    pack_status->avg_cell_temp_dC = pack.sum/(num_modules*MAX_THERMISTORS_PER_MODULE);
+    pack_status->max_cell_temp_position = pack.max_position;
+    pack_status->min_cell_temp_position = pack.min_position;
+#endif //FSAE_DRIVERS
+}
+
+void PackStats_RescanTemperatures(BMS_PACK_STATUS_T *pack_status, uint8_t num_modules) {
+    uint8_t module;
+    for (module = 0; module < num_modules; module++) {
+        _rescan_temperatures(&module_temperatures[module], pack_status->cell_temperatures_dC,
+                module);
+    }
+    PackStats_WriteTemperatures(pack_status, num_modules);
+}
+
+const PACK_STATS_T * PackStats_GetModuleTemperatures(uint8_t module) {
+    return &module_temperatures[module];
+}
@@ -0,0 +1,52 @@
+#include "sample_sync.h"
+
+static int32_t current_mA[SAMPLE_SYNC_CURRENT_LEN];
+static uint32_t current_ms[SAMPLE_SYNC_CURRENT_LEN];
+static uint8_t newest;
+static uint8_t count;
+
+void SampleSync_Init(void) {
+    newest = 0;
+    count = 0;
+}
+
+void SampleSync_AddCurrent(int32_t current_mA_arg, uint32_t msTicks) {
+    if (count > 0) {
+        newest = (newest + 1) % SAMPLE_SYNC_CURRENT_LEN;
+    }
+    if (count < SAMPLE_SYNC_CURRENT_LEN) {
+        count++;
+    }
+    current_mA[newest] = current_mA_arg;
+    current_ms[newest] = msTicks;
+}
+
+int32_t SampleSync_CurrentAt_mA(uint32_t msTicks) {
+    if (count == 0) {
+        return 0;
+    }
+    // walk back from the newest sample to the first one at or before msTicks
+    uint8_t later = newest;
+    if ((int32_t)(msTicks - current_ms[later]) >= 0) {
+        return current_mA[later];
+    }
+    uint8_t i;
+    for (i = 1; i < count; i++) {
+        uint8_t earlier = (later + SAMPLE_SYNC_CURRENT_LEN - 1) % SAMPLE_SYNC_CURRENT_LEN;
+        int32_t since_ms = msTicks - current_ms[earlier];
+        if (since_ms >= 0) {
+            int32_t span_ms = current_ms[later] - current_ms[earlier];
+            int64_t step_mA = (int64_t)current_mA[later] - current_mA[earlier];
+            return current_mA[earlier] + step_mA * since_ms / span_ms;
+        }
+        later = earlier;
+    }
+    return current_mA[later];
+}
+
+int32_t SampleSync_CurrentLead_ms(uint32_t msTicks) {
+    if (count == 0) {
+        return 0;
+    }
+    return current_ms[newest] - msTicks;
+}
@@ -0,0 +1,102 @@
+#include "sampling.h"
+#include "config.h"
+
+static const SAMPLING_PERIODS_T periods[] = {
+    {SAMPLING_IDLE_VOLTAGES_ms, SAMPLING_IDLE_THERMISTOR_ms},       // SAMPLING_RATE_IDLE
+    {SAMPLING_NORMAL_VOLTAGES_ms, SAMPLING_NORMAL_THERMISTOR_ms},   // SAMPLING_RATE_NORMAL
+    {SAMPLING_FAST_VOLTAGES_ms, SAMPLING_FAST_THERMISTOR_ms}        // SAMPLING_RATE_FAST
+};
+
+static SAMPLING_RATE_T rate;
+static bool fast_held;
+static uint32_t fast_until_ms;
+
+static bool window_started;
+static uint32_t window_start_ms;
+static uint32_t window_min_mV;
+static uint32_t window_max_mV;
+static uint32_t dvdt_mV_s;
+
+void Sampling_Init(void) {
+    rate = SAMPLING_RATE_NORMAL;
+    fast_held = false;
+    window_started = false;
+    dvdt_mV_s = 0;
+}
+
+static uint32_t _abs_diff(uint32_t a, uint32_t b) {
+    return (a > b) ? a - b : b - a;
+}
+
+static void _update_dvdt(const BMS_PACK_STATUS_T *pack_status, uint32_t msTicks) {
+    uint32_t elapsed_ms = msTicks - window_start_ms;
+    if (window_started && elapsed_ms < SAMPLING_DVDT_WINDOW_ms) {
+        return;
+    }
+    if (window_started) {
+        uint32_t dv_min = _abs_diff(pack_status->pack_cell_min_mV, window_min_mV);
+        uint32_t dv_max = _abs_diff(pack_status->pack_cell_max_mV, window_max_mV);
+        dvdt_mV_s = ((dv_min > dv_max) ? dv_min : dv_max) * 1000 / elapsed_ms;
+    }
+    window_started = true;
+    window_start_ms = msTicks;
+    window_min_mV = pack_status->pack_cell_min_mV;
+    window_max_mV = pack_status->pack_cell_max_mV;
+}
+
+static bool _needs_fast(const PACK_CONFIG_T *config, const BMS_PACK_STATUS_T *pack_status) {
+    if (config->sample_fast_current_mA != 0 &&
+            pack_status->pack_current_mA >= config->sample_fast_current_mA) {
+        return true;
+    }
+    if (config->sample_fast_margin_mV != 0 &&
+            (pack_status->pack_cell_min_mV <= config->cell_min_mV + config->sample_fast_margin_mV ||
+             pack_status->pack_cell_max_mV + config->sample_fast_margin_mV >= config->cell_max_mV)) {
+        return true;
+    }
+    if (config->sample_fast_dvdt_mV_s != 0 &&
+            dvdt_mV_s >= config->sample_fast_dvdt_mV_s) {
+        return true;
+    }
+    return false;
+}
+
+SAMPLING_RATE_T Sampling_Update(const PACK_CONFIG_T *config,
+        const BMS_PACK_STATUS_T *pack_status, BMS_SSM_MODE_T mode, uint32_t msTicks) {
+    if (mode == BMS_SSM_MODE_INIT) {
+        // nothing has been measured yet
+        window_started = false;
+        fast_held = false;
+        rate = SAMPLING_RATE_IDLE;
+        return rate;
+    }
+
+    _update_dvdt(pack_status, msTicks);
+    if (_needs_fast(config, pack_status)) {
+        fast_held = true;
+        fast_until_ms = msTicks + SAMPLING_FAST_HOLD_ms;
+    } else if (fast_held && (int32_t)(msTicks - fast_until_ms) >= 0) {
+        fast_held = false;
+    }
+
+    if (fast_held) {
+        rate = SAMPLING_RATE_FAST;
+    } else if (mode == BMS_SSM_MODE_STANDBY) {
+        rate = SAMPLING_RATE_IDLE;
+    } else {
+        rate = SAMPLING_RATE_NORMAL;
+    }
+    return rate;
+}
+
+const SAMPLING_PERIODS_T * Sampling_GetPeriods(SAMPLING_RATE_T rate_arg) {
+    return &periods[rate_arg];
+}
+
+SAMPLING_RATE_T Sampling_GetRate(void) {
+    return rate;
+}
+
+uint32_t Sampling_GetDvdt_mV_s(void) {
+    return dvdt_mV_s;
+}
@@ -0,0 +1,114 @@
+#include "scheduler.h"
+
+#include "board.h"
+#include "bms_utils.h"
+
+static SCHEDULER_TASK_T tasks[SCHEDULER_MAX_TASKS];
+static uint8_t num_tasks;
+
+static bool _is_released(const SCHEDULER_TASK_T *task, uint32_t msTicks) {
+    return task->busy || (int32_t)(msTicks - task->release_ms) >= 0;
+}
+
+// true if a should run before b
+static bool _runs_before(const SCHEDULER_TASK_T *a, const SCHEDULER_TASK_T *b) {
+    if (a->priority != b->priority) {
+        return a->priority < b->priority;
+    }
+    uint32_t deadline_a = a->release_ms + a->period_ms;
+    uint32_t deadline_b = b->release_ms + b->period_ms;
+    return (int32_t)(deadline_a - deadline_b) < 0;
+}
+
+static void _poll(SCHEDULER_TASK_T *task, uint32_t msTicks) {
+    if (!task->busy) {
+        uint16_t jitter_ms = Saturate_u16(msTicks - task->release_ms);
+        if (jitter_ms > task->max_jitter_ms) task->max_jitter_ms = jitter_ms;
+        task->busy = true;
+    }
+
+    uint32_t start_us = Board_Micros();
+    SCHEDULER_TASK_STATUS_T status = task->func(msTicks);
+    uint16_t exec_us = Saturate_u16(Board_Micros() - start_us);
+    if (exec_us > task->max_exec_us) task->max_exec_us = exec_us;
+
+    if (status == SCHEDULER_TASK_BUSY) {
+        return;
+    }
+
+    task->busy = false;
+    task->runs++;
+
+    uint32_t latency_ms = msTicks - task->release_ms;
+    if (latency_ms > task->max_latency_ms) task->max_latency_ms = Saturate_u16(latency_ms);
+    if (task->period_ms != 0 && latency_ms > task->period_ms
+            && task->overruns < UINT16_MAX) {
+        task->overruns++;
+    }
+
+    // release the next job one period later, or right away if that time
+    // has already passed (missed releases are dropped, not bunched up)
+    task->release_ms += task->period_ms;
+    if ((int32_t)(msTicks - task->release_ms) >= 0) {
+        task->release_ms = msTicks;
+    }
+}
+
+void Scheduler_Init(void) {
+    memset(tasks, 0, sizeof(tasks));
+    num_tasks = 0;
+}
+
+uint8_t Scheduler_AddTask(const char *name, SCHEDULER_TASK_FUNC func,
+        uint32_t period_ms, uint8_t priority, uint32_t msTicks) {
+    if (num_tasks == SCHEDULER_MAX_TASKS) {
+        return SCHEDULER_MAX_TASKS;
+    }
+
+    SCHEDULER_TASK_T *task = &tasks[num_tasks];
+    memset(task, 0, sizeof(*task));
+    task->name = name;
+    task->func = func;
+    task->period_ms = period_ms;
+    task->priority = priority;
+    task->release_ms = msTicks;
+    return num_tasks++;
+}
+
+void Scheduler_SetPeriod(uint8_t task_id, uint32_t period_ms) {
+    if (task_id < num_tasks) {
+        tasks[task_id].period_ms = period_ms;
+    }
+}
+
+void Scheduler_Run(uint32_t msTicks) {
+    bool polled[SCHEDULER_MAX_TASKS];
+    memset(polled, 0, sizeof(polled));
+
+    while (1) {
+        SCHEDULER_TASK_T *next = NULL;
+        uint8_t next_id = 0;
+        uint8_t i;
+        for (i = 0; i < num_tasks; i++) {
+            if (polled[i] || !_is_released(&tasks[i], msTicks)) continue;
+            if (next == NULL || _runs_before(&tasks[i], next)) {
+                next = &tasks[i];
+                next_id = i;
+            }
+        }
+
+        if (next == NULL) {
+            return;
+        }
+        polled[next_id] = true;
+        _poll(next, msTicks);
+    }
+}
+
+uint8_t Scheduler_GetTaskCount(void) {
+    return num_tasks;
+}
+
+const SCHEDULER_TASK_T * Scheduler_GetTask(uint8_t task_id) {
+    return &tasks[task_id];
+}
@@ -1,11 +1,165 @@
+#include "soc.h"
 #include "eeprom_config.h"
-#include "board.h"
+
+// open circuit cell voltage at 0%, 10%, ... 100% state of charge
+#define OCV_TABLE_LEN 11
+static const uint16_t ocv_table_mV[OCV_TABLE_LEN] = {
+    3000, 3450, 3550, 3620, 3680, 3740, 3810, 3900, 3990, 4090, 4200
+};
+
+// charge is counted in mA*ms so the per tick update is one multiply and a
+// 64 bit add, the divide only happens when someone asks for the estimate
+static int64_t capacity_mAms;
+static int64_t charge_mAms;
+static bool soc_valid;
+static uint32_t last_step_ms;
+static uint32_t rest_start_ms;
+
+static uint8_t checkpoint_slot;     // slot holding the newest checkpoint
+static uint16_t checkpoint_seq;
+static uint16_t checkpoint_cpct;
+static uint32_t last_checkpoint_ms;
+
+static void Set_Soc_cpct(uint16_t soc_cpct) {
+    charge_mAms = capacity_mAms * soc_cpct / SOC_FULL_cpct;
+    soc_valid = true;
+}
+
+static void Restore_Checkpoint(void) {
+    bool found = false;
+    uint8_t slot;
+    for (slot = 0; slot < SOC_CHECKPOINT_SLOTS; slot++) {
+        uint32_t record = EEPROM_LoadCCPage_Num(slot);
+        uint16_t seq = record >> 16;
+        uint16_t soc_cpct = record & 0xFFFF;
+        if (soc_cpct > SOC_FULL_cpct) {
+            continue; // erased or garbage
+        }
+        // sequence numbers wrap, newest is the one ahead of all others
+        if (!found || (int16_t)(seq - checkpoint_seq) > 0) {
+            found = true;
+            checkpoint_slot = slot;
+            checkpoint_seq = seq;
+            checkpoint_cpct = soc_cpct;
+        }
+    }
+
+    if (found) {
+        Set_Soc_cpct(checkpoint_cpct);
+    } else {
+        checkpoint_slot = SOC_CHECKPOINT_SLOTS - 1;
+        checkpoint_seq = 0;
+        checkpoint_cpct = SOC_FULL_cpct + 1; // always differs
+    }
+}
+
+// each checkpoint goes to the next slot so the writes are spread over the page.
+// If the EEPROM queue is full nothing moves on and the next period retries
+static void Write_Checkpoint(uint16_t soc_cpct) {
+    uint8_t slot = (checkpoint_slot + 1) % SOC_CHECKPOINT_SLOTS;
+    uint16_t seq = checkpoint_seq + 1;
+    if (EEPROM_WriteCCPage_Num(slot, ((uint32_t)seq << 16) | soc_cpct)) {
+        checkpoint_slot = slot;
+        checkpoint_seq = seq;
+        checkpoint_cpct = soc_cpct;
+    }
+}
 
 void SOC_Init(void) {
-    // EEPROM_WriteCCPage_Num(0,18);
+    capacity_mAms = 0;
+    charge_mAms = 0;
+    soc_valid = false;
+}
+
+void SOC_Config(PACK_CONFIG_T *pack_config, uint32_t msTicks) {
+    // cAh -> mAms is 10 * 3600 * 1000
+    capacity_mAms = (int64_t)pack_config->cell_capacity_cAh * pack_config->pack_cells_p * 36000000;
+    soc_valid = false;
+    last_step_ms = msTicks;
+    rest_start_ms = msTicks;
+    last_checkpoint_ms = msTicks;
+    Restore_Checkpoint();
+}
+
+void SOC_Step(const BMS_PACK_STATUS_T *pack_status, BMS_SSM_MODE_T mode, uint32_t msTicks) {
+    uint32_t dt_ms = msTicks - last_step_ms;
+    last_step_ms = msTicks;
+    if (dt_ms > SOC_MAX_STEP_ms) {
+        dt_ms = SOC_MAX_STEP_ms;
+    }
+
+    if (!soc_valid) {
+        if (pack_status->avg_cell_voltage_mV == 0) {
+            return; // no cell voltages yet
+        }
+        Set_Soc_cpct(SOC_FromOcv_cpct(pack_status->avg_cell_voltage_mV));
+        rest_start_ms = msTicks;
+    }
+
+    // an old reading says nothing about what flows now: nothing is
+    // integrated and the pack is not taken to be at rest
+    bool current_known = (int32_t)(msTicks - pack_status->pack_current_ms)
+            <= SOC_CURRENT_MAX_AGE_ms;
+    uint32_t current_mA = current_known ? pack_status->pack_current_mA : 0;
+    uint32_t delta_mAms = current_mA * dt_ms;
+    if (mode == BMS_SSM_MODE_CHARGE) {
+        charge_mAms += delta_mAms;
+        if (charge_mAms > capacity_mAms) charge_mAms = capacity_mAms;
+    } else if (mode == BMS_SSM_MODE_DISCHARGE) {
+        charge_mAms -= delta_mAms;
+        if (charge_mAms < 0) charge_mAms = 0;
+    }
+
+    bool resting = current_known
+            && (mode == BMS_SSM_MODE_STANDBY || mode == BMS_SSM_MODE_BALANCE)
+            && current_mA < SOC_REST_CURRENT_mA;
+    if (!resting) {
+        rest_start_ms = msTicks;
+    } else if (msTicks - rest_start_ms >= SOC_REST_TIME_ms
+            && pack_status->avg_cell_voltage_mV != 0) {
+        Set_Soc_cpct(SOC_FromOcv_cpct(pack_status->avg_cell_voltage_mV));
+        rest_start_ms = msTicks;
+    }
+
+    if (msTicks - last_checkpoint_ms >= SOC_CHECKPOINT_PERIOD_ms) {
+        last_checkpoint_ms = msTicks;
+        uint16_t soc_cpct = SOC_Estimate_cpct();
+        int32_t change = (int32_t)soc_cpct - checkpoint_cpct;
+        if (change >= SOC_CHECKPOINT_DELTA_cpct || change <= -SOC_CHECKPOINT_DELTA_cpct) {
+            Write_Checkpoint(soc_cpct);
+        }
+    }
+}
+
+uint16_t SOC_FromOcv_cpct(uint32_t cell_mV) {
+    if (cell_mV <= ocv_table_mV[0]) {
+        return 0;
+    }
+    if (cell_mV >= ocv_table_mV[OCV_TABLE_LEN - 1]) {
+        return SOC_FULL_cpct;
+    }
+
+    uint8_t i = 1;
+    while (cell_mV > ocv_table_mV[i]) {
+        i++;
+    }
+    // linear between table points, which are SOC_FULL_cpct/10 apart
+    uint32_t span_mV = ocv_table_mV[i] - ocv_table_mV[i - 1];
+    uint32_t above_mV = cell_mV - ocv_table_mV[i - 1];
+    return (i - 1) * (SOC_FULL_cpct / 10) + above_mV * (SOC_FULL_cpct / 10) / span_mV;
+}
+
+uint16_t SOC_Estimate_cpct(void) {
+    if (!soc_valid || capacity_mAms == 0) {
+        return 0;
+    }
+    return charge_mAms * SOC_FULL_cpct / capacity_mAms;
 }
 
 uint32_t SOC_Estimate(void) {
-    // return EEPROM_LoadCCPage_Num(0);
-    return 0;
+    return SOC_Estimate_cpct() / 100;
+}
+
+bool SOC_Valid(void) {
+    return soc_valid;
 }
@@ -4,8 +4,6 @@
 #include "bms_utils.h"
 #include "board.h"
 
-volatile uint32_t msTicks;
-
 void SSM_Init(BMS_INPUT_T *input, BMS_STATE_T *state, BMS_OUTPUT_T *output) {
     // Initialize BMS state variables
     state->curr_mode = BMS_SSM_MODE_INIT;
@@ -162,7 +160,7 @@ void SSM_Step(BMS_INPUT_T *input, BMS_STATE_T *state, BMS_OUTPUT_T *output) {
         state->curr_mode = input->mode_request;
         output->close_contactors = false;
         output->charge_req->charger_on = false;
-        memset(output->balance_req, 0, sizeof(output->balance_req[0])*Get_Total_Cell_Count(state->pack_config));
+        memset(output->balance_req, 0, sizeof(output->balance_req[0])*state->pack_config->num_modules);
     }
 
     switch(state->curr_mode) {
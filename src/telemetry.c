@@ -0,0 +1,152 @@
+#include "telemetry.h"
+
+#include <string.h>
+
+static uint8_t buffer[TELEMETRY_BUFFER_SIZE];
+static uint16_t buffer_head;    // next byte to write out
+static uint16_t buffer_count;
+
+void Telemetry_Init(void) {
+    buffer_head = 0;
+    buffer_count = 0;
+}
+
+// CRC-16/CCITT-FALSE, bitwise: frames are short and flash is not
+uint16_t Telemetry_Crc16(const uint8_t *data, uint16_t len) {
+    uint16_t crc = 0xFFFF;
+    uint16_t i;
+    for (i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        uint8_t bit;
+        for (bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+        }
+    }
+    return crc;
+}
+
+uint16_t Telemetry_CobsEncode(const uint8_t *src, uint16_t len, uint8_t *dst) {
+    uint16_t code_pos = 0;
+    uint16_t out = 1;
+    uint8_t code = 1;
+    uint16_t i;
+    for (i = 0; i < len; i++) {
+        if (src[i] != 0) {
+            dst[out++] = src[i];
+            code++;
+        }
+        if (src[i] == 0 || code == 0xFF) {
+            dst[code_pos] = code;
+            code_pos = out++;
+            code = 1;
+        }
+    }
+    dst[code_pos] = code;
+    return out;
+}
+
+static uint8_t _put_u16(uint8_t *dst, uint16_t val) {
+    dst[0] = val & 0xFF;
+    dst[1] = val >> 8;
+    return 2;
+}
+
+// zigzag so small negative deltas stay one byte too
+static uint8_t _put_delta(uint8_t *dst, int32_t delta) {
+    uint32_t zz = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+    uint8_t len = 0;
+    while (zz >= 0x80) {
+        dst[len++] = (zz & 0x7F) | 0x80;
+        zz >>= 7;
+    }
+    dst[len++] = zz;
+    return len;
+}
+
+// copy a finished frame into the ring, all or nothing
+static bool _push(const uint8_t *frame, uint16_t len) {
+    if (len > TELEMETRY_BUFFER_SIZE - buffer_count) {
+        return false;
+    }
+    uint16_t tail = (buffer_head + buffer_count) % TELEMETRY_BUFFER_SIZE;
+    uint16_t i;
+    for (i = 0; i < len; i++) {
+        buffer[tail] = frame[i];
+        tail = (tail + 1) % TELEMETRY_BUFFER_SIZE;
+    }
+    buffer_count += len;
+    return true;
+}
+
+// values are passed widened to int32 so both types share the encoder
+static bool _queue(uint8_t type, uint32_t msTicks, uint8_t module,
+        const int32_t *values, uint8_t count) {
+    uint8_t payload[TELEMETRY_MAX_PAYLOAD];
+    uint8_t frame[TELEMETRY_MAX_FRAME];
+    uint16_t len = 0;
+
+    payload[len++] = type;
+    len += _put_u16(&payload[len], msTicks & 0xFFFF);
+    len += _put_u16(&payload[len], msTicks >> 16);
+    payload[len++] = module;
+    payload[len++] = count;
+    len += _put_u16(&payload[len], (uint16_t)values[0]);
+    uint8_t i;
+    for (i = 1; i < count; i++) {
+        len += _put_delta(&payload[len], values[i] - values[i-1]);
+    }
+    len += _put_u16(&payload[len], Telemetry_Crc16(payload, len));
+
+    uint16_t frame_len = Telemetry_CobsEncode(payload, len, frame);
+    frame[frame_len++] = 0x00;
+    return _push(frame, frame_len);
+}
+
+bool Telemetry_QueueVoltages(uint32_t msTicks, uint8_t module,
+        const uint32_t *cell_voltages_mV, uint8_t count) {
+    int32_t values[TELEMETRY_MAX_VALUES];
+    uint8_t i;
+    if (count == 0 || count > TELEMETRY_MAX_VALUES) {
+        return true;
+    }
+    for (i = 0; i < count; i++) {
+        // clamp like the 16 bit first value, so deltas stay small
+        values[i] = (cell_voltages_mV[i] > UINT16_MAX) ? UINT16_MAX : cell_voltages_mV[i];
+    }
+    return _queue(TELEMETRY_TYPE_VOLTAGES, msTicks, module, values, count);
+}
+
+bool Telemetry_QueueTemperatures(uint32_t msTicks, uint8_t module,
+        const int16_t *cell_temperatures_dC, uint8_t count) {
+    int32_t values[TELEMETRY_MAX_VALUES];
+    uint8_t i;
+    if (count == 0 || count > TELEMETRY_MAX_VALUES) {
+        return true;
+    }
+    for (i = 0; i < count; i++) {
+        values[i] = cell_temperatures_dC[i];
+    }
+    return _queue(TELEMETRY_TYPE_TEMPERATURES, msTicks, module, values, count);
+}
+
+uint32_t Telemetry_Drain(TELEMETRY_WRITE_T write) {
+    uint32_t written = 0;
+    while (buffer_count > 0) {
+        // contiguous run up to the end of the ring
+        uint16_t chunk = TELEMETRY_BUFFER_SIZE - buffer_head;
+        if (chunk > buffer_count) chunk = buffer_count;
+
+        uint32_t taken = write((const char *) &buffer[buffer_head], chunk);
+        buffer_head = (buffer_head + taken) % TELEMETRY_BUFFER_SIZE;
+        buffer_count -= taken;
+        written += taken;
+        if (taken < chunk) {
+            break;
+        }
+    }
+    return written;
+}
+
+uint16_t Telemetry_Pending(void) {
+    return buffer_count;
+}
@@ -0,0 +1,16 @@
+#include "thermistor.h"
+#include "thermistor_table.h"
+
+#define THERMISTOR_TABLE_STEP_mV (1UL << THERMISTOR_TABLE_SHIFT)
+
+int16_t Thermistor_Temperature_dC(uint32_t voltage_mV) {
+    uint32_t i = voltage_mV >> THERMISTOR_TABLE_SHIFT;
+    if (i >= THERMISTOR_TABLE_LEN - 1) {
+        return thermistor_table_dC[THERMISTOR_TABLE_LEN - 1];
+    }
+    int32_t frac = voltage_mV & (THERMISTOR_TABLE_STEP_mV - 1);
+    int32_t lo = thermistor_table_dC[i];
+    int32_t rise = thermistor_table_dC[i + 1] - lo;
+    // the table is monotonic, so rise and the product are never negative
+    return lo + ((rise * frac + THERMISTOR_TABLE_STEP_mV / 2) >> THERMISTOR_TABLE_SHIFT);
+}
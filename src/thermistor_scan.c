@@ -0,0 +1,107 @@
+#include "thermistor_scan.h"
+#include "config.h"
+
+typedef struct {
+    bool read;
+    uint8_t age;
+    uint8_t weight;
+    int8_t rise_dC_s;           // clamped, the weight saturates long before
+    int16_t rise_from_dC;       // reading the rise is measured from
+    uint16_t rise_from_ms;      // low half of msTicks, MAX_AGE reads span far less than 65 s
+} THERMISTOR_SCAN_T;
+
+static THERMISTOR_SCAN_T thermistors[MAX_THERMISTORS_PER_MODULE];
+static uint8_t count;
+
+void ThermistorScan_Init(uint8_t num_thermistors) {
+    uint8_t i;
+    count = (num_thermistors > MAX_THERMISTORS_PER_MODULE) ?
+            MAX_THERMISTORS_PER_MODULE : num_thermistors;
+    for (i = 0; i < count; i++) {
+        thermistors[i].read = false;
+        thermistors[i].age = 0;
+        thermistors[i].weight = 1;
+        thermistors[i].rise_dC_s = 0;
+        thermistors[i].rise_from_dC = 0;
+        thermistors[i].rise_from_ms = 0;
+    }
+}
+
+uint8_t ThermistorScan_Next(void) {
+    uint8_t best = 0;
+    uint16_t best_score = 0;
+    uint8_t i;
+    for (i = 0; i < count; i++) {
+        const THERMISTOR_SCAN_T *t = &thermistors[i];
+        if (!t->read) {
+            // first sweep, in order
+            return i;
+        }
+        // close enough to the bound that every other thermistor could be
+        // just as close: the oldest goes first, ahead of any weighted score
+        uint16_t score = (t->age + count > THERMISTOR_SCAN_MAX_AGE) ?
+                0x8000 + t->age : t->age * t->weight;
+        if (score > best_score) {
+            best = i;
+            best_score = score;
+        }
+    }
+    return best;
+}
+
+static uint8_t _weight(int16_t temp_dC, int32_t rise_dC_s) {
+    int32_t weight = 1;
+    if (temp_dC > THERMISTOR_SCAN_HOT_dC) {
+        weight += (temp_dC - THERMISTOR_SCAN_HOT_dC) / THERMISTOR_SCAN_HOT_STEP_dC;
+    }
+    if (rise_dC_s > 0) {
+        weight += rise_dC_s / THERMISTOR_SCAN_RISE_STEP_dC_s;
+    }
+    return (weight > THERMISTOR_SCAN_MAX_WEIGHT) ? THERMISTOR_SCAN_MAX_WEIGHT : weight;
+}
+
+void ThermistorScan_Record(uint8_t thermistor, const int16_t *cell_temperatures_dC,
+        uint8_t num_modules, uint32_t msTicks) {
+    if (thermistor >= count || num_modules == 0) {
+        return;
+    }
+
+    int16_t hottest_dC = cell_temperatures_dC[thermistor];
+    uint8_t module;
+    for (module = 1; module < num_modules; module++) {
+        int16_t temp_dC = cell_temperatures_dC[module*MAX_THERMISTORS_PER_MODULE + thermistor];
+        if (temp_dC > hottest_dC) {
+            hottest_dC = temp_dC;
+        }
+    }
+
+    THERMISTOR_SCAN_T *t = &thermistors[thermistor];
+    // readings are whole dC, so the rise is only measured over a long
+    // enough window that one step does not look like a fast rise
+    uint16_t elapsed_ms = (uint16_t)msTicks - t->rise_from_ms;
+    if (!t->read) {
+        t->rise_from_dC = hottest_dC;
+        t->rise_from_ms = msTicks;
+    } else if (elapsed_ms >= THERMISTOR_SCAN_RISE_WINDOW_ms) {
+        int32_t rise_dC_s = (int32_t)(hottest_dC - t->rise_from_dC) * 1000 / elapsed_ms;
+        t->rise_dC_s = (rise_dC_s > INT8_MAX) ? INT8_MAX :
+                (rise_dC_s < INT8_MIN) ? INT8_MIN : rise_dC_s;
+        t->rise_from_dC = hottest_dC;
+        t->rise_from_ms = msTicks;
+    }
+    t->weight = _weight(hottest_dC, t->rise_dC_s);
+    t->read = true;
+
+    uint8_t i;
+    for (i = 0; i < count; i++) {
+        if (i == thermistor) {
+            thermistors[i].age = 0;
+        } else if (thermistors[i].age < UINT8_MAX) {
+            thermistors[i].age++;
+        }
+    }
+}
+
+uint8_t ThermistorScan_GetWeight(uint8_t thermistor) {
+    return (thermistor < count) ? thermistors[thermistor].weight : 0;
+}
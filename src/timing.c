@@ -0,0 +1,121 @@
+#include "timing.h"
+
+#include "board.h"
+#include "config.h"
+#include "bms_utils.h"
+
+static TIMING_STATS_T stage_stats[TIMING_NUM_STAGES];
+static uint32_t loop_overruns;
+static uint32_t loop_start_us;
+static uint32_t last_mark_us;
+static bool loop_started;
+static TIMING_STAGE_T can_stage;
+
+static uint8_t _bucket(uint32_t duration_us) {
+    uint8_t bucket = 0;
+    while (duration_us != 0 && bucket < TIMING_NUM_BUCKETS - 1) {
+        duration_us >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+void Timing_Init(void) {
+    memset(stage_stats, 0, sizeof(stage_stats));
+    uint8_t i;
+    for (i = 0; i < TIMING_NUM_STAGES; i++) {
+        stage_stats[i].min_us = UINT32_MAX;
+    }
+    loop_overruns = 0;
+    loop_started = false;
+    can_stage = 0;
+}
+
+void Timing_LoopStart(void) {
+    uint32_t now_us = Board_Micros();
+    if (loop_started) {
+        uint32_t loop_us = now_us - loop_start_us;
+        Timing_Record(TIMING_STAGE_LOOP, loop_us);
+        if (loop_us > TIMING_LOOP_BUDGET_us) {
+            loop_overruns++;
+        }
+    }
+    loop_started = true;
+    loop_start_us = now_us;
+    last_mark_us = now_us;
+}
+
+void Timing_Mark(TIMING_STAGE_T stage) {
+    uint32_t now_us = Board_Micros();
+    Timing_Record(stage, now_us - last_mark_us);
+    last_mark_us = now_us;
+}
+
+void Timing_Record(TIMING_STAGE_T stage, uint32_t duration_us) {
+    TIMING_STATS_T *stats = &stage_stats[stage];
+    uint8_t bucket = _bucket(duration_us);
+
+    // halve the whole histogram instead of wrapping so the shape is kept
+    if (stats->buckets[bucket] == UINT16_MAX) {
+        uint8_t i;
+        for (i = 0; i < TIMING_NUM_BUCKETS; i++) {
+            stats->buckets[i] >>= 1;
+        }
+    }
+    stats->buckets[bucket]++;
+    stats->count++;
+
+    if (duration_us < stats->min_us) stats->min_us = duration_us;
+    if (duration_us > stats->max_us) stats->max_us = duration_us;
+}
+
+const TIMING_STATS_T * Timing_GetStats(TIMING_STAGE_T stage) {
+    return &stage_stats[stage];
+}
+
+uint32_t Timing_Percentile_us(TIMING_STAGE_T stage, uint8_t pct) {
+    const TIMING_STATS_T *stats = &stage_stats[stage];
+    uint32_t total = 0;
+    uint8_t i;
+    for (i = 0; i < TIMING_NUM_BUCKETS; i++) {
+        total += stats->buckets[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    uint32_t target = (total * pct + 99) / 100;
+    uint32_t cumulative = 0;
+    for (i = 0; i < TIMING_NUM_BUCKETS - 1; i++) {
+        cumulative += stats->buckets[i];
+        if (cumulative >= target) {
+            uint32_t upper_us = (1UL << i) - 1;
+            return (upper_us < stats->max_us) ? upper_us : stats->max_us;
+        }
+    }
+    return stats->max_us;
+}
+
+uint32_t Timing_GetLoopOverruns(void) {
+    return loop_overruns;
+}
+
+uint8_t Timing_PackCanFrame(uint8_t *data) {
+    TIMING_STAGE_T stage = can_stage;
+    can_stage = (can_stage + 1) % TIMING_NUM_STAGES;
+
+    const TIMING_STATS_T *stats = &stage_stats[stage];
+    uint16_t min_us = (stats->count == 0) ? 0 : Saturate_u16(stats->min_us);
+    uint16_t max_us = Saturate_u16(stats->max_us);
+    uint16_t p99_us = Saturate_u16(Timing_Percentile_us(stage, 99));
+
+    data[0] = stage;
+    data[1] = min_us & 0xFF;
+    data[2] = min_us >> 8;
+    data[3] = max_us & 0xFF;
+    data[4] = max_us >> 8;
+    data[5] = p99_us & 0xFF;
+    data[6] = p99_us >> 8;
+    data[7] = (loop_overruns > UINT8_MAX) ? UINT8_MAX : loop_overruns;
+    return 8;
+}
@@ -5,6 +5,26 @@ static void RunAllTests(void) {
   RUN_TEST_GROUP(SSM_Test);
   RUN_TEST_GROUP(Discharge_Test);
   RUN_TEST_GROUP(ERROR_Test);
+  RUN_TEST_GROUP(Timing_Test);
+  RUN_TEST_GROUP(Pack_Stats_Test);
+  RUN_TEST_GROUP(Scheduler_Test);
+  RUN_TEST_GROUP(EEPROM_Async_Test);
+  RUN_TEST_GROUP(SOC_Test);
+  RUN_TEST_GROUP(Can_Rx_Test);
+  RUN_TEST_GROUP(Can_Tx_Test);
+  RUN_TEST_GROUP(Cell_Stream_Test);
+  RUN_TEST_GROUP(Telemetry_Test);
+  RUN_TEST_GROUP(Gcv_Pipeline_Test);
+  RUN_TEST_GROUP(Mux_Sequence_Test);
+  RUN_TEST_GROUP(Pec15_Test);
+  RUN_TEST_GROUP(Sampling_Test);
+  RUN_TEST_GROUP(Thermistor_Scan_Test);
+  RUN_TEST_GROUP(Thermistor_Test);
+  RUN_TEST_GROUP(Cell_Filter_Test);
+  RUN_TEST_GROUP(Cell_History_Test);
+  RUN_TEST_GROUP(Cell_Ir_Test);
+  RUN_TEST_GROUP(Sample_Sync_Test);
+  RUN_TEST_GROUP(Current_Sense_Test);
 #ifdef FSAE_DRIVERS
   RUN_TEST_GROUP(Cell_Temperatures_Test);
 #endif // FSAE_DRIVERS
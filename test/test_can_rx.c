@@ -0,0 +1,161 @@
+#include "unity.h"
+#include "unity_fixture.h"
+#include <stdio.h>
+#include "can_rx.h"
+
+/**
+ * Testing Strategy
+ *
+ * CanRx_Drain()
+ * - empty queue
+ * - several frames drained in one pass, dispatched by key
+ * - frame without a handler
+ * - driver error between frames
+ * - more frames than CAN_RX_MAX_PER_LOOP
+ * CanRx_PackCanFrame()
+ * - counters in the frame, saturating
+ */
+
+#define FAKE_RX_LEN 64
+
+typedef struct {
+    uint32_t id;
+    uint8_t value;
+} FAKE_MSG_T;
+
+static CAN_RX_POP_STATUS_T fake_status[FAKE_RX_LEN];
+static FAKE_MSG_T fake_rx[FAKE_RX_LEN];
+static uint8_t fake_rx_len;
+static uint8_t fake_rx_pos;
+
+static uint32_t a_sum;
+static uint8_t b_calls;
+
+static void fake_push(CAN_RX_POP_STATUS_T status, uint32_t id, uint8_t value) {
+    fake_status[fake_rx_len] = status;
+    fake_rx[fake_rx_len].id = id;
+    fake_rx[fake_rx_len].value = value;
+    fake_rx_len++;
+}
+
+static CAN_RX_POP_STATUS_T fake_pop(uint32_t *key, void *msg) {
+    if (fake_rx_pos == fake_rx_len) {
+        return CAN_RX_EMPTY;
+    }
+    CAN_RX_POP_STATUS_T status = fake_status[fake_rx_pos];
+    *(FAKE_MSG_T *) msg = fake_rx[fake_rx_pos];
+    *key = fake_rx[fake_rx_pos].id;
+    fake_rx_pos++;
+    return status;
+}
+
+static void handle_a(void *msg) {
+    a_sum += ((FAKE_MSG_T *) msg)->value;
+}
+
+static void handle_b(void *msg) {
+    (void)msg;
+    b_calls++;
+}
+
+static const CAN_RX_ENTRY_T fake_table[] = {
+    {0x611, handle_a},
+    {0x100, handle_b}
+};
+
+#define FAKE_TABLE_LEN (sizeof(fake_table)/sizeof(fake_table[0]))
+
+TEST_GROUP(Can_Rx_Test);
+
+TEST_SETUP(Can_Rx_Test) {
+    printf("\r(Can_Rx_Test)Setup");
+    CanRx_Init();
+    fake_rx_len = 0;
+    fake_rx_pos = 0;
+    a_sum = 0;
+    b_calls = 0;
+    printf("...");
+}
+
+TEST_TEAR_DOWN(Can_Rx_Test) {
+    printf("...");
+    printf("Teardown\r\n");
+}
+
+TEST(Can_Rx_Test, empty) {
+    printf("empty");
+    FAKE_MSG_T msg;
+    TEST_ASSERT_EQUAL(0, CanRx_Drain(fake_table, FAKE_TABLE_LEN, fake_pop, &msg));
+    TEST_ASSERT_EQUAL(0, CanRx_GetStats()->frames);
+    TEST_ASSERT_EQUAL(0, CanRx_GetStats()->max_per_pass);
+}
+
+TEST(Can_Rx_Test, drain) {
+    printf("drain");
+    FAKE_MSG_T msg;
+    fake_push(CAN_RX_FRAME, 0x611, 3);
+    fake_push(CAN_RX_FRAME, 0x100, 0);
+    fake_push(CAN_RX_FRAME, 0x611, 4);
+    fake_push(CAN_RX_FRAME, 0x7FF, 0);
+    fake_push(CAN_RX_ERROR, 0, 0);
+    fake_push(CAN_RX_FRAME, 0x611, 5);
+
+    TEST_ASSERT_EQUAL(5, CanRx_Drain(fake_table, FAKE_TABLE_LEN, fake_pop, &msg));
+    TEST_ASSERT_EQUAL(12, a_sum);
+    TEST_ASSERT_EQUAL(1, b_calls);
+
+    const CAN_RX_STATS_T *stats = CanRx_GetStats();
+    TEST_ASSERT_EQUAL(5, stats->frames);
+    TEST_ASSERT_EQUAL(1, stats->unhandled);
+    TEST_ASSERT_EQUAL(1, stats->dropped);
+    TEST_ASSERT_EQUAL(5, stats->max_per_pass);
+    TEST_ASSERT_EQUAL(0, stats->capped);
+
+    // the most per pass stays
+    fake_push(CAN_RX_FRAME, 0x100, 0);
+    TEST_ASSERT_EQUAL(1, CanRx_Drain(fake_table, FAKE_TABLE_LEN, fake_pop, &msg));
+    TEST_ASSERT_EQUAL(5, stats->max_per_pass);
+}
+
+TEST(Can_Rx_Test, capped) {
+    printf("capped");
+    FAKE_MSG_T msg;
+    uint8_t i;
+    for (i = 0; i < CAN_RX_MAX_PER_LOOP + 3; i++) {
+        fake_push(CAN_RX_FRAME, 0x611, 1);
+    }
+
+    TEST_ASSERT_EQUAL(CAN_RX_MAX_PER_LOOP, CanRx_Drain(fake_table, FAKE_TABLE_LEN, fake_pop, &msg));
+    TEST_ASSERT_EQUAL(1, CanRx_GetStats()->capped);
+    TEST_ASSERT_EQUAL(3, CanRx_Drain(fake_table, FAKE_TABLE_LEN, fake_pop, &msg));
+    TEST_ASSERT_EQUAL(CAN_RX_MAX_PER_LOOP + 3, a_sum);
+    TEST_ASSERT_EQUAL(1, CanRx_GetStats()->capped);
+}
+
+TEST(Can_Rx_Test, pack) {
+    printf("pack");
+    FAKE_MSG_T msg;
+    uint16_t i;
+    for (i = 0; i < 3; i++) {
+        fake_push(CAN_RX_ERROR, 0, 0);
+    }
+    fake_push(CAN_RX_FRAME, 0x7FF, 0);
+    fake_push(CAN_RX_FRAME, 0x7FF, 0);
+    CanRx_Drain(fake_table, FAKE_TABLE_LEN, fake_pop, &msg);
+
+    uint8_t data[8];
+    TEST_ASSERT_EQUAL(8, CanRx_PackCanFrame(data));
+    TEST_ASSERT_EQUAL(3, data[0]);
+    TEST_ASSERT_EQUAL(0, data[1]);
+    TEST_ASSERT_EQUAL(2, data[2]);
+    TEST_ASSERT_EQUAL(0, data[3]);
+    TEST_ASSERT_EQUAL(2, data[4]);
+    TEST_ASSERT_EQUAL(0, data[5]);
+}
+
+TEST_GROUP_RUNNER(Can_Rx_Test) {
+    RUN_TEST_CASE(Can_Rx_Test, empty);
+    RUN_TEST_CASE(Can_Rx_Test, drain);
+    RUN_TEST_CASE(Can_Rx_Test, capped);
+    RUN_TEST_CASE(Can_Rx_Test, pack);
+}
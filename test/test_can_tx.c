@@ -0,0 +1,225 @@
+#include "unity.h"
+#include "unity_fixture.h"
+#include <stdio.h>
+#include "can_tx.h"
+
+/**
+ * Testing Strategy
+ *
+ * CanTx_FrameBits()
+ * - empty and full frames
+ * CanTx_AddFrame()
+ * - frames registered together are staggered
+ * CanTx_Run()
+ * - due frames go out in priority order
+ * - mailbox full: frame stays pending and is retried, later frames wait
+ * - nothing to send
+ * - several frames per period, limited by the budget
+ * - budget holds back normal frames but not safety frames
+ * - periods missed while pending
+ * CanTx_GetLoad_pct()
+ * - load over a one second window
+ */
+
+#define FAKE_LOG_LEN 16
+
+static char tx_log[FAKE_LOG_LEN + 1];
+static uint8_t tx_log_len;
+static bool mailbox_full;
+static CAN_TX_STATUS_T b_status;
+static uint8_t m_left;
+
+static CAN_TX_STATUS_T fake_send(char name, CAN_TX_STATUS_T status) {
+    if (mailbox_full) {
+        return CAN_TX_BUSY;
+    }
+    if (status != CAN_TX_NOTHING && tx_log_len < FAKE_LOG_LEN) {
+        tx_log[tx_log_len++] = name;
+        tx_log[tx_log_len] = '\0';
+    }
+    return status;
+}
+
+static CAN_TX_STATUS_T send_a(void) {
+    return fake_send('a', CAN_TX_SENT);
+}
+
+static CAN_TX_STATUS_T send_b(void) {
+    return fake_send('b', b_status);
+}
+
+static CAN_TX_STATUS_T send_s(void) {
+    return fake_send('s', CAN_TX_SENT);
+}
+
+// one period worth of m_left frames
+static CAN_TX_STATUS_T send_m(void) {
+    CAN_TX_STATUS_T status = fake_send('m', (m_left > 1) ? CAN_TX_MORE : CAN_TX_SENT);
+    if (status != CAN_TX_BUSY) {
+        m_left--;
+    }
+    return status;
+}
+
+TEST_GROUP(Can_Tx_Test);
+
+TEST_SETUP(Can_Tx_Test) {
+    printf("\r(Can_Tx_Test)Setup");
+    CanTx_Init(500000, 30, 0);
+    tx_log[0] = '\0';
+    tx_log_len = 0;
+    mailbox_full = false;
+    b_status = CAN_TX_SENT;
+    printf("...");
+}
+
+TEST_TEAR_DOWN(Can_Tx_Test) {
+    printf("...");
+    printf("Teardown\r\n");
+}
+
+TEST(Can_Tx_Test, frame_bits) {
+    printf("frame_bits");
+    TEST_ASSERT_EQUAL(55, CanTx_FrameBits(0));
+    TEST_ASSERT_EQUAL(135, CanTx_FrameBits(8));
+}
+
+TEST(Can_Tx_Test, stagger) {
+    printf("stagger");
+    TEST_ASSERT_EQUAL(0, CanTx_AddFrame("a", send_a, 100, 8, 1, 0));
+    TEST_ASSERT_EQUAL(1, CanTx_AddFrame("b", send_b, 100, 8, 1, 0));
+    TEST_ASSERT_EQUAL(2, CanTx_GetFrameCount());
+
+    TEST_ASSERT_EQUAL(1, CanTx_Run(0));
+    TEST_ASSERT_EQUAL(0, CanTx_Run(CAN_TX_STAGGER_ms - 1));
+    TEST_ASSERT_EQUAL(1, CanTx_Run(CAN_TX_STAGGER_ms));
+    TEST_ASSERT_EQUAL(1, CanTx_Run(100));
+    TEST_ASSERT_EQUAL(1, CanTx_Run(100 + CAN_TX_STAGGER_ms));
+    TEST_ASSERT_EQUAL_STRING("abab", tx_log);
+    TEST_ASSERT_EQUAL(0, CanTx_GetFrame(1)->max_latency_ms);
+}
+
+TEST(Can_Tx_Test, priority) {
+    printf("priority");
+    CanTx_AddFrame("a", send_a, 100, 8, 2, 0);
+    CanTx_AddFrame("b", send_b, 100, 8, 1, 0);
+    CanTx_AddFrame("s", send_s, 100, 8, CAN_TX_PRIORITY_SAFETY, 0);
+
+    TEST_ASSERT_EQUAL(3, CanTx_Run(2*CAN_TX_STAGGER_ms));
+    TEST_ASSERT_EQUAL_STRING("sba", tx_log);
+    TEST_ASSERT_EQUAL(2*CAN_TX_STAGGER_ms, CanTx_GetFrame(0)->max_latency_ms);
+    TEST_ASSERT_EQUAL(0, CanTx_GetFrame(2)->max_latency_ms);
+}
+
+TEST(Can_Tx_Test, mailbox_full) {
+    printf("mailbox_full");
+    CanTx_AddFrame("s", send_s, 100, 8, CAN_TX_PRIORITY_SAFETY, 0);
+    CanTx_AddFrame("a", send_a, 100, 8, 1, 0);
+
+    mailbox_full = true;
+    TEST_ASSERT_EQUAL(0, CanTx_Run(CAN_TX_STAGGER_ms));
+    TEST_ASSERT_EQUAL(1, CanTx_GetFrame(0)->retries);
+    TEST_ASSERT_EQUAL(0, CanTx_GetFrame(1)->retries);
+    TEST_ASSERT_TRUE(CanTx_GetFrame(0)->pending);
+    TEST_ASSERT_TRUE(CanTx_GetFrame(1)->pending);
+
+    mailbox_full = false;
+    TEST_ASSERT_EQUAL(2, CanTx_Run(CAN_TX_STAGGER_ms + 3));
+    TEST_ASSERT_EQUAL_STRING("sa", tx_log);
+    TEST_ASSERT_EQUAL(CAN_TX_STAGGER_ms + 3, CanTx_GetFrame(0)->max_latency_ms);
+    TEST_ASSERT_EQUAL(3, CanTx_GetFrame(1)->max_latency_ms);
+    TEST_ASSERT_EQUAL(0, CanTx_GetFrame(0)->missed);
+}
+
+TEST(Can_Tx_Test, nothing) {
+    printf("nothing");
+    CanTx_AddFrame("b", send_b, 100, 8, 1, 0);
+
+    b_status = CAN_TX_NOTHING;
+    TEST_ASSERT_EQUAL(0, CanTx_Run(0));
+    TEST_ASSERT_FALSE(CanTx_GetFrame(0)->pending);
+    TEST_ASSERT_EQUAL(0, CanTx_GetFrame(0)->sent);
+
+    b_status = CAN_TX_SENT;
+    TEST_ASSERT_EQUAL(0, CanTx_Run(99));
+    TEST_ASSERT_EQUAL(1, CanTx_Run(100));
+}
+
+TEST(Can_Tx_Test, more) {
+    printf("more");
+    // 5 bits/ms, holding one full frame
+    CanTx_Init(500000, 1, 0);
+    CanTx_AddFrame("m", send_m, 1000, 8, 2, 0);
+    m_left = 3;
+
+    TEST_ASSERT_EQUAL(1, CanTx_Run(0));
+    TEST_ASSERT_TRUE(CanTx_GetFrame(0)->pending);
+    TEST_ASSERT_EQUAL(1, CanTx_GetFrame(0)->deferred);
+
+    // a full mailbox does not lose the frame
+    mailbox_full = true;
+    TEST_ASSERT_EQUAL(0, CanTx_Run(27));
+    mailbox_full = false;
+    TEST_ASSERT_EQUAL(1, CanTx_Run(28));
+
+    // plenty of budget: the rest of the period goes out in one pass
+    CanTx_Init(500000, 30, 100);
+    CanTx_AddFrame("m", send_m, 1000, 8, 2, 100);
+    m_left = 5;
+    TEST_ASSERT_EQUAL(5, CanTx_Run(100));
+    TEST_ASSERT_FALSE(CanTx_GetFrame(0)->pending);
+    TEST_ASSERT_EQUAL(5, CanTx_GetFrame(0)->sent);
+    TEST_ASSERT_EQUAL_STRING("mmmmmmm", tx_log);
+}
+
+TEST(Can_Tx_Test, budget) {
+    printf("budget");
+    // 5 bits/ms, holding one full frame
+    CanTx_Init(500000, 1, 0);
+    CanTx_AddFrame("a", send_a, 10, 8, 1, 0);
+    CanTx_AddFrame("s", send_s, 1000, 8, CAN_TX_PRIORITY_SAFETY, 0);
+
+    // safety frame spends the budget, the other one waits for it to refill
+    TEST_ASSERT_EQUAL(1, CanTx_Run(CAN_TX_STAGGER_ms));
+    TEST_ASSERT_EQUAL_STRING("s", tx_log);
+    TEST_ASSERT_EQUAL(1, CanTx_GetFrame(0)->deferred);
+
+    TEST_ASSERT_EQUAL(0, CanTx_Run(CAN_TX_STAGGER_ms + 26));
+    TEST_ASSERT_EQUAL(2, CanTx_GetFrame(0)->deferred);
+    TEST_ASSERT_EQUAL(1, CanTx_Run(CAN_TX_STAGGER_ms + 27));
+    TEST_ASSERT_EQUAL_STRING("sa", tx_log);
+    TEST_ASSERT_EQUAL(CAN_TX_STAGGER_ms + 27, CanTx_GetFrame(0)->max_latency_ms);
+    // due at 10, 20 and 30 while still pending
+    TEST_ASSERT_EQUAL(3, CanTx_GetFrame(0)->missed);
+
+    // an empty budget does not hold back the safety frame
+    TEST_ASSERT_EQUAL(1, CanTx_Run(1000 + CAN_TX_STAGGER_ms));
+    TEST_ASSERT_EQUAL_STRING("sas", tx_log);
+}
+
+TEST(Can_Tx_Test, load) {
+    printf("load");
+    CanTx_AddFrame("a", send_a, 10, 8, 1, 0);
+
+    uint32_t t;
+    for (t = 0; t < 1000; t++) {
+        CanTx_Run(t);
+    }
+    TEST_ASSERT_EQUAL(0, CanTx_GetLoad_pct());
+    TEST_ASSERT_EQUAL(100, CanTx_GetFrame(0)->sent);
+
+    // 100 frames of 135 bits at 500 kbit/s
+    CanTx_Run(1000);
+    TEST_ASSERT_EQUAL(2, CanTx_GetLoad_pct());
+}
+
+TEST_GROUP_RUNNER(Can_Tx_Test) {
+    RUN_TEST_CASE(Can_Tx_Test, frame_bits);
+    RUN_TEST_CASE(Can_Tx_Test, stagger);
+    RUN_TEST_CASE(Can_Tx_Test, priority);
+    RUN_TEST_CASE(Can_Tx_Test, mailbox_full);
+    RUN_TEST_CASE(Can_Tx_Test, nothing);
+    RUN_TEST_CASE(Can_Tx_Test, more);
+    RUN_TEST_CASE(Can_Tx_Test, budget);
+    RUN_TEST_CASE(Can_Tx_Test, load);
+}
@@ -0,0 +1,159 @@
+#include "unity.h"
+#include "unity_fixture.h"
+#include <stdio.h>
+#include "cell_filter.h"
+
+/**
+ * Testing Strategy
+ *
+ * CellFilter_Update()
+ * - mode: none, IIR, median of three
+ * - first update after init: output is the readback
+ * - sample within CELL_FILTER_OUTLIER_mV: filtered
+ * - median step larger than the 127 mV the history holds: settles on the step
+ * - outlier: dropped, up to CELL_FILTER_OUTLIER_MAX in a row, then taken
+ *   as a step
+ * - outlier followed by a good sample: the count starts over
+ * - cells are filtered independently
+ */
+
+#define CELLS 3
+
+static uint32_t raw[CELLS];
+static uint32_t filtered[CELLS];
+
+static void update(uint32_t a, uint32_t b, uint32_t c) {
+    raw[0] = a;
+    raw[1] = b;
+    raw[2] = c;
+    CellFilter_Update(raw, filtered, CELLS);
+}
+
+TEST_GROUP(Cell_Filter_Test);
+
+TEST_SETUP(Cell_Filter_Test) {
+    printf("\r(Cell_Filter_Test)Setup");
+    CellFilter_Init(CELL_FILTER_MEDIAN3);
+    printf("...");
+}
+
+TEST_TEAR_DOWN(Cell_Filter_Test) {
+    printf("...");
+    printf("Teardown\r\n");
+}
+
+TEST(Cell_Filter_Test, none) {
+    printf("none");
+    CellFilter_Init(CELL_FILTER_NONE);
+    update(3600, 3500, 3400);
+    update(4000, 3500, 3400);
+    TEST_ASSERT_EQUAL(4000, filtered[0]);
+    TEST_ASSERT_EQUAL(0, CellFilter_GetRejected());
+}
+
+TEST(Cell_Filter_Test, seed) {
+    printf("seed");
+    update(3600, 3500, 3400);
+    TEST_ASSERT_EQUAL(3600, filtered[0]);
+    TEST_ASSERT_EQUAL(3500, filtered[1]);
+    TEST_ASSERT_EQUAL(3400, filtered[2]);
+
+    // init forgets the history
+    CellFilter_Init(CELL_FILTER_MEDIAN3);
+    update(3000, 3000, 3000);
+    TEST_ASSERT_EQUAL(3000, filtered[0]);
+}
+
+TEST(Cell_Filter_Test, median) {
+    printf("median");
+    update(3600, 3600, 3600);
+
+    // a one sample spike never shows
+    update(3700, 3600, 3500);
+    TEST_ASSERT_EQUAL(3600, filtered[0]);
+    TEST_ASSERT_EQUAL(3600, filtered[2]);
+    update(3600, 3600, 3600);
+    TEST_ASSERT_EQUAL(3600, filtered[0]);
+    update(3600, 3600, 3600);
+
+    // a step shows one sample late
+    update(3650, 3600, 3600);
+    TEST_ASSERT_EQUAL(3600, filtered[0]);
+    update(3650, 3600, 3600);
+    TEST_ASSERT_EQUAL(3650, filtered[0]);
+    TEST_ASSERT_EQUAL(0, CellFilter_GetRejected());
+}
+
+TEST(Cell_Filter_Test, median_large_step) {
+    printf("median_large_step");
+    update(3600, 3600, 3600);
+    update(3740, 3600, 3600);
+    TEST_ASSERT_EQUAL(3600, filtered[0]);
+    // the first step sample was held as 127 mV above the output
+    update(3740, 3600, 3600);
+    TEST_ASSERT_EQUAL(3727, filtered[0]);
+    update(3740, 3600, 3600);
+    TEST_ASSERT_EQUAL(3740, filtered[0]);
+    TEST_ASSERT_EQUAL(0, CellFilter_GetRejected());
+}
+
+TEST(Cell_Filter_Test, iir) {
+    printf("iir");
+    CellFilter_Init(CELL_FILTER_IIR);
+    update(3600, 3600, 3600);
+
+    // 1/4 of the way per sample with a shift of 2
+    update(3700, 3600, 3600);
+    TEST_ASSERT_EQUAL(3600 + (100 >> CELL_FILTER_IIR_SHIFT), filtered[0]);
+    TEST_ASSERT_EQUAL(3600, filtered[1]);
+
+    uint8_t i;
+    for (i = 0; i < 40; i++) {
+        update(3700, 3600, 3600);
+    }
+    TEST_ASSERT_EQUAL(3700, filtered[0]);
+}
+
+TEST(Cell_Filter_Test, outlier) {
+    printf("outlier");
+    update(3600, 3600, 3600);
+
+    uint8_t i;
+    for (i = 0; i < CELL_FILTER_OUTLIER_MAX; i++) {
+        update(3600, 3600 + CELL_FILTER_OUTLIER_mV + 1, 3600);
+        TEST_ASSERT_EQUAL(3600, filtered[1]);
+    }
+    TEST_ASSERT_EQUAL(CELL_FILTER_OUTLIER_MAX, CellFilter_GetRejected());
+
+    // it stayed, so it is a real step
+    update(3600, 3600 + CELL_FILTER_OUTLIER_mV + 1, 3600);
+    TEST_ASSERT_EQUAL(3600 + CELL_FILTER_OUTLIER_mV + 1, filtered[1]);
+    TEST_ASSERT_EQUAL(CELL_FILTER_OUTLIER_MAX, CellFilter_GetRejected());
+}
+
+TEST(Cell_Filter_Test, outlier_interrupted) {
+    printf("outlier_interrupted");
+    CellFilter_Init(CELL_FILTER_IIR);
+    update(3600, 3600, 3600);
+
+    uint8_t i;
+    for (i = 0; i < CELL_FILTER_OUTLIER_MAX; i++) {
+        update(0, 3600, 3600);
+    }
+    update(3600, 3600, 3600);
+    for (i = 0; i < CELL_FILTER_OUTLIER_MAX; i++) {
+        update(0, 3600, 3600);
+        TEST_ASSERT_EQUAL(3600, filtered[0]);
+    }
+    TEST_ASSERT_EQUAL(2*CELL_FILTER_OUTLIER_MAX, CellFilter_GetRejected());
+}
+
+TEST_GROUP_RUNNER(Cell_Filter_Test) {
+    RUN_TEST_CASE(Cell_Filter_Test, none);
+    RUN_TEST_CASE(Cell_Filter_Test, seed);
+    RUN_TEST_CASE(Cell_Filter_Test, median);
+    RUN_TEST_CASE(Cell_Filter_Test, median_large_step);
+    RUN_TEST_CASE(Cell_Filter_Test, iir);
+    RUN_TEST_CASE(Cell_Filter_Test, outlier);
+    RUN_TEST_CASE(Cell_Filter_Test, outlier_interrupted);
+}
@@ -0,0 +1,142 @@
+#include "unity.h"
+#include "unity_fixture.h"
+#include <stdio.h>
+#include "cell_history.h"
+
+/**
+ * Testing Strategy
+ *
+ * CellHistory_Append()
+ * - first sample, sample before and after CELL_HISTORY_PERIOD_ms
+ * - window filling up, then full and sliding
+ * - another cell lowest by less than, then by more than CELL_HISTORY_SWITCH_mV
+ * CellHistory_GetSlope_mV_s(), CellHistory_GetAverageSlope_mV_s()
+ * - fewer than two samples, rising, falling
+ * CellHistory_GetSample_mV()
+ * - newest and oldest sample
+ * CellHistory_GetSag_mV_s()
+ * - every cell falling together: no sag
+ * - the lowest cell falling faster than the average
+ */
+
+#define CELLS 4
+
+static uint32_t voltages[CELLS];
+
+static void set(uint32_t a, uint32_t b, uint32_t c, uint32_t d) {
+    voltages[0] = a;
+    voltages[1] = b;
+    voltages[2] = c;
+    voltages[3] = d;
+}
+
+// what pack_stats.c publishes for the readback in voltages
+static bool append(uint32_t msTicks) {
+    uint16_t min_position = 0;
+    uint32_t total_mV = 0;
+    uint8_t i;
+    for (i = 0; i < CELLS; i++) {
+        total_mV += voltages[i];
+        if (voltages[i] < voltages[min_position]) {
+            min_position = i;
+        }
+    }
+    return CellHistory_Append(voltages, min_position, total_mV / CELLS, msTicks);
+}
+
+TEST_GROUP(Cell_History_Test);
+
+TEST_SETUP(Cell_History_Test) {
+    printf("\r(Cell_History_Test)Setup");
+    CellHistory_Init();
+    printf("...");
+}
+
+TEST_TEAR_DOWN(Cell_History_Test) {
+    printf("...");
+    printf("Teardown\r\n");
+}
+
+TEST(Cell_History_Test, period) {
+    printf("period");
+    set(3600, 3600, 3600, 3600);
+    TEST_ASSERT_TRUE(append(1000));
+    TEST_ASSERT_EQUAL(0, CellHistory_GetSlope_mV_s());
+    TEST_ASSERT_FALSE(append(1000 + CELL_HISTORY_PERIOD_ms - 1));
+    TEST_ASSERT_EQUAL(1, CellHistory_GetCount());
+    TEST_ASSERT_TRUE(append(1000 + CELL_HISTORY_PERIOD_ms));
+    TEST_ASSERT_EQUAL(2, CellHistory_GetCount());
+    TEST_ASSERT_EQUAL(CELL_HISTORY_PERIOD_ms, CellHistory_GetSpan_ms());
+}
+
+TEST(Cell_History_Test, slope) {
+    printf("slope");
+    uint32_t t = 0;
+    uint8_t i;
+    // cell 0 is lowest and falls 4 mV per sample, cell 1 rises 4
+    for (i = 0; i < CELL_HISTORY_LEN + 3; i++) {
+        set(3500 - 4*i, 3600 + 4*i, 3600, 3600);
+        append(t);
+        t += CELL_HISTORY_PERIOD_ms;
+    }
+    TEST_ASSERT_EQUAL(0, CellHistory_GetCell());
+    TEST_ASSERT_EQUAL(CELL_HISTORY_LEN, CellHistory_GetCount());
+    TEST_ASSERT_EQUAL((CELL_HISTORY_LEN - 1)*CELL_HISTORY_PERIOD_ms, CellHistory_GetSpan_ms());
+    TEST_ASSERT_EQUAL(-4*1000/CELL_HISTORY_PERIOD_ms, CellHistory_GetSlope_mV_s());
+    TEST_ASSERT_EQUAL(0, CellHistory_GetAverageSlope_mV_s());
+
+    TEST_ASSERT_EQUAL(3500 - 4*(CELL_HISTORY_LEN + 2), CellHistory_GetSample_mV(0));
+    TEST_ASSERT_EQUAL(3500 - 4*3, CellHistory_GetSample_mV(CELL_HISTORY_LEN - 1));
+}
+
+TEST(Cell_History_Test, switch_cell) {
+    printf("switch_cell");
+    set(3600, 3605, 3605, 3605);
+    append(0);
+    TEST_ASSERT_EQUAL(0, CellHistory_GetCell());
+
+    // cell 1 is lowest now, but not by enough to restart the window
+    set(3600, 3600 - CELL_HISTORY_SWITCH_mV, 3605, 3605);
+    append(CELL_HISTORY_PERIOD_ms);
+    TEST_ASSERT_EQUAL(0, CellHistory_GetCell());
+    TEST_ASSERT_EQUAL(2, CellHistory_GetCount());
+
+    set(3600, 3600 - CELL_HISTORY_SWITCH_mV - 1, 3605, 3605);
+    append(2*CELL_HISTORY_PERIOD_ms);
+    TEST_ASSERT_EQUAL(1, CellHistory_GetCell());
+    TEST_ASSERT_EQUAL(1, CellHistory_GetCount());
+    TEST_ASSERT_EQUAL(3600 - CELL_HISTORY_SWITCH_mV - 1, CellHistory_GetSample_mV(0));
+}
+
+TEST(Cell_History_Test, sag) {
+    printf("sag");
+    uint16_t position = 0;
+    uint32_t t = 0;
+    uint8_t i;
+
+    // a load step pulls every cell down alike
+    for (i = 0; i < 4; i++) {
+        uint32_t v = 3600 - 50*i;
+        set(v, v, v, v);
+        append(t);
+        t += CELL_HISTORY_PERIOD_ms;
+    }
+    TEST_ASSERT_EQUAL(0, CellHistory_GetSag_mV_s(&position));
+
+    // cell 2 keeps falling on its own
+    for (i = 0; i < CELL_HISTORY_LEN; i++) {
+        set(3450, 3450, 3450 - 20*(i+1), 3450);
+        append(t);
+        t += CELL_HISTORY_PERIOD_ms;
+    }
+    // -40 mV/s against an average of -10 mV/s
+    TEST_ASSERT_EQUAL(30, CellHistory_GetSag_mV_s(&position));
+    TEST_ASSERT_EQUAL(2, position);
+}
+
+TEST_GROUP_RUNNER(Cell_History_Test) {
+    RUN_TEST_CASE(Cell_History_Test, period);
+    RUN_TEST_CASE(Cell_History_Test, slope);
+    RUN_TEST_CASE(Cell_History_Test, switch_cell);
+    RUN_TEST_CASE(Cell_History_Test, sag);
+}
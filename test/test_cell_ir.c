@@ -0,0 +1,161 @@
+#include "unity.h"
+#include "unity_fixture.h"
+#include <stdio.h>
+#include "cell_ir.h"
+
+/**
+ * Testing Strategy
+ *
+ * CellIr_Update()
+ * - first readback only recorded
+ * - discharge step, release step blended into the estimate
+ * - charge step
+ * - step below CELL_IR_MIN_STEP_mA, readbacks too far apart
+ * - cell rising on a discharge step left alone
+ * - a pack wider than CELL_IR_WINDOW, one window per step
+ * CellIr_MaxCurrent_mA()
+ * - no estimates, weakest cell sets the limit, cell already below the minimum
+ */
+
+#define CELLS 3
+
+static uint32_t voltages[CELLS];
+static uint16_t cell_ir_uOhm[CELLS];
+
+static void set(uint32_t a, uint32_t b, uint32_t c) {
+    voltages[0] = a;
+    voltages[1] = b;
+    voltages[2] = c;
+}
+
+TEST_GROUP(Cell_Ir_Test);
+
+TEST_SETUP(Cell_Ir_Test) {
+    printf("\r(Cell_Ir_Test)Setup");
+    uint8_t i;
+    for (i = 0; i < CELLS; i++) {
+        cell_ir_uOhm[i] = 0;
+    }
+    CellIr_Init();
+    printf("...");
+}
+
+TEST_TEAR_DOWN(Cell_Ir_Test) {
+    printf("...");
+    printf("Teardown\r\n");
+}
+
+TEST(Cell_Ir_Test, discharge_step) {
+    printf("discharge_step");
+    uint32_t updates = CellIr_GetUpdates();
+    set(3600, 3600, 3600);
+    TEST_ASSERT_FALSE(CellIr_Update(voltages, CELLS, 0, 0, cell_ir_uOhm));
+    TEST_ASSERT_EQUAL(0, cell_ir_uOhm[0]);
+
+    // 20 A out of the pack
+    set(3560, 3540, 3601);
+    TEST_ASSERT_TRUE(CellIr_Update(voltages, CELLS, 20000, 100, cell_ir_uOhm));
+    TEST_ASSERT_EQUAL(2000, cell_ir_uOhm[0]);
+    TEST_ASSERT_EQUAL(3000, cell_ir_uOhm[1]);
+    TEST_ASSERT_EQUAL(0, cell_ir_uOhm[2]);
+    TEST_ASSERT_EQUAL(updates + 1, CellIr_GetUpdates());
+
+    // and back off: cell 0 reads 2400 uOhm this time
+    set(3608, 3600, 3601);
+    TEST_ASSERT_TRUE(CellIr_Update(voltages, CELLS, 0, 200, cell_ir_uOhm));
+    TEST_ASSERT_EQUAL(2000 + (400 >> CELL_IR_SHIFT), cell_ir_uOhm[0]);
+    TEST_ASSERT_EQUAL(3000, cell_ir_uOhm[1]);
+}
+
+TEST(Cell_Ir_Test, charge_step) {
+    printf("charge_step");
+    set(3600, 3600, 3600);
+    CellIr_Update(voltages, CELLS, 0, 0, cell_ir_uOhm);
+    set(3640, 3630, 3620);
+    TEST_ASSERT_TRUE(CellIr_Update(voltages, CELLS, -20000, 100, cell_ir_uOhm));
+    TEST_ASSERT_EQUAL(2000, cell_ir_uOhm[0]);
+    TEST_ASSERT_EQUAL(1500, cell_ir_uOhm[1]);
+    TEST_ASSERT_EQUAL(1000, cell_ir_uOhm[2]);
+}
+
+TEST(Cell_Ir_Test, ignored) {
+    printf("ignored");
+    set(3600, 3600, 3600);
+    CellIr_Update(voltages, CELLS, 0, 0, cell_ir_uOhm);
+
+    // too small a step
+    set(3590, 3590, 3590);
+    TEST_ASSERT_FALSE(CellIr_Update(voltages, CELLS, CELL_IR_MIN_STEP_mA - 1, 100, cell_ir_uOhm));
+
+    // too long after the last readback
+    set(3550, 3550, 3550);
+    TEST_ASSERT_FALSE(CellIr_Update(voltages, CELLS, 3*CELL_IR_MIN_STEP_mA,
+            100 + CELL_IR_MAX_GAP_ms + 1, cell_ir_uOhm));
+    TEST_ASSERT_EQUAL(0, cell_ir_uOhm[0]);
+
+    // but that readback is the base for the next step
+    set(3510, 3510, 3510);
+    TEST_ASSERT_TRUE(CellIr_Update(voltages, CELLS, 3*CELL_IR_MIN_STEP_mA + 20000,
+            200 + CELL_IR_MAX_GAP_ms, cell_ir_uOhm));
+    TEST_ASSERT_EQUAL(2000, cell_ir_uOhm[0]);
+}
+
+TEST(Cell_Ir_Test, window) {
+    printf("window");
+    uint32_t wide_mV[CELL_IR_WINDOW + 2];
+    uint16_t wide_uOhm[CELL_IR_WINDOW + 2];
+    uint16_t i;
+    for (i = 0; i < CELL_IR_WINDOW + 2; i++) {
+        wide_mV[i] = 3600;
+        wide_uOhm[i] = 0;
+    }
+    CellIr_Update(wide_mV, CELL_IR_WINDOW + 2, 0, 0, wide_uOhm);
+
+    // every cell drops 40 mV, only the first window is measured
+    for (i = 0; i < CELL_IR_WINDOW + 2; i++) {
+        wide_mV[i] = 3560;
+    }
+    TEST_ASSERT_TRUE(CellIr_Update(wide_mV, CELL_IR_WINDOW + 2, 20000, 100, wide_uOhm));
+    TEST_ASSERT_EQUAL(2000, wide_uOhm[0]);
+    TEST_ASSERT_EQUAL(2000, wide_uOhm[CELL_IR_WINDOW - 1]);
+    TEST_ASSERT_EQUAL(0, wide_uOhm[CELL_IR_WINDOW]);
+
+    // the release measures the rest, then the pack wraps round
+    for (i = 0; i < CELL_IR_WINDOW + 2; i++) {
+        wide_mV[i] = 3590;
+    }
+    TEST_ASSERT_TRUE(CellIr_Update(wide_mV, CELL_IR_WINDOW + 2, 0, 200, wide_uOhm));
+    TEST_ASSERT_EQUAL(1500, wide_uOhm[CELL_IR_WINDOW]);
+    TEST_ASSERT_EQUAL(1500, wide_uOhm[CELL_IR_WINDOW + 1]);
+    TEST_ASSERT_EQUAL(2000, wide_uOhm[0]);
+
+    for (i = 0; i < CELL_IR_WINDOW + 2; i++) {
+        wide_mV[i] = 3545;
+    }
+    TEST_ASSERT_TRUE(CellIr_Update(wide_mV, CELL_IR_WINDOW + 2, 20000, 300, wide_uOhm));
+    TEST_ASSERT_EQUAL(2000 + (250 >> CELL_IR_SHIFT), wide_uOhm[0]);
+    TEST_ASSERT_EQUAL(1500, wide_uOhm[CELL_IR_WINDOW]);
+}
+
+TEST(Cell_Ir_Test, max_current) {
+    printf("max_current");
+    TEST_ASSERT_EQUAL(UINT32_MAX, CellIr_MaxCurrent_mA(voltages, cell_ir_uOhm, CELLS, 0, 3000));
+
+    // at 50 A both cells rest at 3600 mV: 300 A and 150 A down to 3000 mV
+    set(3500, 3400, 3000);
+    cell_ir_uOhm[0] = 2000;
+    cell_ir_uOhm[1] = 4000;
+    TEST_ASSERT_EQUAL(150000, CellIr_MaxCurrent_mA(voltages, cell_ir_uOhm, CELLS, 50000, 3000));
+
+    // no headroom left
+    cell_ir_uOhm[2] = 1000;
+    TEST_ASSERT_EQUAL(0, CellIr_MaxCurrent_mA(voltages, cell_ir_uOhm, CELLS, 0, 3000));
+}
+
+TEST_GROUP_RUNNER(Cell_Ir_Test) {
+    RUN_TEST_CASE(Cell_Ir_Test, discharge_step);
+    RUN_TEST_CASE(Cell_Ir_Test, charge_step);
+    RUN_TEST_CASE(Cell_Ir_Test, ignored);
+    RUN_TEST_CASE(Cell_Ir_Test, window);
+    RUN_TEST_CASE(Cell_Ir_Test, max_current);
+}
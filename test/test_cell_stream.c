@@ -0,0 +1,190 @@
+#include "unity.h"
+#include "unity_fixture.h"
+#include <stdio.h>
+#include <string.h>
+#include "cell_stream.h"
+
+/**
+ * Testing Strategy
+ *
+ * CellStream_NumPages()
+ * - 0, full pages, partial last page
+ * CellStream_PackVoltages()
+ * - full page, short last page, voltages above 16 bits
+ * - empty pack
+ * CellStream_PackTemperatures()
+ * - negative temperatures
+ * CellStream_PackResistances()
+ * - short last page
+ * CellStream_NextPage()
+ * - sweep wraps, pack shrinking mid sweep
+ * CellStream_Send()
+ * - pages sent in order, mailbox busy, empty pack
+ */
+
+static uint32_t stream_voltages_mV[7];
+static int16_t stream_temperatures_dC[3];
+static CELL_STREAM_T stream;
+
+static bool stream_busy;
+static uint8_t stream_sent;
+static uint32_t stream_can_id;
+static uint8_t stream_data[8];
+static uint8_t stream_len;
+
+static CAN_TX_STATUS_T Fake_Transmit(uint32_t can_id, const uint8_t *data, uint8_t len) {
+    if (stream_busy) {
+        return CAN_TX_BUSY;
+    }
+    stream_sent++;
+    stream_can_id = can_id;
+    memcpy(stream_data, data, len);
+    stream_len = len;
+    return CAN_TX_SENT;
+}
+
+TEST_GROUP(Cell_Stream_Test);
+
+TEST_SETUP(Cell_Stream_Test) {
+    printf("\r(Cell_Stream_Test)Setup");
+    uint8_t i;
+    for (i = 0; i < 7; i++) {
+        stream_voltages_mV[i] = 3000 + i;
+    }
+    CellStream_Init(&stream);
+    stream_busy = false;
+    stream_sent = 0;
+    printf("...");
+}
+
+TEST_TEAR_DOWN(Cell_Stream_Test) {
+    printf("...");
+    printf("Teardown\r\n");
+}
+
+TEST(Cell_Stream_Test, num_pages) {
+    printf("num_pages");
+    TEST_ASSERT_EQUAL(0, CellStream_NumPages(0));
+    TEST_ASSERT_EQUAL(1, CellStream_NumPages(3));
+    TEST_ASSERT_EQUAL(3, CellStream_NumPages(7));
+    TEST_ASSERT_EQUAL(120, CellStream_NumPages(15*24));
+}
+
+TEST(Cell_Stream_Test, voltages) {
+    printf("voltages");
+    uint8_t data[8];
+
+    TEST_ASSERT_EQUAL(8, CellStream_PackVoltages(&stream, stream_voltages_mV, 7, data));
+    TEST_ASSERT_EQUAL(0, data[0]);
+    TEST_ASSERT_EQUAL(3, data[1]);
+    TEST_ASSERT_EQUAL(3000 & 0xFF, data[2]);
+    TEST_ASSERT_EQUAL(3000 >> 8, data[3]);
+    TEST_ASSERT_EQUAL(3002 & 0xFF, data[6]);
+    TEST_ASSERT_EQUAL(3002 >> 8, data[7]);
+
+    // packing again without advancing repeats the page
+    TEST_ASSERT_EQUAL(8, CellStream_PackVoltages(&stream, stream_voltages_mV, 7, data));
+    TEST_ASSERT_EQUAL(0, data[0]);
+
+    TEST_ASSERT_FALSE(CellStream_NextPage(&stream, 7));
+    TEST_ASSERT_FALSE(CellStream_NextPage(&stream, 7));
+
+    // last page holds one cell
+    stream_voltages_mV[6] = 70000;
+    TEST_ASSERT_EQUAL(4, CellStream_PackVoltages(&stream, stream_voltages_mV, 7, data));
+    TEST_ASSERT_EQUAL(2, data[0]);
+    TEST_ASSERT_EQUAL(0xFF, data[2]);
+    TEST_ASSERT_EQUAL(0xFF, data[3]);
+
+    TEST_ASSERT_TRUE(CellStream_NextPage(&stream, 7));
+    CellStream_PackVoltages(&stream, stream_voltages_mV, 7, data);
+    TEST_ASSERT_EQUAL(0, data[0]);
+}
+
+TEST(Cell_Stream_Test, empty) {
+    printf("empty");
+    uint8_t data[8];
+    TEST_ASSERT_EQUAL(0, CellStream_PackVoltages(&stream, stream_voltages_mV, 0, data));
+}
+
+TEST(Cell_Stream_Test, temperatures) {
+    printf("temperatures");
+    uint8_t data[8];
+    stream_temperatures_dC[0] = 250;
+    stream_temperatures_dC[1] = -105;
+    stream_temperatures_dC[2] = 0;
+
+    TEST_ASSERT_EQUAL(8, CellStream_PackTemperatures(&stream, stream_temperatures_dC, 3, data));
+    TEST_ASSERT_EQUAL(1, data[1]);
+    TEST_ASSERT_EQUAL(250, data[2] | (data[3] << 8));
+    TEST_ASSERT_EQUAL(-105, (int16_t)(data[4] | (data[5] << 8)));
+    TEST_ASSERT_TRUE(CellStream_NextPage(&stream, 3));
+}
+
+TEST(Cell_Stream_Test, resistances) {
+    printf("resistances");
+    uint8_t data[8];
+    uint16_t cell_ir_uOhm[4] = {1500, 0, 65535, 2200};
+
+    TEST_ASSERT_EQUAL(8, CellStream_PackResistances(&stream, cell_ir_uOhm, 4, data));
+    TEST_ASSERT_EQUAL(2, data[1]);
+    TEST_ASSERT_EQUAL(1500, data[2] | (data[3] << 8));
+    TEST_ASSERT_EQUAL(0, data[4] | (data[5] << 8));
+    TEST_ASSERT_EQUAL(65535, data[6] | (data[7] << 8));
+    TEST_ASSERT_FALSE(CellStream_NextPage(&stream, 4));
+
+    TEST_ASSERT_EQUAL(4, CellStream_PackResistances(&stream, cell_ir_uOhm, 4, data));
+    TEST_ASSERT_EQUAL(1, data[0]);
+    TEST_ASSERT_EQUAL(2200, data[2] | (data[3] << 8));
+    TEST_ASSERT_TRUE(CellStream_NextPage(&stream, 4));
+}
+
+TEST(Cell_Stream_Test, shrink) {
+    printf("shrink");
+    uint8_t data[8];
+    CellStream_NextPage(&stream, 7);
+    CellStream_NextPage(&stream, 7);
+
+    // page 2 no longer exists, start the sweep over
+    TEST_ASSERT_EQUAL(8, CellStream_PackVoltages(&stream, stream_voltages_mV, 6, data));
+    TEST_ASSERT_EQUAL(0, data[0]);
+    TEST_ASSERT_EQUAL(2, data[1]);
+}
+
+TEST(Cell_Stream_Test, send) {
+    printf("send");
+    TEST_ASSERT_EQUAL(CAN_TX_MORE, CellStream_Send(&stream, 0x123, CellStream_PackVoltages,
+            stream_voltages_mV, 7, Fake_Transmit));
+    TEST_ASSERT_EQUAL(0x123, stream_can_id);
+    TEST_ASSERT_EQUAL(8, stream_len);
+    TEST_ASSERT_EQUAL(0, stream_data[0]);
+
+    // a full mailbox keeps the page
+    stream_busy = true;
+    TEST_ASSERT_EQUAL(CAN_TX_BUSY, CellStream_Send(&stream, 0x123, CellStream_PackVoltages,
+            stream_voltages_mV, 7, Fake_Transmit));
+    stream_busy = false;
+    TEST_ASSERT_EQUAL(CAN_TX_MORE, CellStream_Send(&stream, 0x123, CellStream_PackVoltages,
+            stream_voltages_mV, 7, Fake_Transmit));
+    TEST_ASSERT_EQUAL(1, stream_data[0]);
+    TEST_ASSERT_EQUAL(CAN_TX_SENT, CellStream_Send(&stream, 0x123, CellStream_PackVoltages,
+            stream_voltages_mV, 7, Fake_Transmit));
+    TEST_ASSERT_EQUAL(2, stream_data[0]);
+    TEST_ASSERT_EQUAL(4, stream_len);
+    TEST_ASSERT_EQUAL(3006, stream_data[2] | (stream_data[3] << 8));
+    TEST_ASSERT_EQUAL(3, stream_sent);
+
+    TEST_ASSERT_EQUAL(CAN_TX_NOTHING, CellStream_Send(&stream, 0x123, CellStream_PackVoltages,
+            stream_voltages_mV, 0, Fake_Transmit));
+    TEST_ASSERT_EQUAL(3, stream_sent);
+}
+
+TEST_GROUP_RUNNER(Cell_Stream_Test) {
+    RUN_TEST_CASE(Cell_Stream_Test, num_pages);
+    RUN_TEST_CASE(Cell_Stream_Test, voltages);
+    RUN_TEST_CASE(Cell_Stream_Test, empty);
+    RUN_TEST_CASE(Cell_Stream_Test, temperatures);
+    RUN_TEST_CASE(Cell_Stream_Test, resistances);
+    RUN_TEST_CASE(Cell_Stream_Test, shrink);
+    RUN_TEST_CASE(Cell_Stream_Test, send);
+}
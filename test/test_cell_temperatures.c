@@ -23,7 +23,7 @@ void setExpectedCellTemperatures(int16_t * expectedCellTemperatures,
     for (i=0; i<MAX_NUM_MODULES*MAX_THERMISTORS_PER_MODULE; i++) {
         expectedCellTemperatures[i] = -39;
     }
-    expectedCellTemperatures[0*MAX_THERMISTORS_PER_MODULE + currentThermistor] = 60;
+    expectedCellTemperatures[0*MAX_THERMISTORS_PER_MODULE + currentThermistor] = 61;
     expectedCellTemperatures[1*MAX_THERMISTORS_PER_MODULE + currentThermistor] = 60;
     expectedCellTemperatures[2*MAX_THERMISTORS_PER_MODULE + currentThermistor] = 0;
     expectedCellTemperatures[3*MAX_THERMISTORS_PER_MODULE + currentThermistor] = -14;
@@ -115,12 +115,12 @@ TEST_SETUP(Cell_Temperatures_Test) {
     for (i=0; i<MAX_NUM_MODULES*LTC6804_GPIO_COUNT; i++) {
         gpioVoltages[i] = 0;
     }
-    gpioVoltages[0*LTC6804_GPIO_COUNT] = 399; // should be translated to  60  dC
+    gpioVoltages[0*LTC6804_GPIO_COUNT] = 399; // should be translated to  61  dC
     gpioVoltages[1*LTC6804_GPIO_COUNT] = 396; // should be translated to  60  dC 
     gpioVoltages[2*LTC6804_GPIO_COUNT] = 156; // should be translated to  0   dC
     gpioVoltages[3*LTC6804_GPIO_COUNT] = 100; // should be translated to -14 dC
-    gpioVoltages[4*LTC6804_GPIO_COUNT] = 2556; // should be translated to -600 dC
-    gpioVoltages[5*LTC6804_GPIO_COUNT] = 2557; // should be translated to -600 dC
+    gpioVoltages[4*LTC6804_GPIO_COUNT] = 2556; // should be translated to  600 dC
+    gpioVoltages[5*LTC6804_GPIO_COUNT] = 2557; // should be translated to  600 dC
 
     printf("...");
 }
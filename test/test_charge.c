@@ -3,6 +3,7 @@
 #include <stdio.h>
 #include "state_types.h"
 #include "charge.h"
+#include "bms_utils.h"
 
 #define NUM_MODULES 2
 #define TOTAL_CELLS NUM_MODULES*2
@@ -24,7 +25,7 @@ PACK_CONFIG_T config;
 uint8_t mod_cell_count[NUM_MODULES] = {2, 2};
 uint32_t cell_voltages_mV[TOTAL_CELLS] = {3400, 3401, 3402, 3403};
 BMS_CHARGE_REQ_T _charge_req;
-bool balance_requests[NUM_MODULES];
+uint16_t balance_requests[NUM_MODULES];
 
 void Test_Charge_SM_Shutdown(void);
 
@@ -139,7 +140,7 @@ TEST(Charge_Test, to_cc) {
     TEST_ASSERT_TRUE(output.charge_req->charger_on);
     int i;
     for (i = 0; i < TOTAL_CELLS; i++) {
-        TEST_ASSERT_FALSE(output.balance_req[i]);
+        TEST_ASSERT_FALSE(Is_Cell_Balancing(output.balance_req, &config, i));
     }
 
     Charge_Step(&input, &state, &output);
@@ -149,7 +150,7 @@ TEST(Charge_Test, to_cc) {
     TEST_ASSERT_TRUE(output.charge_req->charger_on);
     TEST_ASSERT_TRUE(output.close_contactors);
     for (i = 0; i < TOTAL_CELLS; i++) {
-        TEST_ASSERT_FALSE(output.balance_req[i]);
+        TEST_ASSERT_FALSE(Is_Cell_Balancing(output.balance_req, &config, i));
     }
 
 
@@ -173,7 +174,7 @@ TEST(Charge_Test, to_cc_w_bal) {
     TEST_ASSERT_FALSE(output.charge_req->charger_on);
     int i;
     for (i = 0; i < TOTAL_CELLS; i++) {
-        TEST_ASSERT_FALSE(output.balance_req[i]);
+        TEST_ASSERT_FALSE(Is_Cell_Balancing(output.balance_req, &config, i));
     }
 
     Charge_Step(&input, &state, &output);
@@ -183,9 +184,9 @@ TEST(Charge_Test, to_cc_w_bal) {
     TEST_ASSERT_TRUE(output.charge_req->charger_on);
     TEST_ASSERT_TRUE(output.close_contactors);
     for (i=0; i<TOTAL_CELLS-1; i++) {
-        TEST_ASSERT_FALSE(output.balance_req[i]);
+        TEST_ASSERT_FALSE(Is_Cell_Balancing(output.balance_req, &config, i));
     }
-    TEST_ASSERT_TRUE(output.balance_req[TOTAL_CELLS - 1]);
+    TEST_ASSERT_TRUE(Is_Cell_Balancing(output.balance_req, &config, TOTAL_CELLS - 1));
 
     Test_Charge_SM_Shutdown();
 }
@@ -208,7 +209,7 @@ TEST(Charge_Test, to_cc_w_bal_2) {
     TEST_ASSERT_FALSE(output.charge_req->charger_on);
     int i;
     for (i = 0; i < TOTAL_CELLS; i++) {
-            TEST_ASSERT_FALSE(output.balance_req[i]);
+            TEST_ASSERT_FALSE(Is_Cell_Balancing(output.balance_req, &config, i));
     }
 
     Charge_Step(&input, &state, &output);
@@ -218,9 +219,9 @@ TEST(Charge_Test, to_cc_w_bal_2) {
     TEST_ASSERT_TRUE(output.charge_req->charger_on);
     TEST_ASSERT_TRUE(output.close_contactors);
     for (i=0; i<TOTAL_CELLS-1; i++) {
-            TEST_ASSERT_FALSE(output.balance_req[i]);
+            TEST_ASSERT_FALSE(Is_Cell_Balancing(output.balance_req, &config, i));
     }
-    TEST_ASSERT_TRUE(output.balance_req[TOTAL_CELLS - 1]);  
+    TEST_ASSERT_TRUE(Is_Cell_Balancing(output.balance_req, &config, TOTAL_CELLS - 1));  
 
     input.pack_status->pack_cell_max_mV = 3401;
     cell_voltages_mV[TOTAL_CELLS - 1] = 3401;
@@ -231,7 +232,7 @@ TEST(Charge_Test, to_cc_w_bal_2) {
     TEST_ASSERT_TRUE(output.charge_req->charger_on);
     TEST_ASSERT_TRUE(output.close_contactors);
     for (i = 0; i < TOTAL_CELLS; i++) {
-        TEST_ASSERT_FALSE(output.balance_req[i]);
+        TEST_ASSERT_FALSE(Is_Cell_Balancing(output.balance_req, &config, i));
     }
 
     Test_Charge_SM_Shutdown();
@@ -254,7 +255,7 @@ TEST(Charge_Test, to_cv) {
     TEST_ASSERT_FALSE(output.charge_req->charger_on);
     int i;
     for (i = 0; i < TOTAL_CELLS; i++) {
-            TEST_ASSERT_FALSE(output.balance_req[i]);
+            TEST_ASSERT_FALSE(Is_Cell_Balancing(output.balance_req, &config, i));
     }
     
     Charge_Step(&input, &state, &output);   
@@ -284,7 +285,7 @@ TEST(Charge_Test, to_cv_w_bal) {
     TEST_ASSERT_FALSE(output.charge_req->charger_on);
     int i;
     for (i = 0; i < TOTAL_CELLS; i++) {
-            TEST_ASSERT_FALSE(output.balance_req[i]);
+            TEST_ASSERT_FALSE(Is_Cell_Balancing(output.balance_req, &config, i));
     }
 
     Charge_Step(&input, &state, &output);
@@ -294,8 +295,11 @@ TEST(Charge_Test, to_cv_w_bal) {
     TEST_ASSERT_TRUE(output.charge_req->charger_on);
     TEST_ASSERT_TRUE(output.close_contactors);
     for (i = 0; i < TOTAL_CELLS - 2; i++)
-        TEST_ASSERT_FALSE(output.balance_req[i]);
-    TEST_ASSERT_TRUE(output.balance_req[2]); TEST_ASSERT_TRUE(output.balance_req[3]);
+        TEST_ASSERT_FALSE(Is_Cell_Balancing(output.balance_req, &config, i));
+    TEST_ASSERT_TRUE(Is_Cell_Balancing(output.balance_req, &config, 2)); TEST_ASSERT_TRUE(Is_Cell_Balancing(output.balance_req, &config, 3));
+    // both cells of the second module, nothing in the first
+    TEST_ASSERT_EQUAL(0x0, output.balance_req[0]);
+    TEST_ASSERT_EQUAL(0x3, output.balance_req[1]);
     TEST_ASSERT_TRUE(output.charge_req->charger_on);
 
     Test_Charge_SM_Shutdown();
@@ -319,7 +323,7 @@ TEST(Charge_Test, to_cc_to_cv) {
     TEST_ASSERT_FALSE(output.charge_req->charger_on);
     int i;
     for (i = 0; i < TOTAL_CELLS; i++) {
-            TEST_ASSERT_FALSE(output.balance_req[i]);
+            TEST_ASSERT_FALSE(Is_Cell_Balancing(output.balance_req, &config, i));
     }
 
     Charge_Step(&input, &state, &output);
@@ -329,7 +333,7 @@ TEST(Charge_Test, to_cc_to_cv) {
     TEST_ASSERT_TRUE(output.charge_req->charger_on);
     TEST_ASSERT_TRUE(output.close_contactors);
     for (i = 0; i < TOTAL_CELLS; i++) {
-        TEST_ASSERT_FALSE(output.balance_req[i]);
+        TEST_ASSERT_FALSE(Is_Cell_Balancing(output.balance_req, &config, i));
     }
 
     input.mode_request = BMS_SSM_MODE_CHARGE;
@@ -344,7 +348,7 @@ TEST(Charge_Test, to_cc_to_cv) {
     TEST_ASSERT_TRUE(output.charge_req->charger_on);
     TEST_ASSERT_TRUE(output.close_contactors);
     for (i = 0; i < TOTAL_CELLS; i++)
-        TEST_ASSERT_FALSE(output.balance_req[i]);
+        TEST_ASSERT_FALSE(Is_Cell_Balancing(output.balance_req, &config, i));
     
     Test_Charge_SM_Shutdown();
 }
@@ -376,7 +380,7 @@ TEST(Charge_Test, to_bal) {
     TEST_ASSERT_FALSE(output.charge_req->charger_on);
     int i;
     for (i = 0; i < TOTAL_CELLS; i++)
-        TEST_ASSERT_TRUE(output.balance_req[i]);
+        TEST_ASSERT_TRUE(Is_Cell_Balancing(output.balance_req, &config, i));
 
     input.contactors_closed = true;
     Test_Charge_SM_Shutdown();
@@ -399,7 +403,7 @@ TEST(Charge_Test, to_cv_finish) {
     TEST_ASSERT_FALSE(output.charge_req->charger_on);
     int i;
     for (i = 0; i < TOTAL_CELLS; i++) {
-            TEST_ASSERT_FALSE(output.balance_req[i]);
+            TEST_ASSERT_FALSE(Is_Cell_Balancing(output.balance_req, &config, i));
     }
     
     Charge_Step(&input, &state, &output);   
@@ -460,7 +464,7 @@ TEST(Charge_Test, test_standby_mode_request_from_charge_init) {
         TEST_ASSERT_TRUE(output.close_contactors);
         TEST_ASSERT_FALSE(output.charge_req->charger_on);
         uint32_t i;
-        for (i=0; i<(sizeof(output.balance_req[0])*TOTAL_CELLS); i++) {
+        for (i=0; i<NUM_MODULES; i++) {
                 TEST_ASSERT_EQUAL(0, output.balance_req[i]);
         }
 
@@ -469,7 +473,7 @@ TEST(Charge_Test, test_standby_mode_request_from_charge_init) {
 //      TEST_ASSERT_EQUAL(BMS_CHARGE_DONE, state.charge_state);
 //      TEST_ASSERT_FALSE(output.close_contactors);
 //      TEST_ASSERT_FALSE(output.charge_req->charger_on);
-//      for (i=0; i<(sizeof(output.balance_req[0])*TOTAL_CELLS); i++) {
+//      for (i=0; i<NUM_MODULES; i++) {
 //                TEST_ASSERT_EQUAL(0, output.balance_req[i]);
 //        }
 
@@ -481,7 +485,7 @@ TEST(Charge_Test, test_standby_mode_request_from_charge_init) {
         TEST_ASSERT_EQUAL(BMS_CHARGE_DONE, state.charge_state);
         TEST_ASSERT_FALSE(output.close_contactors);
         TEST_ASSERT_FALSE(output.charge_req->charger_on);
-        for (i=0; i<(sizeof(output.balance_req[0])*TOTAL_CELLS); i++) {
+        for (i=0; i<NUM_MODULES; i++) {
                 TEST_ASSERT_EQUAL(0, output.balance_req[i]);
         }
 
@@ -492,7 +496,7 @@ TEST(Charge_Test, test_standby_mode_request_from_charge_init) {
         // TEST_ASSERT_EQUAL(BMS_CHARGE_OFF, state.charge_state);
         // TEST_ASSERT_FALSE(output.close_contactors);
         // TEST_ASSERT_FALSE(output.charge_req->charger_on);
-        // for (i=0; i<(sizeof(output.balance_req[0])*TOTAL_CELLS); i++) {
+        // for (i=0; i<NUM_MODULES; i++) {
         //         TEST_ASSERT_EQUAL(0, output.balance_req[i]);
         // }
 
@@ -529,7 +533,7 @@ void Test_Charge_SM_Shutdown(void) {
     TEST_ASSERT_EQUAL(BMS_CHARGE_DONE, state.charge_state);
     TEST_ASSERT_FALSE(output.close_contactors);
     for (i = 0; i < TOTAL_CELLS; i++)
-        TEST_ASSERT_FALSE(output.balance_req[i]);
+        TEST_ASSERT_FALSE(Is_Cell_Balancing(output.balance_req, &config, i));
     TEST_ASSERT_FALSE(output.charge_req->charger_on);
 
     input.contactors_closed = false;
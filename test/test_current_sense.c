@@ -0,0 +1,158 @@
+#include "unity.h"
+#include "unity_fixture.h"
+#include <stdio.h>
+#include "current_sense.h"
+
+/**
+ * Testing Strategy
+ *
+ * CurrentSense_Read()
+ * - no reading yet, reading picked up once
+ * - nominal offset: zero, discharge, charge
+ * - noisy samples averaged over a reading, resolution below one count
+ * - synthetic load profile: idle, ramp, hold, release
+ * Calibration
+ * - offset measured at rest, rest interrupted, offset out of range
+ */
+
+#define ZERO CURRENT_SENSE_ZERO_COUNTS
+// current for an offset from zero, in counts
+#define mA(counts) ((int32_t)((int64_t)(counts) * CURRENT_SENSE_uA_PER_COUNT / 1000))
+
+static uint32_t now_ms;
+
+// one reading of samples at counts, with +-noise alternating
+static void feed(uint16_t counts, uint16_t noise) {
+    uint8_t i;
+    for (i = 0; i < CURRENT_SENSE_OVERSAMPLE; i++) {
+        CurrentSense_AddSample((i & 1) ? counts + noise : counts - noise, now_ms);
+        now_ms++;
+    }
+}
+
+// INT32_MIN if there was no reading
+static int32_t read_at(uint16_t counts, bool at_rest) {
+    int32_t current_mA;
+    uint32_t sample_ms;
+    feed(counts, 0);
+    if (!CurrentSense_Read(at_rest, &current_mA, &sample_ms)) {
+        return INT32_MIN;
+    }
+    return current_mA;
+}
+
+TEST_GROUP(Current_Sense_Test);
+
+TEST_SETUP(Current_Sense_Test) {
+    printf("\r(Current_Sense_Test)Setup");
+    now_ms = 1000;
+    CurrentSense_Init();
+    printf("...");
+}
+
+TEST_TEAR_DOWN(Current_Sense_Test) {
+    printf("...");
+    printf("Teardown\r\n");
+}
+
+TEST(Current_Sense_Test, reading) {
+    printf("reading");
+    int32_t current_mA;
+    uint32_t sample_ms;
+    TEST_ASSERT_FALSE(CurrentSense_Read(false, &current_mA, &sample_ms));
+
+    feed(ZERO, 0);
+    TEST_ASSERT_TRUE(CurrentSense_Read(false, &current_mA, &sample_ms));
+    TEST_ASSERT_EQUAL(0, current_mA);
+    TEST_ASSERT_EQUAL(now_ms - 1, sample_ms);
+    TEST_ASSERT_FALSE(CurrentSense_Read(false, &current_mA, &sample_ms));
+    TEST_ASSERT_FALSE(CurrentSense_IsCalibrated());
+}
+
+TEST(Current_Sense_Test, nominal) {
+    printf("nominal");
+    TEST_ASSERT_INT_WITHIN(1, mA(100), read_at(ZERO + 100, false));
+    TEST_ASSERT_INT_WITHIN(1, mA(-100), read_at(ZERO - 100, false));
+}
+
+TEST(Current_Sense_Test, oversampling) {
+    printf("oversampling");
+    int32_t current_mA;
+    uint32_t sample_ms;
+
+    // noise averages out
+    feed(ZERO + 10, 3);
+    CurrentSense_Read(false, &current_mA, &sample_ms);
+    TEST_ASSERT_INT_WITHIN(1, mA(10), current_mA);
+
+    // every other sample one count up reads as half a count
+    feed(ZERO, 0);
+    uint8_t i;
+    for (i = 0; i < CURRENT_SENSE_OVERSAMPLE; i++) {
+        CurrentSense_AddSample(ZERO + (i & 1), now_ms++);
+    }
+    CurrentSense_Read(false, &current_mA, &sample_ms);
+    TEST_ASSERT_INT_WITHIN(1, CURRENT_SENSE_uA_PER_COUNT / 2000, current_mA);
+}
+
+TEST(Current_Sense_Test, profile) {
+    printf("profile");
+    int32_t current_mA;
+    uint32_t sample_ms;
+    // idle, ramp up 20 counts per reading, hold, release
+    uint16_t profile[] = {0, 0, 20, 40, 60, 80, 100, 100, 100, 0, 0};
+    uint8_t i;
+    for (i = 0; i < sizeof(profile)/sizeof(profile[0]); i++) {
+        feed(ZERO + profile[i], 2);
+        TEST_ASSERT_TRUE(CurrentSense_Read(false, &current_mA, &sample_ms));
+        TEST_ASSERT_INT_WITHIN(1, mA(profile[i]), current_mA);
+    }
+}
+
+TEST(Current_Sense_Test, calibrate) {
+    printf("calibrate");
+    uint8_t i;
+    // sensor zero drifted 8 counts up
+    for (i = 0; i < CURRENT_SENSE_CAL_READINGS - 1; i++) {
+        read_at(ZERO + 8, true);
+    }
+    TEST_ASSERT_FALSE(CurrentSense_IsCalibrated());
+    read_at(ZERO + 8, true);
+    TEST_ASSERT_TRUE(CurrentSense_IsCalibrated());
+    TEST_ASSERT_EQUAL((ZERO + 8) * CURRENT_SENSE_OVERSAMPLE, CurrentSense_GetOffset());
+    TEST_ASSERT_EQUAL(0, read_at(ZERO + 8, false));
+    TEST_ASSERT_INT_WITHIN(1, mA(100), read_at(ZERO + 108, false));
+}
+
+TEST(Current_Sense_Test, calibrate_interrupted) {
+    printf("calibrate_interrupted");
+    uint8_t i;
+    for (i = 0; i < CURRENT_SENSE_CAL_READINGS - 1; i++) {
+        read_at(ZERO + 8, true);
+    }
+    // contactors closed, start over
+    read_at(ZERO + 50, false);
+    read_at(ZERO + 8, true);
+    TEST_ASSERT_FALSE(CurrentSense_IsCalibrated());
+    TEST_ASSERT_EQUAL(ZERO * CURRENT_SENSE_OVERSAMPLE, CurrentSense_GetOffset());
+}
+
+TEST(Current_Sense_Test, calibrate_out_of_range) {
+    printf("calibrate_out_of_range");
+    uint8_t i;
+    for (i = 0; i < CURRENT_SENSE_CAL_READINGS; i++) {
+        read_at(ZERO + CURRENT_SENSE_MAX_OFFSET_COUNTS + 1, true);
+    }
+    TEST_ASSERT_FALSE(CurrentSense_IsCalibrated());
+    TEST_ASSERT_EQUAL(ZERO * CURRENT_SENSE_OVERSAMPLE, CurrentSense_GetOffset());
+}
+
+TEST_GROUP_RUNNER(Current_Sense_Test) {
+    RUN_TEST_CASE(Current_Sense_Test, reading);
+    RUN_TEST_CASE(Current_Sense_Test, nominal);
+    RUN_TEST_CASE(Current_Sense_Test, oversampling);
+    RUN_TEST_CASE(Current_Sense_Test, profile);
+    RUN_TEST_CASE(Current_Sense_Test, calibrate);
+    RUN_TEST_CASE(Current_Sense_Test, calibrate_interrupted);
+    RUN_TEST_CASE(Current_Sense_Test, calibrate_out_of_range);
+}
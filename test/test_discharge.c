@@ -9,7 +9,7 @@
 #define MAX_CELLS_PER_MODULE 12
 
 // memory allocation for BMS_OUTPUT_T
-bool balance_reqs[MAX_NUM_MODULES*MAX_CELLS_PER_MODULE];
+uint16_t balance_reqs[MAX_NUM_MODULES];
 BMS_CHARGE_REQ_T charge_req;
 BMS_OUTPUT_T bms_output;
 
@@ -84,6 +84,15 @@ TEST(Discharge_Test, calculate_max_current) {
     TEST_ASSERT_EQUAL(result, 36);
 }
 
+TEST(Discharge_Test, calculate_allowed_current) {
+    printf("calculate_allowed_current...");
+    TEST_ASSERT_EQUAL(100000, Calculate_Allowed_Current(100000, 0));
+    TEST_ASSERT_EQUAL(100000, Calculate_Allowed_Current(100000, CELL_SAG_TAPER_mV_s));
+    TEST_ASSERT_EQUAL(50000, Calculate_Allowed_Current(100000, 2*CELL_SAG_TAPER_mV_s));
+    TEST_ASSERT_EQUAL(100000/100*CELL_SAG_TAPER_FLOOR_pct,
+            Calculate_Allowed_Current(100000, 100*CELL_SAG_TAPER_mV_s));
+}
+
 void Set_PackConfig(
         uint8_t cell_capacity_cAh, uint8_t cell_discharge_c_rating_cC,
         uint8_t pack_cells_p, uint8_t max_cell_temp_dC,
@@ -148,6 +157,30 @@ TEST(Discharge_Test, discharge_step_to_run) {
     TEST_ASSERT_EQUAL(bms_state.discharge_state, BMS_DISCHARGE_RUN);
 }
 
+TEST(Discharge_Test, current_limit_frame) {
+    printf("current_limit_frame...");
+    Discharge_Step(&bms_input, &bms_state, &bms_output);
+    bms_input.contactors_closed = true;
+    bms_input.pack_status->pack_current_mA = 10;
+    bms_input.pack_status->max_cell_temp_dC = 1;
+    bms_input.pack_status->max_cell_sag_mV_s = 5*CELL_SAG_TAPER_mV_s/4;
+    bms_input.pack_status->cell_ir_limit_mA = 1000;
+    Discharge_Step(&bms_input, &bms_state, &bms_output);
+    TEST_ASSERT_EQUAL(BMS_DISCHARGE_RUN, bms_state.discharge_state);
+
+    // the sag taper lowers the limit, which is what goes to the load
+    uint8_t data[8];
+    TEST_ASSERT_EQUAL(8, Discharge_PackCanFrame(data));
+    TEST_ASSERT_EQUAL(80, data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24));
+    TEST_ASSERT_EQUAL(100, data[4] | (data[5] << 8) | (data[6] << 16) | (data[7] << 24));
+
+    // then the weakest cell's resistance
+    bms_input.pack_status->cell_ir_limit_mA = 40;
+    Discharge_Step(&bms_input, &bms_state, &bms_output);
+    Discharge_PackCanFrame(data);
+    TEST_ASSERT_EQUAL(40, data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24));
+}
+
 TEST(Discharge_Test, discharge_step_undervoltage_error) {
     printf("discharge_step_undervoltage_error...");
     // from test init, input request is already in discharge
@@ -183,10 +216,12 @@ TEST(Discharge_Test, discharge_step_overcurrent_error) {
 
 TEST_GROUP_RUNNER(Discharge_Test) {
     RUN_TEST_CASE(Discharge_Test, calculate_max_current);
+    RUN_TEST_CASE(Discharge_Test, calculate_allowed_current);
     RUN_TEST_CASE(Discharge_Test, config);
     RUN_TEST_CASE(Discharge_Test, discharge_step_invalid_mode_req);
     RUN_TEST_CASE(Discharge_Test, discharge_step_to_standby);
     RUN_TEST_CASE(Discharge_Test, discharge_step_to_run);
+    RUN_TEST_CASE(Discharge_Test, current_limit_frame);
     // RUN_TEST_CASE(Discharge_Test, discharge_step_undervoltage_error);
     // RUN_TEST_CASE(Discharge_Test, discharge_step_overcurrent_error);
 }
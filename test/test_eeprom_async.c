@@ -0,0 +1,254 @@
+#include "unity.h"
+#include "unity_fixture.h"
+#include <stdio.h>
+#include <string.h>
+#include "lc1024.h"
+#include "eeprom_async.h"
+
+/**
+ * Testing Strategy
+ *
+ * EEPROM_Async_Write()
+ * - write spanning two blocks
+ * - writes to the same block merge, writes to different blocks do not
+ * - write does not merge past a queued read
+ * - write does not merge past an overlapping write with another callback
+ * - full queue
+ * EEPROM_Async_Service()
+ * - waits for the write in progress bit before the next request
+ * - write timeout
+ * - callbacks after the last block
+ */
+
+// fake LC1024: memory, write in progress for a number of status reads
+#define FAKE_MEM_SIZE 512
+
+static uint8_t fake_mem[FAKE_MEM_SIZE];
+static uint8_t fake_busy_polls;
+static uint8_t fake_busy_polls_per_write;
+static uint8_t fake_writes;
+static uint8_t fake_write_enabled;
+
+static uint32_t fake_address(uint8_t *address) {
+    return ((uint32_t)address[0] << 16) | ((uint32_t)address[1] << 8) | address[2];
+}
+
+void LC1024_Init(LPC_SSP_T *pSSP, uint32_t baud, uint8_t cs_gpio, uint8_t cs_pin) {
+    (void)pSSP; (void)baud; (void)cs_gpio; (void)cs_pin;
+}
+
+void LC1024_WriteEnable(void) {
+    fake_write_enabled = 1;
+}
+
+void LC1024_ReadStatusReg(uint8_t *status) {
+    if (fake_busy_polls > 0) {
+        fake_busy_polls--;
+        *status = 0x01;
+    } else {
+        *status = 0x00;
+    }
+}
+
+void LC1024_WriteMem(uint8_t *address, uint8_t *data, uint8_t length) {
+    TEST_ASSERT_TRUE(fake_write_enabled);
+    TEST_ASSERT_EQUAL(0, fake_busy_polls);
+    memcpy(&fake_mem[fake_address(address)], data, length);
+    fake_write_enabled = 0;
+    fake_busy_polls = fake_busy_polls_per_write;
+    fake_writes++;
+}
+
+void LC1024_ReadMem(uint8_t *address, uint8_t *data, uint8_t length) {
+    TEST_ASSERT_EQUAL(0, fake_busy_polls);
+    memcpy(data, &fake_mem[fake_address(address)], length);
+}
+
+static uint8_t callbacks;
+static bool callback_success;
+
+static void count_callback(bool success) {
+    callbacks++;
+    callback_success = success;
+}
+
+static void service_until_idle(uint32_t start_ms) {
+    uint32_t now = start_ms;
+    while (!EEPROM_Async_Idle() && now < start_ms + 1000) {
+        EEPROM_Async_Service(now++);
+    }
+}
+
+TEST_GROUP(EEPROM_Async_Test);
+
+TEST_SETUP(EEPROM_Async_Test) {
+    printf("\r(EEPROM_Async_Test)Setup");
+    memset(fake_mem, 0xFF, sizeof(fake_mem));
+    fake_busy_polls = 0;
+    fake_busy_polls_per_write = 3;
+    fake_writes = 0;
+    fake_write_enabled = 0;
+    callbacks = 0;
+    callback_success = false;
+    EEPROM_Async_Init();
+    printf("...");
+}
+
+TEST_TEAR_DOWN(EEPROM_Async_Test) {
+    printf("...");
+    printf("Teardown\r\n");
+}
+
+TEST(EEPROM_Async_Test, write_read) {
+    printf("write_read");
+    uint8_t data[80];
+    uint8_t i;
+    for (i = 0; i < sizeof(data); i++) {
+        data[i] = i;
+    }
+
+    // 0x30..0x7F spans blocks 0x00 and 0x40
+    TEST_ASSERT_TRUE(EEPROM_Async_Write(0x30, data, sizeof(data), count_callback));
+    TEST_ASSERT_EQUAL(2, EEPROM_Async_QueueLength());
+    memset(data, 0, sizeof(data));
+
+    uint8_t readback[80];
+    TEST_ASSERT_TRUE(EEPROM_Async_Read(0x30, readback, sizeof(readback), NULL));
+
+    // first block is sent, nothing else happens while the LC1024 is busy
+    EEPROM_Async_Service(0);
+    TEST_ASSERT_EQUAL(1, fake_writes);
+    EEPROM_Async_Service(1);
+    EEPROM_Async_Service(2);
+    TEST_ASSERT_EQUAL(1, fake_writes);
+    TEST_ASSERT_EQUAL(0, callbacks);
+
+    service_until_idle(3);
+    TEST_ASSERT_EQUAL(2, fake_writes);
+    TEST_ASSERT_EQUAL(1, callbacks);
+    TEST_ASSERT_TRUE(callback_success);
+    for (i = 0; i < sizeof(readback); i++) {
+        TEST_ASSERT_EQUAL(i, readback[i]);
+    }
+    TEST_ASSERT_EQUAL(0xFF, fake_mem[0x2F]);
+    TEST_ASSERT_EQUAL(0xFF, fake_mem[0x80]);
+}
+
+TEST(EEPROM_Async_Test, coalesce) {
+    printf("coalesce");
+    uint8_t idx;
+    for (idx = 0; idx < 16; idx++) {
+        uint8_t val[4] = {idx, idx, idx, idx};
+        TEST_ASSERT_TRUE(EEPROM_Async_Write(0x100 + 4*idx, val, 4, NULL));
+    }
+    // rewrite the first entry, still the same request
+    uint8_t val[4] = {0xAA, 0xAA, 0xAA, 0xAA};
+    TEST_ASSERT_TRUE(EEPROM_Async_Write(0x100, val, 4, NULL));
+    TEST_ASSERT_EQUAL(1, EEPROM_Async_QueueLength());
+
+    // a different block needs its own request
+    TEST_ASSERT_TRUE(EEPROM_Async_Write(0x140, val, 4, NULL));
+    TEST_ASSERT_EQUAL(2, EEPROM_Async_QueueLength());
+    service_until_idle(0);
+    TEST_ASSERT_EQUAL(2, fake_writes);
+
+    // and so does a gap in the same block
+    TEST_ASSERT_TRUE(EEPROM_Async_Write(0x0, val, 1, NULL));
+    TEST_ASSERT_TRUE(EEPROM_Async_Write(0x2, val, 1, NULL));
+    TEST_ASSERT_EQUAL(2, EEPROM_Async_QueueLength());
+
+    service_until_idle(1000);
+    TEST_ASSERT_EQUAL(4, fake_writes);
+    TEST_ASSERT_EQUAL(0xAA, fake_mem[0x100]);
+    TEST_ASSERT_EQUAL(15, fake_mem[0x13F]);
+    TEST_ASSERT_EQUAL(0xAA, fake_mem[0x0]);
+    TEST_ASSERT_EQUAL(0xFF, fake_mem[0x1]);
+    TEST_ASSERT_EQUAL(0xAA, fake_mem[0x2]);
+}
+
+TEST(EEPROM_Async_Test, no_merge_into_started) {
+    printf("no_merge_into_started");
+    uint8_t val[4] = {1, 2, 3, 4};
+    TEST_ASSERT_TRUE(EEPROM_Async_Write(0x100, val, 4, NULL));
+    EEPROM_Async_Service(0);
+
+    val[0] = 9;
+    TEST_ASSERT_TRUE(EEPROM_Async_Write(0x100, val, 4, NULL));
+    TEST_ASSERT_EQUAL(2, EEPROM_Async_QueueLength());
+    service_until_idle(1);
+    TEST_ASSERT_EQUAL(2, fake_writes);
+    TEST_ASSERT_EQUAL(9, fake_mem[0x100]);
+}
+
+TEST(EEPROM_Async_Test, no_merge_past_callback) {
+    printf("no_merge_past_callback");
+    uint8_t old_val[4] = {1, 1, 1, 1};
+    uint8_t new_val[10] = {2, 2, 2, 2, 2, 2, 2, 2, 2, 2};
+    TEST_ASSERT_TRUE(EEPROM_Async_Write(0x100, old_val, 4, NULL));
+    TEST_ASSERT_TRUE(EEPROM_Async_Write(0x10A, old_val, 4, count_callback));
+
+    // overlaps the second write, whose callback differs, so it cannot go
+    // into the first one either
+    TEST_ASSERT_TRUE(EEPROM_Async_Write(0x102, new_val, 10, NULL));
+    TEST_ASSERT_EQUAL(3, EEPROM_Async_QueueLength());
+
+    service_until_idle(0);
+    TEST_ASSERT_EQUAL(1, callbacks);
+    TEST_ASSERT_EQUAL(1, fake_mem[0x101]);
+    TEST_ASSERT_EQUAL(2, fake_mem[0x102]);
+    TEST_ASSERT_EQUAL(2, fake_mem[0x10B]);
+    TEST_ASSERT_EQUAL(1, fake_mem[0x10C]);
+}
+
+TEST(EEPROM_Async_Test, read_order) {
+    printf("read_order");
+    uint8_t val = 1;
+    uint8_t readback = 0;
+    TEST_ASSERT_TRUE(EEPROM_Async_Write(0x10, &val, 1, NULL));
+    TEST_ASSERT_TRUE(EEPROM_Async_Read(0x10, &readback, 1, NULL));
+    val = 2;
+    TEST_ASSERT_TRUE(EEPROM_Async_Write(0x10, &val, 1, NULL));
+    TEST_ASSERT_EQUAL(3, EEPROM_Async_QueueLength());
+
+    service_until_idle(0);
+    TEST_ASSERT_EQUAL(1, readback);
+    TEST_ASSERT_EQUAL(2, fake_mem[0x10]);
+}
+
+TEST(EEPROM_Async_Test, full) {
+    printf("full");
+    uint8_t data[EEPROM_ASYNC_BLOCK_SIZE*EEPROM_ASYNC_QUEUE_LEN];
+    memset(data, 0x55, sizeof(data));
+    TEST_ASSERT_TRUE(EEPROM_Async_Write(0, data, sizeof(data) - EEPROM_ASYNC_BLOCK_SIZE, NULL));
+
+    // two more blocks do not fit, nothing is queued
+    TEST_ASSERT_FALSE(EEPROM_Async_Write(0x100, data, EEPROM_ASYNC_BLOCK_SIZE + 1, NULL));
+    TEST_ASSERT_EQUAL(EEPROM_ASYNC_QUEUE_LEN - 1, EEPROM_Async_QueueLength());
+    TEST_ASSERT_TRUE(EEPROM_Async_Write(0x100, data, EEPROM_ASYNC_BLOCK_SIZE, NULL));
+    TEST_ASSERT_FALSE(EEPROM_Async_Read(0, data, 1, NULL));
+}
+
+TEST(EEPROM_Async_Test, timeout) {
+    printf("timeout");
+    fake_busy_polls_per_write = 255;
+    uint8_t val = 1;
+    TEST_ASSERT_TRUE(EEPROM_Async_Write(0, &val, 1, count_callback));
+
+    EEPROM_Async_Service(0);
+    EEPROM_Async_Service(EEPROM_ASYNC_WRITE_TIMEOUT_ms);
+    TEST_ASSERT_EQUAL(0, callbacks);
+    EEPROM_Async_Service(EEPROM_ASYNC_WRITE_TIMEOUT_ms + 1);
+    TEST_ASSERT_EQUAL(1, callbacks);
+    TEST_ASSERT_FALSE(callback_success);
+    TEST_ASSERT_TRUE(EEPROM_Async_Idle());
+}
+
+TEST_GROUP_RUNNER(EEPROM_Async_Test) {
+    RUN_TEST_CASE(EEPROM_Async_Test, write_read);
+    RUN_TEST_CASE(EEPROM_Async_Test, coalesce);
+    RUN_TEST_CASE(EEPROM_Async_Test, no_merge_into_started);
+    RUN_TEST_CASE(EEPROM_Async_Test, no_merge_past_callback);
+    RUN_TEST_CASE(EEPROM_Async_Test, read_order);
+    RUN_TEST_CASE(EEPROM_Async_Test, full);
+    RUN_TEST_CASE(EEPROM_Async_Test, timeout);
+}
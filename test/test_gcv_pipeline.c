@@ -0,0 +1,261 @@
+#include "unity.h"
+#include "unity_fixture.h"
+#include <stdio.h>
+#include "gcv_pipeline.h"
+
+/**
+ * Testing Strategy
+ *
+ * GcvPipeline_Step(0)
+ * - one-shot: convert, readback, clear, publish, then idle
+ * - pipelined: next conversion starts before publish, no idle call
+ * - clear still waiting: publish held back
+ * - convert error: restarts from idle, nothing published
+ * - clear error: results published, no conversion started
+ * GcvPipeline_RequestOpenWire()
+ * - pipelined: test takes the slot of the next conversion, converting
+ *   resumes in the step it finishes
+ * - one-shot: test runs before the next conversion
+ * - failed test ends the slot, request dropped by init
+ * GcvPipeline_GetSampleTime()
+ * - one-shot and pipelined: start of the conversion read back
+ */
+
+#define FAKE_LOG_LEN 32
+
+// driver calls in order: c = convert, x = clear, p = publish, o = open wire
+static char op_log[FAKE_LOG_LEN + 1];
+static uint8_t op_log_len;
+
+// scripted driver responses, consumed one per call
+static GCV_OP_STATUS_T convert_script[FAKE_LOG_LEN];
+static uint8_t convert_pos;
+static GCV_OP_STATUS_T clear_script[FAKE_LOG_LEN];
+static uint8_t clear_pos;
+static GCV_OP_STATUS_T open_wire_script[FAKE_LOG_LEN];
+static uint8_t open_wire_pos;
+static uint32_t published_ms;
+
+static void log_op(char op) {
+    op_log[op_log_len++] = op;
+    op_log[op_log_len] = '\0';
+}
+
+static GCV_OP_STATUS_T fake_convert(void) {
+    log_op('c');
+    return convert_script[convert_pos++];
+}
+
+static GCV_OP_STATUS_T fake_clear(void) {
+    log_op('x');
+    return clear_script[clear_pos++];
+}
+
+static void fake_publish(void) {
+    log_op('p');
+    published_ms = GcvPipeline_GetSampleTime();
+}
+
+static GCV_OP_STATUS_T fake_open_wire(void) {
+    log_op('o');
+    return open_wire_script[open_wire_pos++];
+}
+
+static const GCV_PIPELINE_OPS_T fake_ops = {fake_convert, fake_clear, fake_publish,
+        fake_open_wire};
+
+static void script(GCV_OP_STATUS_T *dst, const char *steps) {
+    uint8_t i;
+    for (i = 0; steps[i] != '\0'; i++) {
+        dst[i] = (steps[i] == 'w') ? GCV_OP_WAITING :
+                 (steps[i] == 'p') ? GCV_OP_PASS : GCV_OP_ERROR;
+    }
+}
+
+TEST_GROUP(Gcv_Pipeline_Test);
+
+TEST_SETUP(Gcv_Pipeline_Test) {
+    printf("\r(Gcv_Pipeline_Test)Setup");
+    op_log[0] = '\0';
+    op_log_len = 0;
+    convert_pos = 0;
+    clear_pos = 0;
+    open_wire_pos = 0;
+    printf("...");
+}
+
+TEST_TEAR_DOWN(Gcv_Pipeline_Test) {
+    printf("...");
+    printf("Teardown\r\n");
+}
+
+TEST(Gcv_Pipeline_Test, one_shot) {
+    printf("one_shot");
+    GcvPipeline_Init(&fake_ops, false);
+    script(convert_script, "wwpwp");
+    script(clear_script, "pp");
+
+    TEST_ASSERT_EQUAL(GCV_STATE_IDLE, GcvPipeline_GetState());
+    TEST_ASSERT_FALSE(GcvPipeline_Step(0));
+    TEST_ASSERT_EQUAL(GCV_STATE_CONVERTING, GcvPipeline_GetState());
+    TEST_ASSERT_FALSE(GcvPipeline_Step(0));
+    TEST_ASSERT_TRUE(GcvPipeline_Step(0));
+    TEST_ASSERT_EQUAL(GCV_STATE_IDLE, GcvPipeline_GetState());
+    TEST_ASSERT_EQUAL_STRING("cccxp", op_log);
+
+    // next sweep starts from scratch
+    TEST_ASSERT_FALSE(GcvPipeline_Step(0));
+    TEST_ASSERT_TRUE(GcvPipeline_Step(0));
+    TEST_ASSERT_EQUAL_STRING("cccxpccxp", op_log);
+}
+
+TEST(Gcv_Pipeline_Test, pipelined) {
+    printf("pipelined");
+    GcvPipeline_Init(&fake_ops, true);
+    script(convert_script, "wpwwpw");
+    script(clear_script, "pp");
+
+    TEST_ASSERT_FALSE(GcvPipeline_Step(0));
+    TEST_ASSERT_TRUE(GcvPipeline_Step(0));
+    // readback, clear, next conversion running before the publish
+    TEST_ASSERT_EQUAL_STRING("ccxcp", op_log);
+    TEST_ASSERT_EQUAL(GCV_STATE_CONVERTING, GcvPipeline_GetState());
+
+    TEST_ASSERT_FALSE(GcvPipeline_Step(0));
+    TEST_ASSERT_TRUE(GcvPipeline_Step(0));
+    TEST_ASSERT_EQUAL_STRING("ccxcpccxcp", op_log);
+    TEST_ASSERT_EQUAL(GCV_STATE_CONVERTING, GcvPipeline_GetState());
+}
+
+TEST(Gcv_Pipeline_Test, clear_waiting) {
+    printf("clear_waiting");
+    GcvPipeline_Init(&fake_ops, true);
+    script(convert_script, "wpw");
+    script(clear_script, "wwp");
+
+    TEST_ASSERT_FALSE(GcvPipeline_Step(0));
+    TEST_ASSERT_FALSE(GcvPipeline_Step(0));
+    TEST_ASSERT_EQUAL(GCV_STATE_CLEARING, GcvPipeline_GetState());
+    TEST_ASSERT_FALSE(GcvPipeline_Step(0));
+    TEST_ASSERT_TRUE(GcvPipeline_Step(0));
+    TEST_ASSERT_EQUAL_STRING("ccxxxcp", op_log);
+}
+
+TEST(Gcv_Pipeline_Test, convert_error) {
+    printf("convert_error");
+    GcvPipeline_Init(&fake_ops, true);
+    script(convert_script, "wewpw");
+    script(clear_script, "p");
+
+    TEST_ASSERT_FALSE(GcvPipeline_Step(0));
+    TEST_ASSERT_FALSE(GcvPipeline_Step(0));
+    TEST_ASSERT_EQUAL(GCV_STATE_IDLE, GcvPipeline_GetState());
+    TEST_ASSERT_FALSE(GcvPipeline_Step(0));
+    TEST_ASSERT_TRUE(GcvPipeline_Step(0));
+    TEST_ASSERT_EQUAL_STRING("ccccxcp", op_log);
+}
+
+TEST(Gcv_Pipeline_Test, clear_error) {
+    printf("clear_error");
+    GcvPipeline_Init(&fake_ops, true);
+    script(convert_script, "wpw");
+    script(clear_script, "e");
+
+    TEST_ASSERT_FALSE(GcvPipeline_Step(0));
+    TEST_ASSERT_TRUE(GcvPipeline_Step(0));
+    TEST_ASSERT_EQUAL_STRING("ccxp", op_log);
+    TEST_ASSERT_EQUAL(GCV_STATE_IDLE, GcvPipeline_GetState());
+}
+
+TEST(Gcv_Pipeline_Test, sample_time) {
+    printf("sample_time");
+    GcvPipeline_Init(&fake_ops, false);
+    script(convert_script, "wpwwp");
+    script(clear_script, "pp");
+
+    GcvPipeline_Step(10);
+    TEST_ASSERT_TRUE(GcvPipeline_Step(25));
+    TEST_ASSERT_EQUAL(10, published_ms);
+
+    // pipelined: the next conversion started with the last publish
+    GcvPipeline_Init(&fake_ops, true);
+    convert_pos = 0;
+    clear_pos = 0;
+    script(convert_script, "wpwwpw");
+    GcvPipeline_Step(100);
+    TEST_ASSERT_TRUE(GcvPipeline_Step(110));
+    TEST_ASSERT_EQUAL(100, published_ms);
+    GcvPipeline_Step(120);
+    TEST_ASSERT_TRUE(GcvPipeline_Step(130));
+    TEST_ASSERT_EQUAL(110, published_ms);
+}
+
+TEST(Gcv_Pipeline_Test, open_wire_pipelined) {
+    printf("open_wire_pipelined");
+    GcvPipeline_Init(&fake_ops, true);
+    script(convert_script, "wpwwpw");
+    script(clear_script, "pp");
+    script(open_wire_script, "wwp");
+
+    TEST_ASSERT_FALSE(GcvPipeline_Step(0));
+    GcvPipeline_RequestOpenWire();
+    // the running conversion is read back and published, nothing kicked
+    TEST_ASSERT_TRUE(GcvPipeline_Step(0));
+    TEST_ASSERT_EQUAL_STRING("ccxp", op_log);
+    TEST_ASSERT_TRUE(GcvPipeline_OpenWirePending());
+
+    TEST_ASSERT_FALSE(GcvPipeline_Step(0));
+    TEST_ASSERT_EQUAL(GCV_STATE_OPEN_WIRE, GcvPipeline_GetState());
+    TEST_ASSERT_FALSE(GcvPipeline_Step(0));
+    // the test passes and the next conversion starts in the same step
+    TEST_ASSERT_FALSE(GcvPipeline_Step(0));
+    TEST_ASSERT_EQUAL_STRING("ccxpoooc", op_log);
+    TEST_ASSERT_FALSE(GcvPipeline_OpenWirePending());
+    TEST_ASSERT_EQUAL(GCV_STATE_CONVERTING, GcvPipeline_GetState());
+
+    TEST_ASSERT_FALSE(GcvPipeline_Step(0));
+    TEST_ASSERT_TRUE(GcvPipeline_Step(0));
+    TEST_ASSERT_EQUAL_STRING("ccxpooocccxcp", op_log);
+}
+
+TEST(Gcv_Pipeline_Test, open_wire_one_shot) {
+    printf("open_wire_one_shot");
+    GcvPipeline_Init(&fake_ops, false);
+    script(convert_script, "wp");
+    script(clear_script, "p");
+    script(open_wire_script, "wp");
+
+    GcvPipeline_RequestOpenWire();
+    TEST_ASSERT_FALSE(GcvPipeline_Step(0));
+    TEST_ASSERT_FALSE(GcvPipeline_Step(0));
+    TEST_ASSERT_TRUE(GcvPipeline_Step(0));
+    TEST_ASSERT_EQUAL_STRING("ooccxp", op_log);
+}
+
+TEST(Gcv_Pipeline_Test, open_wire_fail) {
+    printf("open_wire_fail");
+    GcvPipeline_Init(&fake_ops, false);
+    script(convert_script, "w");
+    script(open_wire_script, "e");
+
+    GcvPipeline_RequestOpenWire();
+    TEST_ASSERT_FALSE(GcvPipeline_Step(0));
+    TEST_ASSERT_EQUAL_STRING("oc", op_log);
+    TEST_ASSERT_FALSE(GcvPipeline_OpenWirePending());
+
+    GcvPipeline_RequestOpenWire();
+    GcvPipeline_Init(&fake_ops, false);
+    TEST_ASSERT_FALSE(GcvPipeline_OpenWirePending());
+}
+
+TEST_GROUP_RUNNER(Gcv_Pipeline_Test) {
+    RUN_TEST_CASE(Gcv_Pipeline_Test, one_shot);
+    RUN_TEST_CASE(Gcv_Pipeline_Test, pipelined);
+    RUN_TEST_CASE(Gcv_Pipeline_Test, clear_waiting);
+    RUN_TEST_CASE(Gcv_Pipeline_Test, convert_error);
+    RUN_TEST_CASE(Gcv_Pipeline_Test, clear_error);
+    RUN_TEST_CASE(Gcv_Pipeline_Test, sample_time);
+    RUN_TEST_CASE(Gcv_Pipeline_Test, open_wire_pipelined);
+    RUN_TEST_CASE(Gcv_Pipeline_Test, open_wire_one_shot);
+    RUN_TEST_CASE(Gcv_Pipeline_Test, open_wire_fail);
+}
@@ -0,0 +1,168 @@
+#include "unity.h"
+#include "unity_fixture.h"
+#include <stdio.h>
+#include "mux_sequence.h"
+
+/**
+ * Testing Strategy
+ *
+ * MuxSequence_Select()
+ * - pin levels unknown: clock/latch init and the first data bit written
+ * - pin levels known: clock/latch init and unchanged data bits left out
+ * MuxSequence_Run()
+ * - shift register ends up latching the address
+ * - waiting write: resumed at the same step, nothing rewritten
+ * - error: whole sequence rebuilt and rewritten
+ * - a sweep of addresses latches each one in turn
+ */
+
+#define FAKE_LOG_LEN 64
+
+// pin writes in order: d/c/l = data/clock/latch low, upper case high
+static char write_log[FAKE_LOG_LEN + 1];
+static uint8_t write_log_len;
+static MUX_WRITE_STATUS_T write_status;
+static uint16_t writes_left;    // writes that pass before write_status is returned
+#define WRITES_UNLIMITED 0xFFFF
+
+// 74HC595 style shift register behind the pins
+static bool pin_level[3];
+static uint8_t shift_reg;
+static uint8_t latched;
+
+static MUX_WRITE_STATUS_T fake_write(MUX_PIN_T pin, bool level) {
+    if (writes_left == 0) {
+        return write_status;
+    }
+    if (writes_left != WRITES_UNLIMITED) {
+        writes_left--;
+    }
+
+    if (write_log_len < FAKE_LOG_LEN) {
+        write_log[write_log_len++] = "dcl"[pin] - (level ? 'a' - 'A' : 0);
+        write_log[write_log_len] = '\0';
+    }
+    if (pin == MUX_PIN_CLOCK && level && !pin_level[MUX_PIN_CLOCK]) {
+        shift_reg = (shift_reg << 1) | pin_level[MUX_PIN_DATA];
+    }
+    if (pin == MUX_PIN_LATCH && level && !pin_level[MUX_PIN_LATCH]) {
+        latched = shift_reg;
+    }
+    pin_level[pin] = level;
+    return MUX_WRITE_PASS;
+}
+
+static void clear_log(void) {
+    write_log[0] = '\0';
+    write_log_len = 0;
+}
+
+static MUX_SEQUENCE_T seq;
+
+TEST_GROUP(Mux_Sequence_Test);
+
+TEST_SETUP(Mux_Sequence_Test) {
+    printf("\r(Mux_Sequence_Test)Setup");
+    MuxSequence_Init(&seq);
+    clear_log();
+    write_status = MUX_WRITE_PASS;
+    writes_left = WRITES_UNLIMITED;
+    // power up levels
+    pin_level[MUX_PIN_DATA] = true;
+    pin_level[MUX_PIN_CLOCK] = true;
+    pin_level[MUX_PIN_LATCH] = true;
+    shift_reg = 0xFF;
+    latched = 0xFF;
+    printf("...");
+}
+
+TEST_TEAR_DOWN(Mux_Sequence_Test) {
+    printf("...");
+    printf("Teardown\r\n");
+}
+
+TEST(Mux_Sequence_Test, unknown_levels) {
+    printf("unknown_levels");
+    // data still has to be written once, after that only when a bit changes
+    TEST_ASSERT_EQUAL(2 + 4 + 16 + 2, MuxSequence_Select(&seq, 0x05));
+    TEST_ASSERT_EQUAL(MUX_WRITE_PASS, MuxSequence_Run(&seq, fake_write));
+    TEST_ASSERT_EQUAL_STRING("cl" "dCc" "Cc" "Cc" "Cc" "Cc" "DCc" "dCc" "DCc" "Ll",
+            write_log);
+    TEST_ASSERT_EQUAL_HEX8(0x05, latched);
+}
+
+TEST(Mux_Sequence_Test, known_levels) {
+    printf("known_levels");
+    MuxSequence_Select(&seq, 0x05);
+    MuxSequence_Run(&seq, fake_write);
+    clear_log();
+
+    // clock and latch are left low, data high by the last bit of 0x05
+    TEST_ASSERT_EQUAL(4 + 16 + 2, MuxSequence_Select(&seq, 0x13));
+    TEST_ASSERT_EQUAL(MUX_WRITE_PASS, MuxSequence_Run(&seq, fake_write));
+    TEST_ASSERT_EQUAL_STRING("dCc" "Cc" "Cc" "DCc" "dCc" "Cc" "DCc" "Cc" "Ll", write_log);
+    TEST_ASSERT_EQUAL_HEX8(0x13, latched);
+
+    // done sequences write nothing more
+    clear_log();
+    TEST_ASSERT_EQUAL(MUX_WRITE_PASS, MuxSequence_Run(&seq, fake_write));
+    TEST_ASSERT_EQUAL_STRING("", write_log);
+}
+
+TEST(Mux_Sequence_Test, waiting) {
+    printf("waiting");
+    MuxSequence_Select(&seq, 0x05);
+    write_status = MUX_WRITE_WAITING;
+    writes_left = 10;
+    TEST_ASSERT_EQUAL(MUX_WRITE_WAITING, MuxSequence_Run(&seq, fake_write));
+    writes_left = 0;
+    TEST_ASSERT_EQUAL(MUX_WRITE_WAITING, MuxSequence_Run(&seq, fake_write));
+
+    writes_left = WRITES_UNLIMITED;
+    TEST_ASSERT_EQUAL(MUX_WRITE_PASS, MuxSequence_Run(&seq, fake_write));
+    TEST_ASSERT_EQUAL_STRING("cl" "dCc" "Cc" "Cc" "Cc" "Cc" "DCc" "dCc" "DCc" "Ll",
+            write_log);
+    TEST_ASSERT_EQUAL_HEX8(0x05, latched);
+}
+
+TEST(Mux_Sequence_Test, error) {
+    printf("error");
+    MuxSequence_Select(&seq, 0x05);
+    MuxSequence_Run(&seq, fake_write);
+
+    MuxSequence_Select(&seq, 0x13);
+    write_status = MUX_WRITE_ERROR;
+    writes_left = 5;
+    TEST_ASSERT_EQUAL(MUX_WRITE_ERROR, MuxSequence_Run(&seq, fake_write));
+    clear_log();
+
+    // nothing can be assumed about the pins any more
+    writes_left = WRITES_UNLIMITED;
+    TEST_ASSERT_EQUAL(MUX_WRITE_PASS, MuxSequence_Run(&seq, fake_write));
+    TEST_ASSERT_EQUAL_STRING("cl" "dCc" "Cc" "Cc" "DCc" "dCc" "Cc" "DCc" "Cc" "Ll",
+            write_log);
+    TEST_ASSERT_EQUAL_HEX8(0x13, latched);
+}
+
+TEST(Mux_Sequence_Test, sweep) {
+    printf("sweep");
+    uint16_t writes = 0;
+    uint8_t address;
+    for (address = 3; address < 32; address++) {
+        writes += MuxSequence_Select(&seq, address);
+        TEST_ASSERT_EQUAL(MUX_WRITE_PASS, MuxSequence_Run(&seq, fake_write));
+        TEST_ASSERT_EQUAL_HEX8(address, latched);
+        TEST_ASSERT_EQUAL(0, pin_level[MUX_PIN_CLOCK]);
+        TEST_ASSERT_EQUAL(0, pin_level[MUX_PIN_LATCH]);
+    }
+    // 29 addresses at 28 writes each before
+    TEST_ASSERT_TRUE(writes < 29 * 22);
+}
+
+TEST_GROUP_RUNNER(Mux_Sequence_Test) {
+    RUN_TEST_CASE(Mux_Sequence_Test, unknown_levels);
+    RUN_TEST_CASE(Mux_Sequence_Test, known_levels);
+    RUN_TEST_CASE(Mux_Sequence_Test, waiting);
+    RUN_TEST_CASE(Mux_Sequence_Test, error);
+    RUN_TEST_CASE(Mux_Sequence_Test, sweep);
+}
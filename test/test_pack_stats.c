@@ -0,0 +1,185 @@
+#include "unity.h"
+#include "unity_fixture.h"
+#include <stdio.h>
+#include "state_types.h"
+#include "pack_stats.h"
+
+/**
+ * Testing Strategy
+ *
+ * PackStats_UpdateVoltages()
+ * - modules with different cell counts
+ * - pack min/max in first, middle and last module
+ * PackStats_UpdateCellSum()
+ * - modules with different cell counts, one module changes between updates
+ * - pack reconfigured with fewer modules
+ * PackStats_PackVoltageMismatch()
+ * - pack voltage above and below the cell sum, inside and just outside the
+ *   tolerance
+ * PackStats_UpdateTemperature()
+ * - new reading above module max, below module min, in between
+ * - module max/min reading moves inwards (forces rescan)
+ * - result always matches a full rescan
+ */
+
+static BMS_PACK_STATUS_T stats_pack_status;
+static uint32_t stats_cell_voltages[MAX_NUM_MODULES*MAX_CELLS_PER_MODULE];
+static int16_t stats_cell_temperatures[MAX_NUM_MODULES*MAX_THERMISTORS_PER_MODULE];
+static uint8_t stats_module_cell_count[MAX_NUM_MODULES];
+
+TEST_GROUP(Pack_Stats_Test);
+
+TEST_SETUP(Pack_Stats_Test) {
+    printf("\r(Pack_Stats_Test)Setup");
+    uint16_t i;
+    for (i = 0; i < MAX_NUM_MODULES*MAX_CELLS_PER_MODULE; i++) {
+        stats_cell_voltages[i] = 3600;
+    }
+    for (i = 0; i < MAX_NUM_MODULES*MAX_THERMISTORS_PER_MODULE; i++) {
+        stats_cell_temperatures[i] = 250;
+    }
+    for (i = 0; i < MAX_NUM_MODULES; i++) {
+        stats_module_cell_count[i] = 0;
+    }
+    stats_pack_status.cell_voltages_mV = stats_cell_voltages;
+    stats_pack_status.cell_voltages_raw_mV = stats_cell_voltages;
+    stats_pack_status.cell_temperatures_dC = stats_cell_temperatures;
+    PackStats_Init(&stats_pack_status);
+    printf("...");
+}
+
+TEST_TEAR_DOWN(Pack_Stats_Test) {
+    printf("...");
+    printf("Teardown\r\n");
+}
+
+TEST(Pack_Stats_Test, voltages) {
+    printf("voltages");
+    stats_module_cell_count[0] = 12;
+    stats_module_cell_count[1] = 10;
+    stats_module_cell_count[2] = 12;
+    // module 1 starts at cell 12, module 2 at cell 22
+    stats_cell_voltages[5] = 3500;
+    stats_cell_voltages[15] = 3700;
+    stats_cell_voltages[33] = 3400;
+
+    PackStats_UpdateVoltages(&stats_pack_status, 3, stats_module_cell_count);
+
+    TEST_ASSERT_EQUAL(3700, stats_pack_status.pack_cell_max_mV);
+    TEST_ASSERT_EQUAL(15, stats_pack_status.max_cell_voltage_position);
+    TEST_ASSERT_EQUAL(3400, stats_pack_status.pack_cell_min_mV);
+    TEST_ASSERT_EQUAL(33, stats_pack_status.min_cell_voltage_position);
+    TEST_ASSERT_EQUAL((34*3600 - 100 + 100 - 200)/34, stats_pack_status.avg_cell_voltage_mV);
+}
+
+TEST(Pack_Stats_Test, cell_sum) {
+    printf("cell_sum");
+    stats_module_cell_count[0] = 12;
+    stats_module_cell_count[1] = 10;
+    stats_module_cell_count[2] = 12;
+
+    PackStats_UpdateCellSum(&stats_pack_status, 3, stats_module_cell_count);
+    TEST_ASSERT_EQUAL(34*3600, stats_pack_status.pack_cell_sum_mV);
+
+    // a cell in the middle module drops
+    stats_cell_voltages[15] = 3100;
+    PackStats_UpdateCellSum(&stats_pack_status, 3, stats_module_cell_count);
+    TEST_ASSERT_EQUAL(34*3600 - 500, stats_pack_status.pack_cell_sum_mV);
+
+    // cells past the pack's last module are not counted
+    stats_cell_voltages[34] = 0;
+    PackStats_UpdateCellSum(&stats_pack_status, 3, stats_module_cell_count);
+    TEST_ASSERT_EQUAL(34*3600 - 500, stats_pack_status.pack_cell_sum_mV);
+}
+
+TEST(Pack_Stats_Test, cell_sum_fewer_modules) {
+    printf("cell_sum_fewer_modules");
+    stats_module_cell_count[0] = 12;
+    stats_module_cell_count[1] = 12;
+    stats_module_cell_count[2] = 12;
+    PackStats_UpdateCellSum(&stats_pack_status, 3, stats_module_cell_count);
+    TEST_ASSERT_EQUAL(36*3600, stats_pack_status.pack_cell_sum_mV);
+
+    // the pack config reloads with one module less
+    PackStats_UpdateCellSum(&stats_pack_status, 2, stats_module_cell_count);
+    TEST_ASSERT_EQUAL(24*3600, stats_pack_status.pack_cell_sum_mV);
+    TEST_ASSERT_FALSE(PackStats_PackVoltageMismatch(stats_pack_status.pack_cell_sum_mV,
+            24*3600));
+}
+
+TEST(Pack_Stats_Test, pack_voltage_mismatch) {
+    printf("pack_voltage_mismatch");
+    uint32_t sum_mV = 100000;
+    uint32_t tolerance_mV = PACK_VOLTAGE_MISMATCH_mV
+            + sum_mV / 1000 * PACK_VOLTAGE_MISMATCH_PERMILLE;
+
+    TEST_ASSERT_FALSE(PackStats_PackVoltageMismatch(sum_mV, sum_mV));
+    TEST_ASSERT_FALSE(PackStats_PackVoltageMismatch(sum_mV, sum_mV + tolerance_mV));
+    TEST_ASSERT_FALSE(PackStats_PackVoltageMismatch(sum_mV, sum_mV - tolerance_mV));
+    TEST_ASSERT_TRUE(PackStats_PackVoltageMismatch(sum_mV, sum_mV + tolerance_mV + 1));
+    TEST_ASSERT_TRUE(PackStats_PackVoltageMismatch(sum_mV, sum_mV - tolerance_mV - 1));
+}
+
+TEST(Pack_Stats_Test, temperature_incremental) {
+    printf("temperature_incremental");
+    PackStats_UpdateTemperature(stats_cell_temperatures, 2, 5, 400);
+    PackStats_UpdateTemperature(stats_cell_temperatures, 1, 23, 100);
+    PackStats_WriteTemperatures(&stats_pack_status, 3);
+
+    TEST_ASSERT_EQUAL(400, stats_pack_status.max_cell_temp_dC);
+    TEST_ASSERT_EQUAL(400, stats_cell_temperatures[2*MAX_THERMISTORS_PER_MODULE + 5]);
+#ifdef FSAE_DRIVERS
+    TEST_ASSERT_EQUAL(2*MAX_THERMISTORS_PER_MODULE + 5, stats_pack_status.max_cell_temp_position);
+    TEST_ASSERT_EQUAL(100, stats_pack_status.min_cell_temp_dC);
+    TEST_ASSERT_EQUAL(1*MAX_THERMISTORS_PER_MODULE + 23, stats_pack_status.min_cell_temp_position);
+    TEST_ASSERT_EQUAL((3*MAX_THERMISTORS_PER_MODULE*250 + 150 - 150)/(3*MAX_THERMISTORS_PER_MODULE),
+            stats_pack_status.avg_cell_temp_dC);
+#endif
+
+    // the hottest reading cools down, the next hottest is elsewhere in the module
+    PackStats_UpdateTemperature(stats_cell_temperatures, 2, 7, 350);
+    PackStats_UpdateTemperature(stats_cell_temperatures, 2, 5, 200);
+    PackStats_WriteTemperatures(&stats_pack_status, 3);
+
+    TEST_ASSERT_EQUAL(350, stats_pack_status.max_cell_temp_dC);
+    const PACK_STATS_T *module2 = PackStats_GetModuleTemperatures(2);
+    TEST_ASSERT_EQUAL(350, module2->max);
+    TEST_ASSERT_EQUAL(2*MAX_THERMISTORS_PER_MODULE + 7, module2->max_position);
+    TEST_ASSERT_EQUAL(200, module2->min);
+    TEST_ASSERT_EQUAL(2*MAX_THERMISTORS_PER_MODULE + 5, module2->min_position);
+}
+
+TEST(Pack_Stats_Test, temperature_matches_rescan) {
+    printf("temperature_matches_rescan");
+    const uint8_t num_modules = 4;
+    uint32_t seed = 12345;
+    uint16_t step;
+    for (step = 0; step < 2000; step++) {
+        seed = seed * 1103515245 + 12345;
+        uint8_t module = (seed >> 8) % num_modules;
+        uint8_t thermistor = (seed >> 12) % MAX_THERMISTORS_PER_MODULE;
+        int16_t temp_dC = (int16_t)((seed >> 16) % 800) - 200;
+        PackStats_UpdateTemperature(stats_cell_temperatures, module, thermistor, temp_dC);
+
+        uint8_t m;
+        for (m = 0; m < num_modules; m++) {
+            PACK_STATS_T incremental = *PackStats_GetModuleTemperatures(m);
+            PackStats_RescanTemperatures(&stats_pack_status, num_modules);
+            const PACK_STATS_T *rescanned = PackStats_GetModuleTemperatures(m);
+            TEST_ASSERT_EQUAL(rescanned->sum, incremental.sum);
+            TEST_ASSERT_EQUAL(rescanned->max, incremental.max);
+            TEST_ASSERT_EQUAL(rescanned->min, incremental.min);
+            TEST_ASSERT_EQUAL(rescanned->max, stats_cell_temperatures[incremental.max_position]);
+            TEST_ASSERT_EQUAL(rescanned->min, stats_cell_temperatures[incremental.min_position]);
+        }
+    }
+}
+
+TEST_GROUP_RUNNER(Pack_Stats_Test) {
+    RUN_TEST_CASE(Pack_Stats_Test, voltages);
+    RUN_TEST_CASE(Pack_Stats_Test, cell_sum);
+    RUN_TEST_CASE(Pack_Stats_Test, cell_sum_fewer_modules);
+    RUN_TEST_CASE(Pack_Stats_Test, pack_voltage_mismatch);
+    RUN_TEST_CASE(Pack_Stats_Test, temperature_incremental);
+    RUN_TEST_CASE(Pack_Stats_Test, temperature_matches_rescan);
+}
@@ -0,0 +1,76 @@
+#include "unity.h"
+#include "unity_fixture.h"
+#include <stdio.h>
+#include "pec15.h"
+
+/**
+ * Testing Strategy
+ *
+ * Pec15_Calc()
+ * - command PECs from the LTC6804 datasheet
+ * - empty input: the seed
+ * Pec15_UpdateTable16(), Pec15_UpdateTable256()
+ * - every remainder with every byte matches the bitwise reference
+ * - register group sized messages carry the remainder across bytes
+ */
+
+TEST_GROUP(Pec15_Test);
+
+TEST_SETUP(Pec15_Test) {
+    printf("\r(Pec15_Test)Setup");
+    printf("...");
+}
+
+TEST_TEAR_DOWN(Pec15_Test) {
+    printf("...");
+    printf("Teardown\r\n");
+}
+
+TEST(Pec15_Test, datasheet) {
+    printf("datasheet");
+    const uint8_t wrcfg[] = {0x00, 0x01};
+    const uint8_t rdcva[] = {0x00, 0x04};
+    TEST_ASSERT_EQUAL_HEX16(0x3D6E, Pec15_Calc(wrcfg, sizeof(wrcfg)));
+    TEST_ASSERT_EQUAL_HEX16(0x07C2, Pec15_Calc(rdcva, sizeof(rdcva)));
+    TEST_ASSERT_EQUAL_HEX16(PEC15_SEED << 1, Pec15_Calc(wrcfg, 0));
+}
+
+TEST(Pec15_Test, exhaustive) {
+    printf("exhaustive");
+    uint32_t rem;
+    for (rem = 0; rem <= 0x7FFF; rem++) {
+        uint16_t byte;
+        for (byte = 0; byte <= 0xFF; byte++) {
+            uint8_t data = byte;
+            uint16_t expected = Pec15_UpdateBitwise(rem, &data, 1);
+            if (Pec15_UpdateTable16(rem, &data, 1) != expected ||
+                    Pec15_UpdateTable256(rem, &data, 1) != expected) {
+                TEST_FAIL_MESSAGE("table remainder differs from bitwise");
+            }
+        }
+    }
+}
+
+TEST(Pec15_Test, register_groups) {
+    printf("register_groups");
+    uint32_t seed = 12345;
+    uint8_t group[6];
+    uint16_t n;
+    for (n = 0; n < 1000; n++) {
+        uint8_t i;
+        for (i = 0; i < sizeof(group); i++) {
+            seed = seed * 1103515245 + 12345;
+            group[i] = seed >> 16;
+        }
+        uint16_t expected = Pec15_UpdateBitwise(PEC15_SEED, group, sizeof(group));
+        TEST_ASSERT_EQUAL_HEX16(expected, Pec15_UpdateTable16(PEC15_SEED, group, sizeof(group)));
+        TEST_ASSERT_EQUAL_HEX16(expected, Pec15_UpdateTable256(PEC15_SEED, group, sizeof(group)));
+        TEST_ASSERT_EQUAL_HEX16(expected << 1, Pec15_Calc(group, sizeof(group)));
+    }
+}
+
+TEST_GROUP_RUNNER(Pec15_Test) {
+    RUN_TEST_CASE(Pec15_Test, datasheet);
+    RUN_TEST_CASE(Pec15_Test, exhaustive);
+    RUN_TEST_CASE(Pec15_Test, register_groups);
+}
@@ -0,0 +1,91 @@
+#include "unity.h"
+#include "unity_fixture.h"
+#include <stdio.h>
+#include "sample_sync.h"
+
+/**
+ * Testing Strategy
+ *
+ * SampleSync_CurrentAt_mA()
+ * - no samples
+ * - between two samples, rising and falling
+ * - on a sample, after the newest, before the oldest
+ * - more samples than the history holds
+ * - msTicks wrapping between samples
+ * - current changing sign (regen during a discharge)
+ * SampleSync_CurrentLead_ms()
+ * - newest sample after and before the time of interest
+ */
+
+TEST_GROUP(Sample_Sync_Test);
+
+TEST_SETUP(Sample_Sync_Test) {
+    printf("\r(Sample_Sync_Test)Setup");
+    SampleSync_Init();
+    printf("...");
+}
+
+TEST_TEAR_DOWN(Sample_Sync_Test) {
+    printf("...");
+    printf("Teardown\r\n");
+}
+
+TEST(Sample_Sync_Test, empty) {
+    printf("empty");
+    TEST_ASSERT_EQUAL(0, SampleSync_CurrentAt_mA(100));
+    TEST_ASSERT_EQUAL(0, SampleSync_CurrentLead_ms(100));
+}
+
+TEST(Sample_Sync_Test, interpolate) {
+    printf("interpolate");
+    SampleSync_AddCurrent(10000, 1000);
+    SampleSync_AddCurrent(30000, 1100);
+    SampleSync_AddCurrent(20000, 1200);
+
+    TEST_ASSERT_EQUAL(15000, SampleSync_CurrentAt_mA(1025));
+    TEST_ASSERT_EQUAL(30000, SampleSync_CurrentAt_mA(1100));
+    TEST_ASSERT_EQUAL(26000, SampleSync_CurrentAt_mA(1140));
+
+    // held, not extrapolated
+    TEST_ASSERT_EQUAL(20000, SampleSync_CurrentAt_mA(1300));
+    TEST_ASSERT_EQUAL(10000, SampleSync_CurrentAt_mA(900));
+}
+
+TEST(Sample_Sync_Test, history_full) {
+    printf("history_full");
+    uint32_t i;
+    for (i = 0; i < SAMPLE_SYNC_CURRENT_LEN + 2; i++) {
+        SampleSync_AddCurrent(1000*i, 100*i);
+    }
+    // the first two samples are gone, the oldest left holds
+    TEST_ASSERT_EQUAL(2000, SampleSync_CurrentAt_mA(50));
+    TEST_ASSERT_EQUAL(2500, SampleSync_CurrentAt_mA(250));
+    TEST_ASSERT_EQUAL(1000*(SAMPLE_SYNC_CURRENT_LEN + 1) - 500,
+            SampleSync_CurrentAt_mA(100*(SAMPLE_SYNC_CURRENT_LEN + 1) - 50));
+}
+
+TEST(Sample_Sync_Test, wrap) {
+    printf("wrap");
+    SampleSync_AddCurrent(0, UINT32_MAX - 49);
+    SampleSync_AddCurrent(10000, 50);
+    TEST_ASSERT_EQUAL(5000, SampleSync_CurrentAt_mA(0));
+    TEST_ASSERT_EQUAL(50, SampleSync_CurrentLead_ms(0));
+    TEST_ASSERT_EQUAL(-50, SampleSync_CurrentLead_ms(100));
+}
+
+TEST(Sample_Sync_Test, signed) {
+    printf("signed");
+    SampleSync_AddCurrent(20000, 1000);
+    SampleSync_AddCurrent(-20000, 1100);
+    TEST_ASSERT_EQUAL(10000, SampleSync_CurrentAt_mA(1025));
+    TEST_ASSERT_EQUAL(-10000, SampleSync_CurrentAt_mA(1075));
+    TEST_ASSERT_EQUAL(-20000, SampleSync_CurrentAt_mA(1200));
+}
+
+TEST_GROUP_RUNNER(Sample_Sync_Test) {
+    RUN_TEST_CASE(Sample_Sync_Test, empty);
+    RUN_TEST_CASE(Sample_Sync_Test, interpolate);
+    RUN_TEST_CASE(Sample_Sync_Test, history_full);
+    RUN_TEST_CASE(Sample_Sync_Test, wrap);
+    RUN_TEST_CASE(Sample_Sync_Test, signed);
+}
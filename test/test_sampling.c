@@ -0,0 +1,139 @@
+#include "unity.h"
+#include "unity_fixture.h"
+#include <stdio.h>
+#include "sampling.h"
+#include "config.h"
+
+/**
+ * Testing Strategy
+ *
+ * Sampling_Update()
+ * - init: idle, nothing measured yet
+ * - quiet pack: idle in standby, normal in the other modes
+ * - fast on high current, even in standby
+ * - fast near cell_min_mV and near cell_max_mV
+ * - fast on a large dV/dt, measured once per window
+ * - fast held for SAMPLING_FAST_HOLD_ms after the last trigger
+ * - thresholds of 0 disable their trigger
+ * Sampling_GetPeriods()
+ * - faster rates have shorter periods
+ */
+
+static PACK_CONFIG_T config;
+static BMS_PACK_STATUS_T status;
+
+TEST_GROUP(Sampling_Test);
+
+TEST_SETUP(Sampling_Test) {
+    printf("\r(Sampling_Test)Setup");
+    Sampling_Init();
+    config.cell_min_mV = 2500;
+    config.cell_max_mV = 4250;
+    config.sample_fast_current_mA = 50000;
+    config.sample_fast_margin_mV = 100;
+    config.sample_fast_dvdt_mV_s = 20;
+    status.pack_current_mA = 0;
+    status.pack_cell_min_mV = 3600;
+    status.pack_cell_max_mV = 3700;
+    printf("...");
+}
+
+TEST_TEAR_DOWN(Sampling_Test) {
+    printf("...");
+    printf("Teardown\r\n");
+}
+
+TEST(Sampling_Test, modes) {
+    printf("modes");
+    TEST_ASSERT_EQUAL(SAMPLING_RATE_IDLE, Sampling_Update(&config, &status, BMS_SSM_MODE_INIT, 0));
+    TEST_ASSERT_EQUAL(SAMPLING_RATE_IDLE, Sampling_Update(&config, &status, BMS_SSM_MODE_STANDBY, 100));
+    TEST_ASSERT_EQUAL(SAMPLING_RATE_NORMAL, Sampling_Update(&config, &status, BMS_SSM_MODE_CHARGE, 200));
+    TEST_ASSERT_EQUAL(SAMPLING_RATE_NORMAL, Sampling_Update(&config, &status, BMS_SSM_MODE_BALANCE, 300));
+    TEST_ASSERT_EQUAL(SAMPLING_RATE_NORMAL, Sampling_Update(&config, &status, BMS_SSM_MODE_DISCHARGE, 400));
+    TEST_ASSERT_EQUAL(SAMPLING_RATE_NORMAL, Sampling_GetRate());
+}
+
+TEST(Sampling_Test, current) {
+    printf("current");
+    status.pack_current_mA = 49999;
+    TEST_ASSERT_EQUAL(SAMPLING_RATE_NORMAL, Sampling_Update(&config, &status, BMS_SSM_MODE_DISCHARGE, 0));
+    status.pack_current_mA = 50000;
+    TEST_ASSERT_EQUAL(SAMPLING_RATE_FAST, Sampling_Update(&config, &status, BMS_SSM_MODE_DISCHARGE, 100));
+    TEST_ASSERT_EQUAL(SAMPLING_RATE_FAST, Sampling_Update(&config, &status, BMS_SSM_MODE_STANDBY, 200));
+
+    config.sample_fast_current_mA = 0;
+    Sampling_Init();
+    TEST_ASSERT_EQUAL(SAMPLING_RATE_NORMAL, Sampling_Update(&config, &status, BMS_SSM_MODE_DISCHARGE, 0));
+}
+
+TEST(Sampling_Test, limits) {
+    printf("limits");
+    status.pack_cell_min_mV = 2601;
+    TEST_ASSERT_EQUAL(SAMPLING_RATE_NORMAL, Sampling_Update(&config, &status, BMS_SSM_MODE_DISCHARGE, 0));
+    status.pack_cell_min_mV = 2600;
+    TEST_ASSERT_EQUAL(SAMPLING_RATE_FAST, Sampling_Update(&config, &status, BMS_SSM_MODE_DISCHARGE, 0));
+
+    Sampling_Init();
+    status.pack_cell_min_mV = 3600;
+    status.pack_cell_max_mV = 4149;
+    TEST_ASSERT_EQUAL(SAMPLING_RATE_NORMAL, Sampling_Update(&config, &status, BMS_SSM_MODE_CHARGE, 0));
+    status.pack_cell_max_mV = 4150;
+    TEST_ASSERT_EQUAL(SAMPLING_RATE_FAST, Sampling_Update(&config, &status, BMS_SSM_MODE_CHARGE, 0));
+
+    config.sample_fast_margin_mV = 0;
+    Sampling_Init();
+    TEST_ASSERT_EQUAL(SAMPLING_RATE_NORMAL, Sampling_Update(&config, &status, BMS_SSM_MODE_CHARGE, 0));
+}
+
+TEST(Sampling_Test, dvdt) {
+    printf("dvdt");
+    Sampling_Update(&config, &status, BMS_SSM_MODE_DISCHARGE, 0);
+
+    // 19 mV over a second on the min cell
+    status.pack_cell_min_mV -= 19;
+    TEST_ASSERT_EQUAL(SAMPLING_RATE_NORMAL, Sampling_Update(&config, &status, BMS_SSM_MODE_DISCHARGE, 500));
+    TEST_ASSERT_EQUAL(SAMPLING_RATE_NORMAL,
+            Sampling_Update(&config, &status, BMS_SSM_MODE_DISCHARGE, SAMPLING_DVDT_WINDOW_ms));
+    TEST_ASSERT_EQUAL(19, Sampling_GetDvdt_mV_s());
+
+    // 10 mV in the first half of the next window on the max cell
+    status.pack_cell_max_mV += 10;
+    TEST_ASSERT_EQUAL(SAMPLING_RATE_NORMAL,
+            Sampling_Update(&config, &status, BMS_SSM_MODE_DISCHARGE, 3*SAMPLING_DVDT_WINDOW_ms/2));
+    // then 15 more, 25 mV/s over the window
+    status.pack_cell_max_mV += 15;
+    TEST_ASSERT_EQUAL(SAMPLING_RATE_FAST,
+            Sampling_Update(&config, &status, BMS_SSM_MODE_DISCHARGE, 2*SAMPLING_DVDT_WINDOW_ms));
+    TEST_ASSERT_EQUAL(25, Sampling_GetDvdt_mV_s());
+}
+
+TEST(Sampling_Test, hold) {
+    printf("hold");
+    status.pack_current_mA = 60000;
+    TEST_ASSERT_EQUAL(SAMPLING_RATE_FAST, Sampling_Update(&config, &status, BMS_SSM_MODE_DISCHARGE, 100));
+    status.pack_current_mA = 0;
+    TEST_ASSERT_EQUAL(SAMPLING_RATE_FAST,
+            Sampling_Update(&config, &status, BMS_SSM_MODE_STANDBY, 100 + SAMPLING_FAST_HOLD_ms - 1));
+    TEST_ASSERT_EQUAL(SAMPLING_RATE_IDLE,
+            Sampling_Update(&config, &status, BMS_SSM_MODE_STANDBY, 100 + SAMPLING_FAST_HOLD_ms));
+}
+
+TEST(Sampling_Test, periods) {
+    printf("periods");
+    const SAMPLING_PERIODS_T *idle = Sampling_GetPeriods(SAMPLING_RATE_IDLE);
+    const SAMPLING_PERIODS_T *normal = Sampling_GetPeriods(SAMPLING_RATE_NORMAL);
+    const SAMPLING_PERIODS_T *fast = Sampling_GetPeriods(SAMPLING_RATE_FAST);
+    TEST_ASSERT_TRUE(idle->cell_voltages_ms > normal->cell_voltages_ms);
+    TEST_ASSERT_TRUE(normal->cell_voltages_ms > fast->cell_voltages_ms);
+    TEST_ASSERT_TRUE(idle->thermistor_ms > normal->thermistor_ms);
+    TEST_ASSERT_TRUE(normal->thermistor_ms > fast->thermistor_ms);
+}
+
+TEST_GROUP_RUNNER(Sampling_Test) {
+    RUN_TEST_CASE(Sampling_Test, modes);
+    RUN_TEST_CASE(Sampling_Test, current);
+    RUN_TEST_CASE(Sampling_Test, limits);
+    RUN_TEST_CASE(Sampling_Test, dvdt);
+    RUN_TEST_CASE(Sampling_Test, hold);
+    RUN_TEST_CASE(Sampling_Test, periods);
+}
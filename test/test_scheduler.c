@@ -0,0 +1,183 @@
+#include "unity.h"
+#include "unity_fixture.h"
+#include <stdio.h>
+#include "scheduler.h"
+
+extern volatile uint32_t msTicks;
+
+/**
+ * Testing Strategy
+ *
+ * Scheduler_Run()
+ * - tasks released at the same time run in priority order, then deadline order
+ * - busy task is polled again on the next pass and keeps its release time
+ * - completion later than one period counts as an overrun
+ * - late first poll is recorded as jitter
+ * Scheduler_SetPeriod()
+ * - new period applies from the next release
+ * Scheduler_AddTask()
+ * - full task table
+ */
+
+#define MAX_CALLS 16
+
+static char call_log[MAX_CALLS + 1];
+static uint8_t num_calls;
+static uint8_t busy_polls_left;
+
+static void log_call(char c) {
+    if (num_calls < MAX_CALLS) {
+        call_log[num_calls++] = c;
+        call_log[num_calls] = '\0';
+    }
+}
+
+static SCHEDULER_TASK_STATUS_T task_a(uint32_t ms) {
+    (void)ms;
+    log_call('a');
+    return SCHEDULER_TASK_DONE;
+}
+
+static SCHEDULER_TASK_STATUS_T task_b(uint32_t ms) {
+    (void)ms;
+    log_call('b');
+    return SCHEDULER_TASK_DONE;
+}
+
+static SCHEDULER_TASK_STATUS_T task_busy(uint32_t ms) {
+    (void)ms;
+    log_call('x');
+    if (busy_polls_left > 0) {
+        busy_polls_left--;
+        return SCHEDULER_TASK_BUSY;
+    }
+    return SCHEDULER_TASK_DONE;
+}
+
+TEST_GROUP(Scheduler_Test);
+
+TEST_SETUP(Scheduler_Test) {
+    printf("\r(Scheduler_Test)Setup");
+    Scheduler_Init();
+    msTicks = 0;
+    num_calls = 0;
+    call_log[0] = '\0';
+    busy_polls_left = 0;
+    printf("...");
+}
+
+TEST_TEAR_DOWN(Scheduler_Test) {
+    printf("...");
+    printf("Teardown\r\n");
+}
+
+TEST(Scheduler_Test, order) {
+    printf("order");
+    Scheduler_AddTask("b", task_b, 100, 1, 0);
+    Scheduler_AddTask("a", task_a, 50, 1, 0);
+    Scheduler_AddTask("x", task_busy, 1000, 0, 0);
+
+    // x has the highest priority, a has the earlier deadline of the rest
+    Scheduler_Run(0);
+    TEST_ASSERT_EQUAL_STRING("xab", call_log);
+
+    // nothing released yet
+    Scheduler_Run(49);
+    TEST_ASSERT_EQUAL_STRING("xab", call_log);
+
+    Scheduler_Run(50);
+    TEST_ASSERT_EQUAL_STRING("xaba", call_log);
+
+    Scheduler_Run(100);
+    TEST_ASSERT_EQUAL_STRING("xabaab", call_log);
+    TEST_ASSERT_EQUAL(3, Scheduler_GetTask(1)->runs);
+    TEST_ASSERT_EQUAL(2, Scheduler_GetTask(0)->runs);
+}
+
+TEST(Scheduler_Test, busy) {
+    printf("busy");
+    busy_polls_left = 2;
+    Scheduler_AddTask("x", task_busy, 100, 0, 0);
+
+    Scheduler_Run(0);
+    Scheduler_Run(10);
+    TEST_ASSERT_EQUAL_STRING("xx", call_log);
+    TEST_ASSERT_EQUAL(0, Scheduler_GetTask(0)->runs);
+
+    Scheduler_Run(20);
+    TEST_ASSERT_EQUAL_STRING("xxx", call_log);
+    TEST_ASSERT_EQUAL(1, Scheduler_GetTask(0)->runs);
+    TEST_ASSERT_EQUAL(20, Scheduler_GetTask(0)->max_latency_ms);
+    TEST_ASSERT_EQUAL(0, Scheduler_GetTask(0)->overruns);
+
+    // next release is one period after the first, not after completion
+    Scheduler_Run(99);
+    TEST_ASSERT_EQUAL_STRING("xxx", call_log);
+    Scheduler_Run(100);
+    TEST_ASSERT_EQUAL_STRING("xxxx", call_log);
+}
+
+TEST(Scheduler_Test, overrun) {
+    printf("overrun");
+    busy_polls_left = 1;
+    Scheduler_AddTask("x", task_busy, 100, 0, 0);
+
+    Scheduler_Run(0);
+    Scheduler_Run(150);
+    TEST_ASSERT_EQUAL(1, Scheduler_GetTask(0)->overruns);
+    TEST_ASSERT_EQUAL(150, Scheduler_GetTask(0)->max_latency_ms);
+
+    // the missed release is dropped, the next job is released right away
+    Scheduler_Run(151);
+    TEST_ASSERT_EQUAL_STRING("xxx", call_log);
+    TEST_ASSERT_EQUAL(2, Scheduler_GetTask(0)->runs);
+    TEST_ASSERT_EQUAL(1, Scheduler_GetTask(0)->overruns);
+}
+
+TEST(Scheduler_Test, jitter) {
+    printf("jitter");
+    Scheduler_AddTask("a", task_a, 100, 0, 0);
+
+    Scheduler_Run(0);
+    Scheduler_Run(107);
+    TEST_ASSERT_EQUAL(7, Scheduler_GetTask(0)->max_jitter_ms);
+    TEST_ASSERT_EQUAL(0, Scheduler_GetTask(0)->overruns);
+
+    // released at 200 regardless of the late run
+    Scheduler_Run(200);
+    TEST_ASSERT_EQUAL_STRING("aaa", call_log);
+}
+
+TEST(Scheduler_Test, set_period) {
+    printf("set_period");
+    uint8_t id = Scheduler_AddTask("a", task_a, 100, 0, 0);
+
+    Scheduler_Run(0);
+    Scheduler_SetPeriod(id, 10);
+    // already released at 100
+    Scheduler_Run(10);
+    TEST_ASSERT_EQUAL_STRING("a", call_log);
+    Scheduler_Run(100);
+    Scheduler_Run(110);
+    TEST_ASSERT_EQUAL_STRING("aaa", call_log);
+    TEST_ASSERT_EQUAL(10, Scheduler_GetTask(id)->period_ms);
+}
+
+TEST(Scheduler_Test, full) {
+    printf("full");
+    uint8_t i;
+    for (i = 0; i < SCHEDULER_MAX_TASKS; i++) {
+        TEST_ASSERT_EQUAL(i, Scheduler_AddTask("a", task_a, 100, 0, 0));
+    }
+    TEST_ASSERT_EQUAL(SCHEDULER_MAX_TASKS, Scheduler_AddTask("b", task_b, 100, 0, 0));
+    TEST_ASSERT_EQUAL(SCHEDULER_MAX_TASKS, Scheduler_GetTaskCount());
+}
+
+TEST_GROUP_RUNNER(Scheduler_Test) {
+    RUN_TEST_CASE(Scheduler_Test, order);
+    RUN_TEST_CASE(Scheduler_Test, busy);
+    RUN_TEST_CASE(Scheduler_Test, overrun);
+    RUN_TEST_CASE(Scheduler_Test, jitter);
+    RUN_TEST_CASE(Scheduler_Test, set_period);
+    RUN_TEST_CASE(Scheduler_Test, full);
+}
@@ -0,0 +1,265 @@
+#include "unity.h"
+#include "unity_fixture.h"
+#include <stdio.h>
+#include "state_types.h"
+#include "eeprom_config.h"
+#include "soc.h"
+
+/**
+ * Testing Strategy
+ *
+ * SOC_FromOcv_cpct()
+ * - below, on and between table points, above the table
+ * SOC_Step()
+ * - charge and discharge integrate, standby does not
+ * - clamps at empty and full
+ * - resets from OCV after resting
+ * - a stale current is neither integrated nor counted as rest
+ * - checkpoints only when the estimate moved
+ * - a checkpoint refused by a full EEPROM queue is retried next period
+ * SOC_Config()
+ * - restores the newest checkpoint, including across a sequence wrap
+ * - no checkpoint: starts from OCV
+ */
+
+// stands in for the RAM copy of the CC page
+static uint32_t soc_cc_page[SOC_CHECKPOINT_SLOTS];
+static uint8_t soc_cc_writes;
+static bool soc_cc_full;
+
+uint32_t EEPROM_LoadCCPage_Num(uint8_t idx) {
+    return soc_cc_page[idx];
+}
+
+bool EEPROM_WriteCCPage_Num(uint8_t idx, uint32_t val) {
+    if (soc_cc_full) {
+        return false;
+    }
+    soc_cc_page[idx] = val;
+    soc_cc_writes++;
+    return true;
+}
+
+static uint32_t soc_cell_voltages[MAX_NUM_MODULES*MAX_CELLS_PER_MODULE];
+static uint8_t soc_module_cell_count[MAX_NUM_MODULES];
+static PACK_CONFIG_T soc_pack_config;
+static BMS_PACK_STATUS_T soc_pack_status;
+
+// a step with a current measured just now
+static void step(BMS_SSM_MODE_T mode, uint32_t msTicks) {
+    soc_pack_status.pack_current_ms = msTicks;
+    SOC_Step(&soc_pack_status, mode, msTicks);
+}
+
+TEST_GROUP(SOC_Test);
+
+TEST_SETUP(SOC_Test) {
+    printf("\r(SOC_Test)Setup");
+    uint8_t i;
+    for (i = 0; i < SOC_CHECKPOINT_SLOTS; i++) {
+        soc_cc_page[i] = 0xFFFFFFFF;
+    }
+    soc_cc_writes = 0;
+    soc_cc_full = false;
+
+    soc_pack_config.cell_capacity_cAh = 100; // 1 Ah
+    soc_pack_config.pack_cells_p = 1;
+    soc_pack_config.module_cell_count = soc_module_cell_count;
+    soc_pack_status.cell_voltages_mV = soc_cell_voltages;
+    soc_pack_status.pack_current_mA = 0;
+    soc_pack_status.avg_cell_voltage_mV = 3740; // 50%
+
+    SOC_Init();
+    printf("...");
+}
+
+TEST_TEAR_DOWN(SOC_Test) {
+    printf("...");
+    printf("Teardown\r\n");
+}
+
+TEST(SOC_Test, ocv) {
+    printf("ocv");
+    TEST_ASSERT_EQUAL(0, SOC_FromOcv_cpct(2500));
+    TEST_ASSERT_EQUAL(0, SOC_FromOcv_cpct(3000));
+    TEST_ASSERT_EQUAL(500, SOC_FromOcv_cpct(3225));
+    TEST_ASSERT_EQUAL(1000, SOC_FromOcv_cpct(3450));
+    TEST_ASSERT_EQUAL(5000, SOC_FromOcv_cpct(3740));
+    TEST_ASSERT_EQUAL(9500, SOC_FromOcv_cpct(4145));
+    TEST_ASSERT_EQUAL(SOC_FULL_cpct, SOC_FromOcv_cpct(4300));
+}
+
+TEST(SOC_Test, integrate) {
+    printf("integrate");
+    SOC_Config(&soc_pack_config, 0);
+    TEST_ASSERT_FALSE(SOC_Valid());
+
+    step(BMS_SSM_MODE_STANDBY, 0);
+    TEST_ASSERT_TRUE(SOC_Valid());
+    TEST_ASSERT_EQUAL(5000, SOC_Estimate_cpct());
+
+    // 1 A for 36 s out of 1 Ah is 1%, in 1 ms ticks
+    soc_pack_status.pack_current_mA = 1000;
+    uint32_t t;
+    for (t = 1; t <= 36000; t++) {
+        step(BMS_SSM_MODE_DISCHARGE, t);
+    }
+    TEST_ASSERT_EQUAL(4900, SOC_Estimate_cpct());
+    TEST_ASSERT_EQUAL(49, SOC_Estimate());
+
+    for (t = 36100; t <= 108000; t += 100) {
+        step(BMS_SSM_MODE_CHARGE, t);
+    }
+    TEST_ASSERT_EQUAL(5100, SOC_Estimate_cpct());
+
+    // standby current is not counted
+    step(BMS_SSM_MODE_STANDBY, 109000);
+    TEST_ASSERT_EQUAL(5100, SOC_Estimate_cpct());
+}
+
+TEST(SOC_Test, clamp) {
+    printf("clamp");
+    soc_pack_status.avg_cell_voltage_mV = 4190;
+    SOC_Config(&soc_pack_config, 0);
+    step(BMS_SSM_MODE_CHARGE, 0);
+
+    // a long gap is integrated as SOC_MAX_STEP_ms
+    soc_pack_status.pack_current_mA = 100000;
+    step(BMS_SSM_MODE_CHARGE, 100000);
+    TEST_ASSERT_EQUAL(SOC_FULL_cpct, SOC_Estimate_cpct());
+
+    uint32_t t;
+    for (t = 1; t <= 60; t++) {
+        step(BMS_SSM_MODE_DISCHARGE, 100000 + t*SOC_MAX_STEP_ms);
+    }
+    TEST_ASSERT_EQUAL(0, SOC_Estimate_cpct());
+}
+
+TEST(SOC_Test, rest) {
+    printf("rest");
+    SOC_Config(&soc_pack_config, 0);
+    step(BMS_SSM_MODE_STANDBY, 0);
+
+    soc_pack_status.avg_cell_voltage_mV = 3450; // 10%
+    step(BMS_SSM_MODE_STANDBY, SOC_REST_TIME_ms - 1);
+    TEST_ASSERT_EQUAL(5000, SOC_Estimate_cpct());
+    step(BMS_SSM_MODE_STANDBY, SOC_REST_TIME_ms);
+    TEST_ASSERT_EQUAL(1000, SOC_Estimate_cpct());
+
+    // current restarts the rest timer
+    soc_pack_status.avg_cell_voltage_mV = 3740;
+    soc_pack_status.pack_current_mA = SOC_REST_CURRENT_mA;
+    step(BMS_SSM_MODE_STANDBY, SOC_REST_TIME_ms + 1);
+    soc_pack_status.pack_current_mA = 0;
+    step(BMS_SSM_MODE_STANDBY, 2*SOC_REST_TIME_ms);
+    TEST_ASSERT_EQUAL(1000, SOC_Estimate_cpct());
+    step(BMS_SSM_MODE_STANDBY, 2*SOC_REST_TIME_ms + 1);
+    TEST_ASSERT_EQUAL(5000, SOC_Estimate_cpct());
+}
+
+TEST(SOC_Test, stale_current) {
+    printf("stale_current");
+    SOC_Config(&soc_pack_config, 0);
+    step(BMS_SSM_MODE_STANDBY, 0);
+
+    // the current stops updating 10 s into a 1 A discharge
+    soc_pack_status.pack_current_mA = 1000;
+    uint32_t t;
+    for (t = 100; t <= 10000; t += 100) {
+        step(BMS_SSM_MODE_DISCHARGE, t);
+    }
+    TEST_ASSERT_EQUAL(4972, SOC_Estimate_cpct());
+    // the last reading still counts for SOC_CURRENT_MAX_AGE_ms, then nothing
+    for (t = 10100; t <= 10000 + SOC_CURRENT_MAX_AGE_ms; t += 100) {
+        SOC_Step(&soc_pack_status, BMS_SSM_MODE_DISCHARGE, t);
+    }
+    TEST_ASSERT_EQUAL(4970, SOC_Estimate_cpct());
+    for (; t <= 60000; t += 100) {
+        SOC_Step(&soc_pack_status, BMS_SSM_MODE_DISCHARGE, t);
+    }
+    TEST_ASSERT_EQUAL(4970, SOC_Estimate_cpct());
+
+    // an old zero reading is not rest either
+    soc_pack_status.pack_current_mA = 0;
+    soc_pack_status.avg_cell_voltage_mV = 3450;
+    SOC_Step(&soc_pack_status, BMS_SSM_MODE_STANDBY, 60000 + SOC_REST_TIME_ms);
+    TEST_ASSERT_EQUAL(4970, SOC_Estimate_cpct());
+}
+
+TEST(SOC_Test, checkpoint) {
+    printf("checkpoint");
+    SOC_Config(&soc_pack_config, 0);
+    step(BMS_SSM_MODE_STANDBY, 0);
+
+    // first checkpoint goes to slot 0
+    step(BMS_SSM_MODE_STANDBY, SOC_CHECKPOINT_PERIOD_ms);
+    TEST_ASSERT_EQUAL(1, soc_cc_writes);
+    TEST_ASSERT_EQUAL((1UL << 16) | 5000, soc_cc_page[0]);
+
+    // unchanged estimate is not written again
+    step(BMS_SSM_MODE_STANDBY, 2*SOC_CHECKPOINT_PERIOD_ms);
+    TEST_ASSERT_EQUAL(1, soc_cc_writes);
+
+    // 1 A for 1 minute is 1.67%
+    soc_pack_status.pack_current_mA = 1000;
+    uint32_t t;
+    for (t = 2*SOC_CHECKPOINT_PERIOD_ms + 10; t <= 3*SOC_CHECKPOINT_PERIOD_ms; t += 10) {
+        step(BMS_SSM_MODE_DISCHARGE, t);
+    }
+    TEST_ASSERT_EQUAL(2, soc_cc_writes);
+    TEST_ASSERT_EQUAL((2UL << 16) | 4833, soc_cc_page[1]);
+
+    // a restart picks the newest slot
+    SOC_Init();
+    SOC_Config(&soc_pack_config, 0);
+    TEST_ASSERT_TRUE(SOC_Valid());
+    TEST_ASSERT_EQUAL(4833, SOC_Estimate_cpct());
+}
+
+TEST(SOC_Test, checkpoint_busy) {
+    printf("checkpoint_busy");
+    SOC_Config(&soc_pack_config, 0);
+    step(BMS_SSM_MODE_STANDBY, 0);
+
+    soc_cc_full = true;
+    step(BMS_SSM_MODE_STANDBY, SOC_CHECKPOINT_PERIOD_ms);
+    TEST_ASSERT_EQUAL(0, soc_cc_writes);
+    TEST_ASSERT_EQUAL_HEX32(0xFFFFFFFF, soc_cc_page[0]);
+
+    // the same checkpoint, slot and sequence number go out once there is room
+    soc_cc_full = false;
+    step(BMS_SSM_MODE_STANDBY, 2*SOC_CHECKPOINT_PERIOD_ms);
+    TEST_ASSERT_EQUAL(1, soc_cc_writes);
+    TEST_ASSERT_EQUAL((1UL << 16) | 5000, soc_cc_page[0]);
+}
+
+TEST(SOC_Test, checkpoint_wrap) {
+    printf("checkpoint_wrap");
+    uint8_t i;
+    // slots 0-2 hold the newest records after the sequence number wrapped
+    for (i = 0; i < SOC_CHECKPOINT_SLOTS; i++) {
+        uint16_t seq = (i < 3) ? (uint16_t)(i - 2) : (uint16_t)(i - 2 - SOC_CHECKPOINT_SLOTS);
+        soc_cc_page[i] = ((uint32_t)seq << 16) | (1000 + i);
+    }
+    soc_cc_page[2] = 7777; // sequence number 0
+
+    SOC_Config(&soc_pack_config, 0);
+    TEST_ASSERT_EQUAL(7777, SOC_Estimate_cpct());
+
+    // next checkpoint goes to slot 3
+    soc_pack_status.avg_cell_voltage_mV = 3450;
+    step(BMS_SSM_MODE_STANDBY, SOC_REST_TIME_ms);
+    TEST_ASSERT_EQUAL(1000, SOC_Estimate_cpct());
+    TEST_ASSERT_EQUAL((1UL << 16) | 1000, soc_cc_page[3]);
+}
+
+TEST_GROUP_RUNNER(SOC_Test) {
+    RUN_TEST_CASE(SOC_Test, ocv);
+    RUN_TEST_CASE(SOC_Test, integrate);
+    RUN_TEST_CASE(SOC_Test, clamp);
+    RUN_TEST_CASE(SOC_Test, rest);
+    RUN_TEST_CASE(SOC_Test, stale_current);
+    RUN_TEST_CASE(SOC_Test, checkpoint);
+    RUN_TEST_CASE(SOC_Test, checkpoint_busy);
+    RUN_TEST_CASE(SOC_Test, checkpoint_wrap);
+}
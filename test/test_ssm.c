@@ -7,7 +7,7 @@
 #define MAX_CELLS_PER_MODULE 12
 
 // memory allocation for BMS_OUTPUT_T
-bool balance_reqs[MAX_NUM_MODULES*MAX_CELLS_PER_MODULE];
+uint16_t balance_reqs[MAX_NUM_MODULES];
 BMS_CHARGE_REQ_T charge_req;
 BMS_OUTPUT_T bms_output;
 
@@ -0,0 +1,217 @@
+#include "unity.h"
+#include "unity_fixture.h"
+#include <stdio.h>
+#include "telemetry.h"
+
+/**
+ * Testing Strategy
+ *
+ * Telemetry_Crc16()
+ * - standard check value
+ * Telemetry_CobsEncode()
+ * - no zeros, zeros inside and at the ends
+ * Telemetry_QueueVoltages() / Telemetry_QueueTemperatures()
+ * - frame decodes back to the values, negative deltas and temperatures
+ * - buffer full: nothing queued
+ * Telemetry_Drain()
+ * - writer taking part of the data, ring wrapping
+ */
+
+static uint8_t written[2*TELEMETRY_BUFFER_SIZE];
+static uint16_t written_len;
+static uint16_t write_limit;
+
+static uint32_t fake_write(const char *data, uint32_t count) {
+    if (count > write_limit) count = write_limit;
+    memcpy(&written[written_len], data, count);
+    written_len += count;
+    write_limit -= count;
+    return count;
+}
+
+static uint16_t cobs_decode(const uint8_t *src, uint16_t len, uint8_t *dst) {
+    uint16_t in = 0;
+    uint16_t out = 0;
+    while (in < len) {
+        uint8_t code = src[in++];
+        uint8_t i;
+        for (i = 1; i < code; i++) {
+            dst[out++] = src[in++];
+        }
+        if (code < 0xFF && in < len) {
+            dst[out++] = 0;
+        }
+    }
+    return out;
+}
+
+static int32_t read_delta(const uint8_t *src, uint16_t *pos) {
+    uint32_t zz = 0;
+    uint8_t shift = 0;
+    uint8_t byte;
+    do {
+        byte = src[(*pos)++];
+        zz |= (uint32_t)(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    return (int32_t)(zz >> 1) ^ -(int32_t)(zz & 1);
+}
+
+// decode the first frame in written
+static void decode(uint8_t *count, uint8_t *type, uint32_t *ms, uint8_t *module, int32_t *values) {
+    uint8_t payload[TELEMETRY_MAX_PAYLOAD];
+    uint16_t end = 0;
+    while (written[end] != 0) end++;
+    uint16_t len = cobs_decode(written, end, payload);
+
+    uint16_t crc = payload[len-2] | (payload[len-1] << 8);
+    TEST_ASSERT_EQUAL_HEX16(Telemetry_Crc16(payload, len - 2), crc);
+
+    *type = payload[0];
+    *ms = payload[1] | (payload[2] << 8) | ((uint32_t)payload[3] << 16) | ((uint32_t)payload[4] << 24);
+    *module = payload[5];
+    *count = payload[6];
+    values[0] = payload[7] | (payload[8] << 8);
+    uint16_t pos = 9;
+    uint8_t i;
+    for (i = 1; i < *count; i++) {
+        values[i] = values[i-1] + read_delta(payload, &pos);
+    }
+    TEST_ASSERT_EQUAL(len - 2, pos);
+}
+
+TEST_GROUP(Telemetry_Test);
+
+TEST_SETUP(Telemetry_Test) {
+    printf("\r(Telemetry_Test)Setup");
+    Telemetry_Init();
+    memset(written, 0xAA, sizeof(written));
+    written_len = 0;
+    write_limit = 0xFFFF;
+    printf("...");
+}
+
+TEST_TEAR_DOWN(Telemetry_Test) {
+    printf("...");
+    printf("Teardown\r\n");
+}
+
+TEST(Telemetry_Test, crc) {
+    printf("crc");
+    const uint8_t check[] = "123456789";
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, Telemetry_Crc16(check, 9));
+}
+
+TEST(Telemetry_Test, cobs) {
+    printf("cobs");
+    uint8_t dst[8];
+    const uint8_t plain[] = {0x11, 0x22, 0x33};
+    TEST_ASSERT_EQUAL(4, Telemetry_CobsEncode(plain, 3, dst));
+    TEST_ASSERT_EQUAL(4, dst[0]);
+    TEST_ASSERT_EQUAL(0x33, dst[3]);
+
+    const uint8_t zeros[] = {0x00, 0x11, 0x00, 0x00};
+    TEST_ASSERT_EQUAL(5, Telemetry_CobsEncode(zeros, 4, dst));
+    const uint8_t expected[] = {0x01, 0x02, 0x11, 0x01, 0x01};
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, dst, 5);
+}
+
+TEST(Telemetry_Test, voltages) {
+    printf("voltages");
+    const uint32_t mV[] = {3700, 3710, 3650, 3650, 4200, 70000};
+    uint8_t count, type, module;
+    uint32_t ms;
+    int32_t values[TELEMETRY_MAX_VALUES];
+
+    TEST_ASSERT_TRUE(Telemetry_QueueVoltages(0x12345678, 3, mV, 6));
+    TEST_ASSERT_EQUAL(Telemetry_Pending(), Telemetry_Drain(fake_write));
+    TEST_ASSERT_EQUAL(0, Telemetry_Pending());
+    TEST_ASSERT_EQUAL(0, written[written_len - 1]);
+
+    decode(&count, &type, &ms, &module, values);
+    TEST_ASSERT_EQUAL(6, count);
+    TEST_ASSERT_EQUAL(TELEMETRY_TYPE_VOLTAGES, type);
+    TEST_ASSERT_EQUAL_HEX32(0x12345678, ms);
+    TEST_ASSERT_EQUAL(3, module);
+    TEST_ASSERT_EQUAL(3700, values[0]);
+    TEST_ASSERT_EQUAL(3650, values[3]);
+    TEST_ASSERT_EQUAL(4200, values[4]);
+    TEST_ASSERT_EQUAL(UINT16_MAX, values[5]);
+}
+
+TEST(Telemetry_Test, temperatures) {
+    printf("temperatures");
+    const int16_t dC[] = {-105, 250, 251, -300};
+    uint8_t count, type, module;
+    uint32_t ms;
+    int32_t values[TELEMETRY_MAX_VALUES];
+
+    TEST_ASSERT_TRUE(Telemetry_QueueTemperatures(5, 0, dC, 4));
+    Telemetry_Drain(fake_write);
+
+    decode(&count, &type, &ms, &module, values);
+    TEST_ASSERT_EQUAL(4, count);
+    TEST_ASSERT_EQUAL(TELEMETRY_TYPE_TEMPERATURES, type);
+    TEST_ASSERT_EQUAL(-105, (int16_t)values[0]);
+    TEST_ASSERT_EQUAL(251, (int16_t)values[2]);
+    TEST_ASSERT_EQUAL(-300, (int16_t)values[3]);
+}
+
+TEST(Telemetry_Test, full) {
+    printf("full");
+    uint32_t mV[TELEMETRY_MAX_VALUES];
+    uint8_t i;
+    for (i = 0; i < TELEMETRY_MAX_VALUES; i++) {
+        mV[i] = 3000 + 1000*(i & 1);
+    }
+
+    uint8_t frames = 0;
+    while (Telemetry_QueueVoltages(0, frames, mV, TELEMETRY_MAX_VALUES)) {
+        frames++;
+    }
+    // the frame that did not fit left no partial bytes behind
+    uint16_t pending = Telemetry_Pending();
+    uint16_t frame_len = pending / frames;
+    TEST_ASSERT_TRUE(frames > 0);
+    TEST_ASSERT_EQUAL(frames * frame_len, pending);
+    TEST_ASSERT_TRUE(pending + frame_len > TELEMETRY_BUFFER_SIZE);
+}
+
+TEST(Telemetry_Test, partial_drain) {
+    printf("partial_drain");
+    const uint32_t mV[] = {3700, 3701, 3702};
+    uint8_t count, type, module;
+    uint32_t ms;
+    int32_t values[TELEMETRY_MAX_VALUES];
+
+    // wrap the ring by pushing frames through it
+    uint16_t i;
+    for (i = 0; i < 20; i++) {
+        TEST_ASSERT_TRUE(Telemetry_QueueVoltages(i, 1, mV, 3));
+        write_limit = 0xFFFF;
+        Telemetry_Drain(fake_write);
+        written_len = 0;
+    }
+
+    TEST_ASSERT_TRUE(Telemetry_QueueVoltages(99, 2, mV, 3));
+    uint16_t pending = Telemetry_Pending();
+    write_limit = 3;
+    TEST_ASSERT_EQUAL(3, Telemetry_Drain(fake_write));
+    TEST_ASSERT_EQUAL(pending - 3, Telemetry_Pending());
+    write_limit = 0xFFFF;
+    TEST_ASSERT_EQUAL(pending - 3, Telemetry_Drain(fake_write));
+
+    decode(&count, &type, &ms, &module, values);
+    TEST_ASSERT_EQUAL(3, count);
+    TEST_ASSERT_EQUAL(99, ms);
+    TEST_ASSERT_EQUAL(3702, values[2]);
+}
+
+TEST_GROUP_RUNNER(Telemetry_Test) {
+    RUN_TEST_CASE(Telemetry_Test, crc);
+    RUN_TEST_CASE(Telemetry_Test, cobs);
+    RUN_TEST_CASE(Telemetry_Test, voltages);
+    RUN_TEST_CASE(Telemetry_Test, temperatures);
+    RUN_TEST_CASE(Telemetry_Test, full);
+    RUN_TEST_CASE(Telemetry_Test, partial_drain);
+}
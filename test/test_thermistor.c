@@ -0,0 +1,90 @@
+#include "unity.h"
+#include "unity_fixture.h"
+#include <stdio.h>
+#include "thermistor.h"
+#include "thermistor_table.h"
+
+/**
+ * Testing Strategy
+ *
+ * Thermistor_Temperature_dC()
+ * - on a breakpoint: the table entry
+ * - between breakpoints: within a rounding of the linear fit mV/4 - 39
+ *   the table defaults to
+ * - every voltage from 0 to past the last breakpoint: never decreases
+ * - 0 mV and past the last breakpoint: the end entries
+ */
+
+// the old fit truncated the quarter mV, the table rounds it
+#define THERMISTOR_TOLERANCE_dC 1
+
+// temp_dC = mV/4 - 39
+static const struct {
+    uint32_t voltage_mV;
+    int16_t temperature_dC;
+} reference[] = {
+    { 100, -14},
+    { 156, 0},
+    { 399, 60},
+    {1000, 211},
+    {1723, 391},
+    {2556, 600},
+    {2999, 710},
+};
+
+TEST_GROUP(Thermistor_Test);
+
+TEST_SETUP(Thermistor_Test) {
+    printf("\r(Thermistor_Test)Setup");
+    printf("...");
+}
+
+TEST_TEAR_DOWN(Thermistor_Test) {
+    printf("...");
+    printf("Teardown\r\n");
+}
+
+TEST(Thermistor_Test, breakpoints) {
+    printf("breakpoints");
+    uint32_t i;
+    for (i = 0; i < THERMISTOR_TABLE_LEN; i++) {
+        TEST_ASSERT_EQUAL_INT(thermistor_table_dC[i],
+                Thermistor_Temperature_dC(i << THERMISTOR_TABLE_SHIFT));
+    }
+}
+
+TEST(Thermistor_Test, accuracy) {
+    printf("accuracy");
+    uint8_t i;
+    for (i = 0; i < sizeof(reference)/sizeof(reference[0]); i++) {
+        TEST_ASSERT_INT_WITHIN(THERMISTOR_TOLERANCE_dC, reference[i].temperature_dC,
+                Thermistor_Temperature_dC(reference[i].voltage_mV));
+    }
+}
+
+TEST(Thermistor_Test, monotonic) {
+    printf("monotonic");
+    int16_t last = Thermistor_Temperature_dC(0);
+    uint32_t mV;
+    for (mV = 1; mV <= (THERMISTOR_TABLE_LEN + 1) << THERMISTOR_TABLE_SHIFT; mV++) {
+        int16_t t = Thermistor_Temperature_dC(mV);
+        TEST_ASSERT_TRUE(t >= last);
+        last = t;
+    }
+}
+
+TEST(Thermistor_Test, clamp) {
+    printf("clamp");
+    TEST_ASSERT_EQUAL_INT(thermistor_table_dC[0], Thermistor_Temperature_dC(0));
+    TEST_ASSERT_EQUAL_INT(thermistor_table_dC[THERMISTOR_TABLE_LEN - 1],
+            Thermistor_Temperature_dC(THERMISTOR_TABLE_LEN << THERMISTOR_TABLE_SHIFT));
+    TEST_ASSERT_EQUAL_INT(thermistor_table_dC[THERMISTOR_TABLE_LEN - 1],
+            Thermistor_Temperature_dC(UINT32_MAX));
+}
+
+TEST_GROUP_RUNNER(Thermistor_Test) {
+    RUN_TEST_CASE(Thermistor_Test, breakpoints);
+    RUN_TEST_CASE(Thermistor_Test, accuracy);
+    RUN_TEST_CASE(Thermistor_Test, monotonic);
+    RUN_TEST_CASE(Thermistor_Test, clamp);
+}
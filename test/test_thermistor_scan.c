@@ -0,0 +1,146 @@
+#include "unity.h"
+#include "unity_fixture.h"
+#include <stdio.h>
+#include <string.h>
+#include "thermistor_scan.h"
+#include "config.h"
+
+/**
+ * Testing Strategy
+ *
+ * ThermistorScan_Next()
+ * - first sweep in order
+ * - cool pack: plain round robin
+ * - hot thermistor read more often than the rest
+ * - rising thermistor read more often than the rest
+ * - no thermistor waits more than THERMISTOR_SCAN_MAX_AGE reads
+ * ThermistorScan_Record()
+ * - weight from the hottest module, capped
+ */
+
+#define NUM_MODULES 3
+
+static int16_t temps_dC[NUM_MODULES*MAX_THERMISTORS_PER_MODULE];
+static uint32_t now_ms;
+static uint16_t reads[MAX_THERMISTORS_PER_MODULE];
+static uint16_t max_wait;
+
+static void set_temp(uint8_t thermistor, int16_t temp_dC) {
+    uint8_t module;
+    for (module = 0; module < NUM_MODULES; module++) {
+        temps_dC[module*MAX_THERMISTORS_PER_MODULE + thermistor] = temp_dC;
+    }
+}
+
+// read n thermistors, 10 ms apart, counting reads and the longest wait
+static void scan(uint16_t n) {
+    static uint16_t last_read[MAX_THERMISTORS_PER_MODULE];
+    static uint16_t read_num;
+    if (now_ms == 0) {
+        read_num = 0;
+        memset(last_read, 0, sizeof(last_read));
+    }
+    while (n-- > 0) {
+        uint8_t t = ThermistorScan_Next();
+        now_ms += 10;
+        read_num++;
+        if (read_num - last_read[t] > max_wait && last_read[t] != 0) {
+            max_wait = read_num - last_read[t];
+        }
+        last_read[t] = read_num;
+        reads[t]++;
+        ThermistorScan_Record(t, temps_dC, NUM_MODULES, now_ms);
+    }
+}
+
+TEST_GROUP(Thermistor_Scan_Test);
+
+TEST_SETUP(Thermistor_Scan_Test) {
+    printf("\r(Thermistor_Scan_Test)Setup");
+    ThermistorScan_Init(MAX_THERMISTORS_PER_MODULE);
+    memset(temps_dC, 0, sizeof(temps_dC));
+    uint8_t i;
+    for (i = 0; i < MAX_THERMISTORS_PER_MODULE; i++) {
+        set_temp(i, 250);
+    }
+    memset(reads, 0, sizeof(reads));
+    now_ms = 0;
+    max_wait = 0;
+    printf("...");
+}
+
+TEST_TEAR_DOWN(Thermistor_Scan_Test) {
+    printf("...");
+    printf("Teardown\r\n");
+}
+
+TEST(Thermistor_Scan_Test, first_sweep) {
+    printf("first_sweep");
+    uint8_t i;
+    for (i = 0; i < MAX_THERMISTORS_PER_MODULE; i++) {
+        TEST_ASSERT_EQUAL(i, ThermistorScan_Next());
+        ThermistorScan_Record(i, temps_dC, NUM_MODULES, i*10);
+    }
+}
+
+TEST(Thermistor_Scan_Test, round_robin) {
+    printf("round_robin");
+    scan(10*MAX_THERMISTORS_PER_MODULE);
+    uint8_t i;
+    for (i = 0; i < MAX_THERMISTORS_PER_MODULE; i++) {
+        TEST_ASSERT_EQUAL(10, reads[i]);
+    }
+    TEST_ASSERT_EQUAL(MAX_THERMISTORS_PER_MODULE, max_wait);
+}
+
+TEST(Thermistor_Scan_Test, hot) {
+    printf("hot");
+    // only module 2 is hot
+    temps_dC[2*MAX_THERMISTORS_PER_MODULE + 3] = THERMISTOR_SCAN_HOT_dC + 4*THERMISTOR_SCAN_HOT_STEP_dC;
+    scan(MAX_THERMISTORS_PER_MODULE);
+    TEST_ASSERT_EQUAL(5, ThermistorScan_GetWeight(3));
+
+    memset(reads, 0, sizeof(reads));
+    scan(1000);
+    TEST_ASSERT_TRUE(reads[3] > 2*reads[4]);
+    TEST_ASSERT_TRUE(max_wait <= THERMISTOR_SCAN_MAX_AGE);
+}
+
+TEST(Thermistor_Scan_Test, rising) {
+    printf("rising");
+    scan(MAX_THERMISTORS_PER_MODULE);
+    memset(reads, 0, sizeof(reads));
+    uint16_t n;
+    for (n = 0; n < 100; n++) {
+        // 3 dC/s on thermistor 7
+        set_temp(7, 250 + now_ms*3/1000);
+        scan(10);
+    }
+    // about 3 dC/s, give or take the whole dC steps
+    TEST_ASSERT_TRUE(ThermistorScan_GetWeight(7) >= 3);
+    TEST_ASSERT_EQUAL(1, ThermistorScan_GetWeight(8));
+    TEST_ASSERT_TRUE(reads[7] > 2*reads[8]);
+}
+
+TEST(Thermistor_Scan_Test, bounded) {
+    printf("bounded");
+    // half the pack at full weight
+    uint8_t i;
+    for (i = 0; i < MAX_THERMISTORS_PER_MODULE; i += 2) {
+        set_temp(i, 1000);
+    }
+    scan(2000);
+    TEST_ASSERT_EQUAL(THERMISTOR_SCAN_MAX_WEIGHT, ThermistorScan_GetWeight(0));
+    TEST_ASSERT_EQUAL(1, ThermistorScan_GetWeight(1));
+    TEST_ASSERT_TRUE(max_wait <= THERMISTOR_SCAN_MAX_AGE);
+    TEST_ASSERT_TRUE(reads[0] > reads[1]);
+    TEST_ASSERT_TRUE(reads[1] > 0);
+}
+
+TEST_GROUP_RUNNER(Thermistor_Scan_Test) {
+    RUN_TEST_CASE(Thermistor_Scan_Test, first_sweep);
+    RUN_TEST_CASE(Thermistor_Scan_Test, round_robin);
+    RUN_TEST_CASE(Thermistor_Scan_Test, hot);
+    RUN_TEST_CASE(Thermistor_Scan_Test, rising);
+    RUN_TEST_CASE(Thermistor_Scan_Test, bounded);
+}
@@ -0,0 +1,130 @@
+#include "unity.h"
+#include "unity_fixture.h"
+#include <stdio.h>
+#include "timing.h"
+#include "config.h"
+
+extern volatile uint32_t msTicks;
+
+TEST_GROUP(Timing_Test);
+
+TEST_SETUP(Timing_Test) {
+    Timing_Init();
+    msTicks = 0;
+
+    printf("\r(Timing_Test)Setup...");
+}
+
+TEST_TEAR_DOWN(Timing_Test) {
+    printf("Teardown\r\n");
+}
+
+TEST(Timing_Test, empty) {
+    printf("empty...");
+    const TIMING_STATS_T *stats = Timing_GetStats(TIMING_STAGE_SSM);
+    TEST_ASSERT_EQUAL(0, stats->count);
+    TEST_ASSERT_EQUAL(0, stats->max_us);
+    TEST_ASSERT_EQUAL(0, Timing_Percentile_us(TIMING_STAGE_SSM, 99));
+    TEST_ASSERT_EQUAL(0, Timing_GetLoopOverruns());
+}
+
+TEST(Timing_Test, log2_buckets) {
+    printf("log2_buckets...");
+    Timing_Record(TIMING_STAGE_INPUT, 0);
+    Timing_Record(TIMING_STAGE_INPUT, 1);
+    Timing_Record(TIMING_STAGE_INPUT, 2);
+    Timing_Record(TIMING_STAGE_INPUT, 3);
+    Timing_Record(TIMING_STAGE_INPUT, 1000);
+    Timing_Record(TIMING_STAGE_INPUT, UINT32_MAX);
+
+    const TIMING_STATS_T *stats = Timing_GetStats(TIMING_STAGE_INPUT);
+    TEST_ASSERT_EQUAL(1, stats->buckets[0]);
+    TEST_ASSERT_EQUAL(1, stats->buckets[1]);
+    TEST_ASSERT_EQUAL(2, stats->buckets[2]);
+    TEST_ASSERT_EQUAL(1, stats->buckets[10]);
+    TEST_ASSERT_EQUAL(1, stats->buckets[TIMING_NUM_BUCKETS - 1]);
+    TEST_ASSERT_EQUAL(6, stats->count);
+    TEST_ASSERT_EQUAL(0, stats->min_us);
+    TEST_ASSERT_EQUAL(UINT32_MAX, stats->max_us);
+}
+
+TEST(Timing_Test, percentile) {
+    printf("percentile...");
+    uint32_t i;
+    for (i = 0; i < 99; i++) {
+        Timing_Record(TIMING_STAGE_OUTPUT, 100); // bucket 7, 64-127us
+    }
+    Timing_Record(TIMING_STAGE_OUTPUT, 3000);
+
+    TEST_ASSERT_EQUAL(127, Timing_Percentile_us(TIMING_STAGE_OUTPUT, 50));
+    TEST_ASSERT_EQUAL(127, Timing_Percentile_us(TIMING_STAGE_OUTPUT, 99));
+    TEST_ASSERT_EQUAL(3000, Timing_Percentile_us(TIMING_STAGE_OUTPUT, 100));
+
+    Timing_Record(TIMING_STAGE_OUTPUT, 5000);
+    TEST_ASSERT_EQUAL(4095, Timing_Percentile_us(TIMING_STAGE_OUTPUT, 99));
+}
+
+TEST(Timing_Test, saturation_keeps_shape) {
+    printf("saturation_keeps_shape...");
+    uint32_t i;
+    for (i = 0; i < UINT16_MAX; i++) {
+        Timing_Record(TIMING_STAGE_KEYBOARD, 10);
+    }
+    Timing_Record(TIMING_STAGE_KEYBOARD, 100);
+    Timing_Record(TIMING_STAGE_KEYBOARD, 100);
+    Timing_Record(TIMING_STAGE_KEYBOARD, 10);
+
+    const TIMING_STATS_T *stats = Timing_GetStats(TIMING_STAGE_KEYBOARD);
+    TEST_ASSERT_EQUAL(UINT16_MAX / 2 + 1, stats->buckets[4]);
+    TEST_ASSERT_EQUAL(1, stats->buckets[7]);
+    TEST_ASSERT_EQUAL(UINT16_MAX + 3, stats->count);
+}
+
+TEST(Timing_Test, loop_marks) {
+    printf("loop_marks...");
+    Timing_LoopStart();
+    msTicks += 2;
+    Timing_Mark(TIMING_STAGE_INPUT);
+    msTicks += 3;
+    Timing_Mark(TIMING_STAGE_SSM);
+    Timing_LoopStart();
+
+    TEST_ASSERT_EQUAL(2000, Timing_GetStats(TIMING_STAGE_INPUT)->max_us);
+    TEST_ASSERT_EQUAL(3000, Timing_GetStats(TIMING_STAGE_SSM)->max_us);
+    TEST_ASSERT_EQUAL(5000, Timing_GetStats(TIMING_STAGE_LOOP)->max_us);
+    TEST_ASSERT_EQUAL(1, Timing_GetStats(TIMING_STAGE_LOOP)->count);
+    TEST_ASSERT_EQUAL(5000 > TIMING_LOOP_BUDGET_us, Timing_GetLoopOverruns());
+}
+
+TEST(Timing_Test, can_frame) {
+    printf("can_frame...");
+    uint8_t data[8];
+    Timing_Record(TIMING_STAGE_KEYBOARD, 5);
+    Timing_Record(TIMING_STAGE_KEYBOARD, 70000);
+
+    TEST_ASSERT_EQUAL(8, Timing_PackCanFrame(data));
+    TEST_ASSERT_EQUAL(TIMING_STAGE_KEYBOARD, data[0]);
+    TEST_ASSERT_EQUAL(5, data[1] | (data[2] << 8));
+    TEST_ASSERT_EQUAL(UINT16_MAX, data[3] | (data[4] << 8));
+    TEST_ASSERT_EQUAL(UINT16_MAX, data[5] | (data[6] << 8));
+
+    // round robin, empty stages report zeros
+    Timing_PackCanFrame(data);
+    TEST_ASSERT_EQUAL(TIMING_STAGE_INPUT, data[0]);
+    TEST_ASSERT_EQUAL(0, data[1] | (data[2] << 8));
+    uint8_t i;
+    for (i = 2; i < TIMING_NUM_STAGES; i++) {
+        Timing_PackCanFrame(data);
+    }
+    Timing_PackCanFrame(data);
+    TEST_ASSERT_EQUAL(TIMING_STAGE_KEYBOARD, data[0]);
+}
+
+TEST_GROUP_RUNNER(Timing_Test) {
+    RUN_TEST_CASE(Timing_Test, empty);
+    RUN_TEST_CASE(Timing_Test, log2_buckets);
+    RUN_TEST_CASE(Timing_Test, percentile);
+    RUN_TEST_CASE(Timing_Test, saturation_keeps_shape);
+    RUN_TEST_CASE(Timing_Test, loop_marks);
+    RUN_TEST_CASE(Timing_Test, can_frame);
+}